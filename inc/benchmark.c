@@ -0,0 +1,385 @@
+#include <stdio.h>
+#include "benchmark.h"
+#include "font_table.h"
+#include "font_legacy.h"
+#include "bitmap.h"
+#include "ws2812.h"
+#include "ws2812_parallel.h"
+#include "led_framebuffer.h"
+#include "trace.h"
+
+// Primitivas medidas: cada uma recebe o índice da repetição para variar a posição do desenho
+static void bench_pixel(ssd1306_t *ssd, uint i)
+{
+    for (uint8_t x = 0; x < 128; ++x)
+        ssd1306_pixel(ssd, x, i & 63, true); // Uma linha inteira de pixels isolados
+}
+
+// Busca de glifo anterior à tabela gerada: cadeia de comparações, apenas 0-9, A-Z e a-z
+static uint16_t legacy_glyph_index(char c)
+{
+    if (c >= 'A' && c <= 'Z')
+        return (c - 'A' + 11) * 8;
+    else if (c >= '0' && c <= '9')
+        return (c - '0' + 1) * 8;
+    else if (c >= 'a' && c <= 'z')
+        return (c - 'a' + 37) * 8;
+    return 0;
+}
+
+// Desenho de caractere anterior ao desenho por colunas: um ssd1306_pixel por pixel do glifo 8x8
+static void legacy_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+{
+    uint16_t index = legacy_glyph_index(c);
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        uint8_t line = legacy_font[index + i];
+        for (uint8_t j = 0; j < 8; ++j)
+            ssd1306_pixel(ssd, x + i, y + j, line & (1 << j));
+    }
+}
+
+// ssd1306_draw_string anterior, com legacy_draw_char
+static void legacy_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+{
+    while (*str)
+    {
+        legacy_draw_char(ssd, *str++, x, y);
+        x += 8;
+        if (x + 8 >= ssd->width)
+        {
+            x = 0;
+            y += 8;
+        }
+        if (y + 8 >= ssd->height)
+            break;
+    }
+}
+
+static void bench_char(ssd1306_t *ssd, uint i)
+{
+    ssd1306_draw_char(ssd, 'A' + (i % 26), (i * 8) % 120, (i * 3) % 56);
+}
+
+static void bench_string(ssd1306_t *ssd, uint i)
+{
+    ssd1306_draw_string(ssd, "Digite o que deseja", 0, (i * 8) % 56);
+}
+
+static void bench_char_pixels(ssd1306_t *ssd, uint i)
+{
+    legacy_draw_char(ssd, 'A' + (i % 26), (i * 8) % 120, (i * 3) % 56);
+}
+
+static void bench_string_pixels(ssd1306_t *ssd, uint i)
+{
+    legacy_draw_string(ssd, "Digite o que deseja", 0, (i * 8) % 56);
+}
+
+// Tela inteira de texto: 7 linhas de 15 caracteres (o limite de ssd1306_draw_string em 128x64)
+static const char screen_text[] = "Digite o que deseja ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz 0123456789 0123456789 ABCDEFGHIJ";
+
+static void bench_screen(ssd1306_t *ssd, uint i)
+{
+    ssd1306_draw_string(ssd, screen_text, 0, 0);
+}
+
+static void bench_screen_pixels(ssd1306_t *ssd, uint i)
+{
+    legacy_draw_string(ssd, screen_text, 0, 0);
+}
+
+static void bench_text(ssd1306_t *ssd, uint i)
+{
+    ssd1306_draw_text(ssd, "Digite o que deseja", 0, (i * 8) % 56);
+}
+
+static void bench_fill(ssd1306_t *ssd, uint i)
+{
+    ssd1306_fill(ssd, i & 1);
+}
+
+// ssd1306_fill anterior aos preenchimentos por trechos: um ssd1306_pixel por pixel do display
+static void bench_fill_pixels(ssd1306_t *ssd, uint i)
+{
+    for (uint8_t y = 0; y < ssd->height; ++y)
+        for (uint8_t x = 0; x < ssd->width; ++x)
+            ssd1306_pixel(ssd, x, y, i & 1);
+}
+
+// Retângulo cheio de 60x30 em uma posição desalinhada das páginas
+static void bench_rect(ssd1306_t *ssd, uint i)
+{
+    ssd1306_rect(ssd, 17, 10 + (i & 7), 60, 30, i & 1, true);
+}
+
+// O mesmo retângulo pixel a pixel, como em ssd1306_rect anterior
+static void bench_rect_pixels(ssd1306_t *ssd, uint i)
+{
+    for (uint8_t x = 10 + (i & 7); x < 10 + (i & 7) + 60; ++x)
+        for (uint8_t y = 17; y < 17 + 30; ++y)
+            ssd1306_pixel(ssd, x, y, i & 1);
+}
+
+static void bench_line(ssd1306_t *ssd, uint i)
+{
+    ssd1306_line(ssd, 0, i & 63, 127, 63 - (i & 63), true);
+}
+
+static const struct
+{
+    const char *name;
+    void (*run)(ssd1306_t *ssd, uint i);
+    uint ops; // Operações elementares por repetição (para o custo unitário)
+} primitives[] = {
+    {"pixel", bench_pixel, 128},
+    {"char", bench_char, 1},
+    {"char (por pixel)", bench_char_pixels, 1},
+    {"string (19 chars)", bench_string, 1},
+    {"string (por pixel)", bench_string_pixels, 1},
+    {"tela de texto", bench_screen, 1},
+    {"tela (por pixel)", bench_screen_pixels, 1},
+    {"text (19 chars)", bench_text, 1},
+    {"fill", bench_fill, 1},
+    {"fill (por pixel)", bench_fill_pixels, 1},
+    {"rect cheio 60x30", bench_rect, 1},
+    {"rect (por pixel)", bench_rect_pixels, 1},
+    {"line", bench_line, 1},
+};
+
+// Imprime bytes, transações e tempo de barramento (medido e modelado) de um envio
+static void report_flush(ssd1306_t *ssd, const char *name, uint64_t elapsed_us)
+{
+    printf("%-20s %6lu bytes %3lu transacoes %6lu us (modelo: %6lu us @400kHz, %6lu us @1MHz)\n",
+           name,
+           (unsigned long)ssd->tx_bytes,
+           (unsigned long)ssd->tx_transactions,
+           (unsigned long)elapsed_us,
+           (unsigned long)ssd1306_bus_time_us(ssd->tx_bytes, ssd->tx_transactions, 400 * 1000),
+           (unsigned long)ssd1306_bus_time_us(ssd->tx_bytes, ssd->tx_transactions, 1000 * 1000));
+}
+
+// Compara a busca de glifos pela tabela direta com a cadeia de comparações anterior, isolada e no
+// desenho de um caractere (a fonte antiga é desenhada direto das suas 8 colunas)
+static void benchmark_glyph_lookup(ssd1306_t *ssd)
+{
+    static const char text[] = "Digite o que deseja! 0123456789";
+    volatile uint32_t sink = 0; // Impede que o compilador descarte as buscas
+    const uint rounds = BENCHMARK_ROUNDS * 50; // Repetições suficientes para a resolução de 1 us do relógio
+    uint n = (sizeof(text) - 1) * rounds;
+
+    uint64_t start = time_us_64();
+    for (uint i = 0; i < rounds; ++i)
+        for (const char *c = text; *c; ++c)
+            sink += legacy_glyph_index(*c);
+    uint64_t legacy = time_us_64() - start;
+
+    start = time_us_64();
+    for (uint i = 0; i < rounds; ++i)
+        for (const char *c = text; *c; ++c)
+        {
+            const font_glyph_t *glyph = font_glyph(&font8x8, *c);
+            sink += glyph ? glyph->offset : 0;
+        }
+    uint64_t table = time_us_64() - start;
+
+    table = table * 10000 / n; // Décimos de ns por busca
+    legacy = legacy * 10000 / n;
+    printf("%-20s %6lu.%lu ns/op (comparacoes: %lu.%lu ns/op)\n", "busca de glifo", (unsigned long)(table / 10),
+           (unsigned long)(table % 10), (unsigned long)(legacy / 10), (unsigned long)(legacy % 10));
+
+    n = (sizeof(text) - 1) * BENCHMARK_ROUNDS;
+    start = time_us_64();
+    for (uint i = 0; i < BENCHMARK_ROUNDS; ++i)
+        for (const char *c = text; *c; ++c)
+            ssd1306_draw_columns(ssd, &legacy_font[legacy_glyph_index(*c)], 8, (i * 8) % 120, (i * 3) % 56);
+    legacy = time_us_64() - start;
+
+    start = time_us_64();
+    for (uint i = 0; i < BENCHMARK_ROUNDS; ++i)
+        for (const char *c = text; *c; ++c)
+            ssd1306_draw_char(ssd, *c, (i * 8) % 120, (i * 3) % 56);
+    table = time_us_64() - start;
+
+    printf("%-20s %8lu ns/op (fonte antiga: %lu ns/op)\n", "desenho de glifo",
+           (unsigned long)(table * 1000 / n), (unsigned long)(legacy * 1000 / n));
+}
+
+// Mede um blit repetido; retorna o tempo total em us
+static uint64_t time_blit(ssd1306_t *ssd, const bitmap_t *bitmap, int16_t y, ssd1306_mode_t mode)
+{
+    uint64_t start = time_us_64();
+    for (uint i = 0; i < BENCHMARK_ROUNDS; ++i)
+        ssd1306_blit(ssd, bitmap, 0, y, mode);
+    return time_us_64() - start;
+}
+
+// Compara o blit do logo comprimido em RLE com o da mesma imagem sem compressão, ambos lidos da flash
+static void benchmark_bitmap(ssd1306_t *ssd)
+{
+    static const struct
+    {
+        const char *name;
+        int16_t y;
+        ssd1306_mode_t mode;
+    } cases[] = {
+        {"copia alinhada", 0, SSD1306_COPY},
+        {"OR desalinhado", 3, SSD1306_SET},
+        {"XOR recortado", -20, SSD1306_XOR},
+    };
+    size_t raw = bitmap_raw_size(&bitmap_logo);
+
+    printf("\n== Bitmap %ux%u (images/logo.pbm) ==\n", (unsigned)bitmap_logo.width, (unsigned)bitmap_logo.height);
+    printf("%-20s %8u bytes (sem compressao: %u bytes, %u%%)\n", "tamanho RLE", (unsigned)bitmap_logo.size,
+           (unsigned)raw, (unsigned)(bitmap_logo.size * 100 / raw));
+    for (uint c = 0; c < count_of(cases); ++c)
+    {
+        uint64_t rle = time_blit(ssd, &bitmap_logo, cases[c].y, cases[c].mode);
+        uint64_t plain = time_blit(ssd, &bitmap_logo_raw, cases[c].y, cases[c].mode);
+        printf("%-20s %8lu us/blit %6lu KiB/s (sem compressao: %lu us/blit %6lu KiB/s)\n", cases[c].name,
+               (unsigned long)(rle / BENCHMARK_ROUNDS), (unsigned long)(raw * BENCHMARK_ROUNDS * 1000000 / 1024 / rle),
+               (unsigned long)(plain / BENCHMARK_ROUNDS), (unsigned long)(raw * BENCHMARK_ROUNDS * 1000000 / 1024 / plain));
+    }
+}
+
+// Mede a conversão de 8 quadros de 25 LEDs em planos de bits para a saída WS2812 paralela
+static void benchmark_parallel_pack()
+{
+    static uint32_t frames[WS2812_PARALLEL_MAX_STRIPS][25];
+    static uint32_t planes[25 * WS2812_PARALLEL_WORDS_PER_LED];
+    const uint32_t *strips[WS2812_PARALLEL_MAX_STRIPS];
+    for (uint s = 0; s < WS2812_PARALLEL_MAX_STRIPS; ++s)
+    {
+        strips[s] = frames[s];
+        for (uint i = 0; i < 25; ++i)
+            frames[s][i] = (s * 0x1234567u + i * 0x89abcdefu) & 0xffffff00;
+    }
+
+    uint64_t start = time_us_64();
+    for (uint i = 0; i < BENCHMARK_ROUNDS; ++i)
+        ws2812_parallel_pack(planes, strips, WS2812_PARALLEL_MAX_STRIPS, 25);
+    uint64_t elapsed = time_us_64() - start;
+
+    printf("\n== WS2812 paralelo (%d fitas x 25 LEDs) ==\n", WS2812_PARALLEL_MAX_STRIPS);
+    printf("%-20s %8lu ns/LED (8 fitas)\n", "transposicao",
+           (unsigned long)(elapsed * 1000 / (BENCHMARK_ROUNDS * 25)));
+    printf("%-20s %8lu us serial, %lu us paralelo\n", "transmissao",
+           (unsigned long)(WS2812_PARALLEL_MAX_STRIPS * 25 * 24 * WS2812_BIT_NS / 1000),
+           (unsigned long)(25 * 24 * WS2812_BIT_NS / 1000));
+}
+
+// Mede as operações em bloco do framebuffer de LEDs em matrizes de tamanhos diferentes
+static void benchmark_led_framebuffer()
+{
+    static const struct
+    {
+        uint width, height;
+    } sizes[] = {{5, 5}, {16, 16}, {64, 32}}; // 25, 256 e 2048 LEDs
+    static const uint32_t pattern[] = {0x00e5294e, 0x435084e5}; // Padrão de 8x8 bits
+
+    printf("\n== Framebuffer de LEDs (serpentina) ==\n");
+    for (uint s = 0; s < count_of(sizes); ++s)
+    {
+        led_fb_t fb;
+        if (!led_fb_init(&fb, sizes[s].width, sizes[s].height, LED_MAP_SERPENTINE))
+            continue;
+
+        uint64_t start = time_us_64();
+        for (uint i = 0; i < BENCHMARK_ROUNDS; ++i)
+            led_fb_fill(&fb, led_color(i, 0, 1));
+        uint64_t fill = time_us_64() - start;
+
+        // Referência: o mesmo preenchimento LED a LED, passando pelo mapa de coordenadas
+        start = time_us_64();
+        for (uint i = 0; i < BENCHMARK_ROUNDS; ++i)
+            for (uint y = 0; y < fb.height; ++y)
+                for (uint x = 0; x < fb.width; ++x)
+                    led_fb_set(&fb, x, y, led_color(i, 0, 1));
+        uint64_t fill_set = time_us_64() - start;
+
+        start = time_us_64();
+        for (uint i = 0; i < BENCHMARK_ROUNDS; ++i)
+            led_fb_blit(&fb, pattern, i % fb.width, 0, 8, 8, led_color(20, 0, 0), 0);
+        uint64_t blit = time_us_64() - start;
+
+        start = time_us_64();
+        for (uint i = 0; i < BENCHMARK_ROUNDS; ++i)
+            led_fb_scroll(&fb, -1, 0, 0);
+        uint64_t scroll = time_us_64() - start;
+
+        // Referência: a rolagem com led_fb_get/led_fb_set por LED
+        start = time_us_64();
+        for (uint i = 0; i < BENCHMARK_ROUNDS; ++i)
+            for (uint y = 0; y < fb.height; ++y)
+            {
+                for (uint x = 0; x + 1 < fb.width; ++x)
+                    led_fb_set(&fb, x, y, led_fb_get(&fb, x + 1, y));
+                led_fb_set(&fb, fb.width - 1, y, 0);
+            }
+        uint64_t scroll_set = time_us_64() - start;
+
+        printf("%4u LEDs: fill %5lu ns/LED (set %5lu), blit 8x8 %6lu ns, scroll %5lu ns/LED (get/set %5lu)\n",
+               fb.count, (unsigned long)(fill * 1000 / (BENCHMARK_ROUNDS * fb.count)),
+               (unsigned long)(fill_set * 1000 / (BENCHMARK_ROUNDS * fb.count)),
+               (unsigned long)(blit * 1000 / BENCHMARK_ROUNDS),
+               (unsigned long)(scroll * 1000 / (BENCHMARK_ROUNDS * fb.count)),
+               (unsigned long)(scroll_set * 1000 / (BENCHMARK_ROUNDS * fb.count)));
+        led_fb_free(&fb);
+    }
+}
+
+// Mede o custo de registrar um evento de rastreamento (a fila comporta todas as repetições)
+static void benchmark_trace()
+{
+    trace_reset();
+    uint64_t start = time_us_64();
+    for (uint i = 0; i < BENCHMARK_ROUNDS; ++i)
+        trace_record(TRACE_BENCHMARK, TRACE_PHASE_INSTANT, i);
+    uint64_t elapsed = time_us_64() - start;
+    trace_reset(); // Os eventos de medição não vão para o rastreamento
+
+    printf("%-20s %8lu ns/evento\n", "trace_record", (unsigned long)(elapsed * 1000 / BENCHMARK_ROUNDS));
+}
+
+// Mede o custo das primitivas de desenho e do envio ao display, imprimindo os resultados via stdio
+void benchmark_run(ssd1306_t *ssd)
+{
+    printf("\n== Benchmark SSD1306 (%d repeticoes) ==\n", BENCHMARK_ROUNDS);
+
+    for (uint p = 0; p < count_of(primitives); ++p)
+    {
+        uint64_t start = time_us_64();
+        for (uint i = 0; i < BENCHMARK_ROUNDS; ++i)
+            primitives[p].run(ssd, i);
+        uint64_t elapsed = time_us_64() - start;
+        printf("%-20s %8lu ns/op\n", primitives[p].name,
+               (unsigned long)(elapsed * 1000 / (BENCHMARK_ROUNDS * primitives[p].ops)));
+    }
+
+    benchmark_glyph_lookup(ssd);
+    benchmark_trace();
+
+    // Envio completo do quadro
+    ssd1306_reset_stats(ssd);
+    uint64_t start = time_us_64();
+    ssd1306_send_data(ssd);
+    report_flush(ssd, "flush completo", time_us_64() - start);
+
+    // Atualização típica da interface: estado de um LED e o dígito
+    ssd1306_draw_string(ssd, "G ON ", 8, 48);
+    ssd1306_draw_char(ssd, '5', 64, 23);
+    ssd1306_reset_stats(ssd);
+    start = time_us_64();
+    ssd1306_send_dirty(ssd);
+    report_flush(ssd, "flush incremental", time_us_64() - start);
+
+    // Nada alterado: o envio incremental não deve usar o barramento
+    ssd1306_reset_stats(ssd);
+    start = time_us_64();
+    ssd1306_send_dirty(ssd);
+    report_flush(ssd, "flush sem alteracoes", time_us_64() - start);
+
+    benchmark_bitmap(ssd);
+    benchmark_parallel_pack();
+    benchmark_led_framebuffer();
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "ssd1306.h"
+
+// Número de repetições de cada medição do benchmark
+#define BENCHMARK_ROUNDS 200
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mede o custo das primitivas de desenho e do envio ao display, imprimindo os resultados via stdio
+// Inclui o custo por LED da conversão em planos de bits da saída WS2812 paralela
+void benchmark_run(ssd1306_t *ssd);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Codificação dos dados de um bitmap
+typedef enum
+{
+    BITMAP_RAW, // Bytes do quadro, sem compressão
+    BITMAP_RLE, // Sequências: controle < 0x80 seguido de controle + 1 bytes literais,
+                // ou controle >= 0x80 seguido de um byte repetido (controle - 0x80) + 2 vezes
+} bitmap_format_t;
+
+// Imagem de 1 bit gerada por tools/img2bitmap.py e armazenada em flash
+// Os bytes são colunas de 8 pixels (bit 0 no topo), página a página como nas fontes: a página 0 da esquerda
+// para a direita, depois a página 1, ... Assim, fundos e linhas horizontais viram sequências longas no RLE.
+// As linhas além de height na última página são zero.
+typedef struct
+{
+    uint8_t width, height;  // Dimensões em pixels
+    uint8_t pages;          // Páginas de 8 linhas por coluna
+    uint8_t format;         // Codificação de data (bitmap_format_t)
+    uint16_t size;          // Bytes em data
+    const uint8_t *data;    // Dados codificados
+} bitmap_t;
+
+// Imagens geradas de images/*.pbm durante a compilação; a versão _raw, sem compressão, só ocupa a flash se for usada
+extern const bitmap_t bitmap_logo;
+extern const bitmap_t bitmap_logo_raw;
+
+// Tamanho do bitmap sem compressão, em bytes
+static inline size_t bitmap_raw_size(const bitmap_t *bitmap)
+{
+    return (size_t)bitmap->width * bitmap->pages;
+}
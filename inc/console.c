@@ -0,0 +1,43 @@
+#include "console.h"
+
+// Limpa o display e inicia o console com a tela vazia
+void console_init(console_t *con, ssd1306_t *ssd)
+{
+    con->ssd = ssd;
+    con->rows = ssd->pages;
+    con->top = 0;
+    con->count = 0;
+    con->lines = 0;
+    ssd1306_fill(ssd, false);
+    ssd1306_set_start_line(ssd, 0);
+}
+
+// Página da GDDRAM que contém a linha visível row (0 = topo da tela)
+uint8_t console_page(const console_t *con, uint8_t row)
+{
+    return (con->top + row) % con->rows;
+}
+
+// Acrescenta uma linha (truncada em CONSOLE_COLS); com a tela cheia, a linha mais antiga rola para fora
+void console_write_line(console_t *con, const char *text)
+{
+    uint8_t page;
+    if (con->count < con->rows)
+        page = console_page(con, con->count++); // Ainda há linhas livres abaixo da última
+    else
+    {
+        // Reaproveita a página da linha mais antiga e gira o anel: ela passa a ser a última linha
+        page = con->top;
+        con->top = (con->top + 1) % con->rows;
+        ssd1306_set_start_line(con->ssd, con->top * 8);
+    }
+
+    // Cada célula sobrescreve o fundo, então a página inteira é redesenhada sem limpeza prévia;
+    // apenas ela fica marcada como alterada (~130 bytes no barramento em vez do quadro de ~1 KB)
+    for (uint8_t i = 0; i < CONSOLE_COLS; ++i)
+    {
+        char c = *text ? *text++ : ' ';
+        ssd1306_draw_char(con->ssd, c, i * 8, page * 8);
+    }
+    con->lines++;
+}
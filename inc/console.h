@@ -0,0 +1,27 @@
+#pragma once
+
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+
+#define CONSOLE_COLS 16 // Caracteres por linha (células de 8 pixels em 128 colunas)
+
+// Console de texto rolante: a GDDRAM funciona como um anel de linhas de texto (uma por página)
+// e a rolagem apenas gira a linha inicial do display, sem reenviar o quadro inteiro.
+// Requer um painel de 64 linhas, em que toda a GDDRAM é visível.
+typedef struct
+{
+    ssd1306_t *ssd;
+    uint8_t rows;   // Linhas de texto (páginas do display)
+    uint8_t top;    // Página exibida no topo da tela
+    uint8_t count;  // Linhas ocupadas (até rows)
+    uint32_t lines; // Linhas escritas desde a criação
+} console_t;
+
+// Limpa o display e inicia o console com a tela vazia
+void console_init(console_t *con, ssd1306_t *ssd);
+
+// Acrescenta uma linha (truncada em CONSOLE_COLS); com a tela cheia, a linha mais antiga rola para fora
+void console_write_line(console_t *con, const char *text);
+
+// Página da GDDRAM que contém a linha visível row (0 = topo da tela)
+uint8_t console_page(const console_t *con, uint8_t row);
@@ -0,0 +1,83 @@
+#include "debounce.h"
+
+// Prepara a entrada no estado solto
+void debounce_init(debounce_t *db, uint8_t press_samples, uint8_t release_samples, uint32_t long_press_us)
+{
+    db->press_samples = press_samples ? press_samples : 1;
+    db->release_samples = release_samples ? release_samples : 1;
+    db->long_press_us = long_press_us;
+    db->level = 0;
+    db->pressed = false;
+    db->settling = false;
+    db->long_sent = false;
+    db->edge_us = 0;
+    db->pressed_us = 0;
+}
+
+// Registra uma borda (interrupção da GPIO) para que o evento leve o instante exato da transição
+void debounce_edge(debounce_t *db, uint32_t time_us)
+{
+    if (db->settling)
+        return; // Trepidação dentro da mesma transição: vale a primeira borda
+    db->settling = true;
+    db->edge_us = time_us;
+}
+
+// Processa uma amostra (active: botão pressionado); retorna o evento emitido e o seu instante em time_us
+debounce_event_t debounce_sample(debounce_t *db, bool active, uint32_t now_us, uint32_t *time_us)
+{
+    if (active != db->pressed && !db->settling)
+        debounce_edge(db, now_us); // Borda não vista pela interrupção: vale o instante da amostra
+
+    if (!db->pressed)
+    {
+        if (active)
+            db->level++;
+        else if (db->level > 0)
+            db->level--;
+
+        if (db->level >= db->press_samples)
+        {
+            db->pressed = true;
+            db->long_sent = false;
+            db->pressed_us = db->edge_us;
+            db->level = db->release_samples; // A partir daqui o saldo conta em direção à soltura
+            db->settling = false;
+            *time_us = db->edge_us;
+            return DEBOUNCE_PRESS;
+        }
+        if (db->level == 0)
+            db->settling = false; // Pulso curto demais: descartado
+        return DEBOUNCE_NONE;
+    }
+
+    if (!active)
+        db->level--;
+    else if (db->level < db->release_samples)
+        db->level++;
+
+    if (db->level == 0)
+    {
+        db->pressed = false;
+        db->settling = false;
+        *time_us = db->edge_us;
+        return DEBOUNCE_RELEASE;
+    }
+    if (db->level == db->release_samples)
+        db->settling = false;
+
+    if (db->long_press_us && !db->long_sent && now_us - db->pressed_us >= db->long_press_us)
+    {
+        db->long_sent = true;
+        *time_us = now_us;
+        return DEBOUNCE_LONG_PRESS;
+    }
+    return DEBOUNCE_NONE;
+}
+
+// Indica se a entrada está em repouso e a amostragem pode parar até a próxima borda
+bool debounce_idle(const debounce_t *db)
+{
+    // Pressionado e ainda sem o evento longo, a amostragem continua para medir a duração
+    return !db->settling && (!db->pressed || !db->long_press_us || db->long_sent);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sem dependências do SDK: a mesma máquina de estados roda no computador com bordas gravadas
+
+#define DEBOUNCE_SAMPLE_US 1000     // Período de amostragem enquanto algum botão está em transição
+#define DEBOUNCE_PRESS_SAMPLES 3    // Saldo de amostras pressionadas que confirma o pressionamento
+#define DEBOUNCE_RELEASE_SAMPLES 5  // Saldo de amostras soltas que confirma a soltura
+#define DEBOUNCE_LONG_PRESS_US 800000 // Tempo pressionado até o evento de pressionamento longo (0 desativa)
+
+// Eventos emitidos pela máquina de estados
+typedef enum
+{
+    DEBOUNCE_NONE,
+    DEBOUNCE_PRESS,      // Pressionamento confirmado
+    DEBOUNCE_RELEASE,    // Soltura confirmada
+    DEBOUNCE_LONG_PRESS, // Botão mantido pressionado por long_press_us
+} debounce_event_t;
+
+// Debounce por integrador de uma entrada: cada amostra pressionada soma e cada amostra solta subtrai,
+// e o estado só muda quando o saldo atinge o limiar. Os eventos levam o instante da primeira borda
+// da transição, e não o da confirmação.
+typedef struct
+{
+    uint8_t press_samples;   // Limiar para confirmar o pressionamento
+    uint8_t release_samples; // Limiar para confirmar a soltura
+    uint32_t long_press_us;  // Duração do pressionamento longo (0 desativa)
+
+    uint8_t level;           // Saldo do integrador: 0 em repouso solto, release_samples em repouso pressionado
+    bool pressed;            // Estado confirmado
+    bool settling;           // Transição em andamento (borda vista ou amostra diferente do estado)
+    bool long_sent;          // Pressionamento longo já emitido
+    uint32_t edge_us;        // Primeira borda da transição em andamento
+    uint32_t pressed_us;     // Início do pressionamento confirmado
+} debounce_t;
+
+// Prepara a entrada no estado solto
+void debounce_init(debounce_t *db, uint8_t press_samples, uint8_t release_samples, uint32_t long_press_us);
+
+// Registra uma borda (interrupção da GPIO) para que o evento leve o instante exato da transição
+void debounce_edge(debounce_t *db, uint32_t time_us);
+
+// Processa uma amostra (active: botão pressionado); retorna o evento emitido e o seu instante em time_us
+debounce_event_t debounce_sample(debounce_t *db, bool active, uint32_t now_us, uint32_t *time_us);
+
+// Indica se a entrada está em repouso e a amostragem pode parar até a próxima borda
+bool debounce_idle(const debounce_t *db);
+
+#ifdef __cplusplus
+}
+#endif
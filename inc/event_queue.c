@@ -0,0 +1,40 @@
+#include "event_queue.h"
+#include "hardware/sync.h"
+
+// Inicializa a fila vazia
+void event_queue_init(event_queue_t *queue)
+{
+    queue->head = 0;
+    queue->tail = 0;
+    queue->dropped = 0;
+}
+
+// Insere um evento (produtor); retorna false se a fila estiver cheia
+bool event_queue_push(event_queue_t *queue, const event_t *event)
+{
+    uint32_t head = queue->head;
+    if (head - queue->tail == EVENT_QUEUE_SIZE)
+    {
+        queue->dropped++;
+        return false;
+    }
+
+    queue->events[head & (EVENT_QUEUE_SIZE - 1)] = *event;
+    __dmb();                 // O evento precisa estar visível antes do novo índice
+    queue->head = head + 1;
+    return true;
+}
+
+// Remove o evento mais antigo (consumidor); retorna false se a fila estiver vazia
+bool event_queue_pop(event_queue_t *queue, event_t *event)
+{
+    uint32_t tail = queue->tail;
+    if (tail == queue->head)
+        return false;
+
+    __dmb();                 // Lê o evento somente depois de observar o índice publicado pelo produtor
+    *event = queue->events[tail & (EVENT_QUEUE_SIZE - 1)];
+    __dmb();                 // Termina a leitura antes de liberar a posição
+    queue->tail = tail + 1;
+    return true;
+}
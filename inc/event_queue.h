@@ -0,0 +1,45 @@
+#pragma once
+
+#include "pico/stdlib.h"
+
+#define EVENT_QUEUE_SIZE 32 // Capacidade da fila (potência de 2)
+
+// Tipos de eventos de entrada
+typedef enum
+{
+    EVENT_BUTTON_PRESS,      // Pressionamento confirmado pelo debounce (data = número da GPIO)
+    EVENT_BUTTON_RELEASE,    // Soltura confirmada
+    EVENT_BUTTON_LONG_PRESS, // Botão mantido pressionado por DEBOUNCE_LONG_PRESS_US
+} event_type_t;
+
+// Evento de entrada com o instante em que ocorreu
+typedef struct
+{
+    uint32_t time_us; // Instante do evento (timer de 1 MHz); nos botões, a primeira borda da transição
+    uint8_t type;     // Tipo do evento (event_type_t)
+    uint8_t data;     // Informação associada ao evento
+} event_t;
+
+// Fila circular sem travas para um único produtor (interrupção) e um único consumidor (laço principal)
+typedef struct
+{
+    event_t events[EVENT_QUEUE_SIZE];
+    volatile uint32_t head;    // Próxima posição de escrita (alterada apenas pelo produtor)
+    volatile uint32_t tail;    // Próxima posição de leitura (alterada apenas pelo consumidor)
+    volatile uint32_t dropped; // Eventos descartados por falta de espaço
+} event_queue_t;
+
+// Inicializa a fila vazia
+void event_queue_init(event_queue_t *queue);
+
+// Insere um evento (produtor); retorna false se a fila estiver cheia
+bool event_queue_push(event_queue_t *queue, const event_t *event);
+
+// Remove o evento mais antigo (consumidor); retorna false se a fila estiver vazia
+bool event_queue_pop(event_queue_t *queue, event_t *event);
+
+// Indica se a fila está vazia
+static inline bool event_queue_empty(const event_queue_t *queue)
+{
+    return queue->head == queue->tail;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FONT_MAX_CELL 32 // Maior largura de célula aceita para o texto monoespaçado
+
+// Glifo de uma fonte gerada por tools/bdf2font.py
+typedef struct
+{
+    uint16_t offset; // Posição da primeira coluna em data
+    uint8_t width;   // Número de colunas (0 se o caractere não existe na fonte)
+    uint8_t left;    // Colunas vazias à esquerda na célula original (usado no texto monoespaçado)
+} font_glyph_t;
+
+// Fonte em colunas no formato do buffer do SSD1306 (bit 0 no topo), página a página, armazenada em flash
+typedef struct
+{
+    uint8_t first, last;        // Intervalo de caracteres da tabela de glifos
+    uint8_t height, pages;      // Altura em pixels e em páginas de 8 linhas
+    uint8_t cell;               // Largura da célula no texto monoespaçado
+    uint8_t spacing;            // Colunas vazias entre glifos no texto proporcional
+    const font_glyph_t *glyphs; // Um glifo por caractere, indexado por (c - first)
+    const uint8_t *data;        // Colunas de cada glifo: página 0, depois página 1, ...
+} font_t;
+
+// Fonte padrão, gerada de fonts/font8x8.bdf durante a compilação
+extern const font_t font8x8;
+
+// Glifo de um caractere (NULL se estiver fora da tabela)
+static inline const font_glyph_t *font_glyph(const font_t *font, char c)
+{
+    uint8_t code = (uint8_t)c;
+    if (code < font->first || code > font->last)
+        return NULL;
+    return &font->glyphs[code - font->first];
+}
+
+// Colunas de uma página do glifo
+static inline const uint8_t *font_glyph_columns(const font_t *font, const font_glyph_t *glyph, uint8_t page)
+{
+    return &font->data[glyph->offset + page * glyph->width];
+}
@@ -0,0 +1,201 @@
+#include <string.h>
+#include "frame_scheduler.h"
+#include "hardware/sync.h"
+
+// Indica se não há nada a fazer: ticks atendidos, nenhuma alteração pendente e nenhum quadro em andamento
+static bool frame_scheduler_quiet(frame_scheduler_t *sched)
+{
+    if (sched->ticks != sched->served)
+        return false;
+    for (uint i = 0; i < sched->count; ++i)
+        if (sched->devices[i].invalid || sched->devices[i].start_us)
+            return false;
+    return true;
+}
+
+// Registra um tick e acorda quem estiver aguardando em __wfe (chamada com a trava obtida)
+static void frame_scheduler_signal(frame_scheduler_t *sched)
+{
+    uint32_t now = time_us_32();
+
+    if (sched->ticks && !sched->resumed)
+    {
+        uint32_t interval = now - sched->tick_time_us;
+        uint32_t jitter = interval > sched->tick_us ? interval - sched->tick_us : sched->tick_us - interval;
+        if (jitter > sched->jitter_max_us)
+            sched->jitter_max_us = jitter;
+    }
+
+    if (sched->resumed)
+    {
+        // Os ticks que o timer parado deixou de gerar contam para os limites de fps, sem entrar como perdidos
+        uint32_t idle_ticks = (now - sched->tick_time_us) / sched->tick_us;
+        if (idle_ticks > 1)
+        {
+            sched->served += idle_ticks - 1;
+            sched->ticks += idle_ticks - 1;
+        }
+        sched->resumed = false;
+    }
+    sched->tick_time_us = now;
+    __dmb();
+    sched->ticks++;
+    __sev();
+}
+
+// Interrupção do timer: registra o tick, ou para o timer se não houver trabalho (sem acordar os núcleos à toa)
+static bool frame_scheduler_tick(repeating_timer_t *timer)
+{
+    frame_scheduler_t *sched = timer->user_data;
+
+    // Parar e reiniciar são decididos sob a mesma trava: depois de running = false, o próximo
+    // frame_scheduler_invalidate agenda o reinício, que só roda depois deste retorno
+    critical_section_enter_blocking(&sched->lock);
+    bool quiet = frame_scheduler_quiet(sched);
+    if (quiet)
+    {
+        sched->running = false;
+        sched->pauses++;
+    }
+    else
+        frame_scheduler_signal(sched);
+    critical_section_exit(&sched->lock);
+    return !quiet;
+}
+
+// Reinicia o timer parado, no contexto de interrupção do pool de alarmes (núcleo 0)
+// O repeating_timer_t só é alterado aqui e pelo próprio SDK ao retornar de frame_scheduler_tick,
+// ambos na mesma interrupção, de modo que o alarm_id do timer novo não é sobrescrito
+static int64_t frame_scheduler_restart(alarm_id_t id, void *user_data)
+{
+    frame_scheduler_t *sched = user_data;
+    add_repeating_timer_us(-(int64_t)sched->tick_us, frame_scheduler_tick, sched, &sched->timer);
+    return 0;
+}
+
+// Inicia o timer que gera um tick a cada tick_us
+bool frame_scheduler_init(frame_scheduler_t *sched, uint32_t tick_us)
+{
+    memset(sched, 0, sizeof(*sched));
+    sched->tick_us = tick_us;
+    sched->running = true;
+    critical_section_init(&sched->lock);
+
+    // Período negativo: o intervalo é contado entre os inícios das chamadas, sem acumular atraso
+    return add_repeating_timer_us(-(int64_t)tick_us, frame_scheduler_tick, sched, &sched->timer);
+}
+
+// Registra um dispositivo com limite de fps; retorna seu índice, ou -1 se não houver espaço
+int frame_scheduler_add(frame_scheduler_t *sched, const char *name, uint fps, bool (*present)(void *ctx), void *ctx)
+{
+    if (sched->count == FRAME_MAX_DEVICES)
+        return -1;
+
+    frame_device_t *dev = &sched->devices[sched->count];
+    memset(dev, 0, sizeof(*dev));
+    dev->name = name;
+    dev->present = present;
+    dev->ctx = ctx;
+
+    // Arredonda o período para o número de ticks mais próximo (no mínimo um tick)
+    uint32_t period_us = 1000000 / (fps ? fps : 1);
+    dev->period_ticks = (period_us + sched->tick_us / 2) / sched->tick_us;
+    if (!dev->period_ticks)
+        dev->period_ticks = 1;
+    dev->last_tick = sched->served - dev->period_ticks; // O primeiro quadro pode sair no próximo tick
+
+    return sched->count++;
+}
+
+// Registra que o conteúdo do dispositivo mudou e deve ser enviado no próximo quadro permitido
+void frame_scheduler_invalidate(frame_scheduler_t *sched, int device)
+{
+    critical_section_enter_blocking(&sched->lock);
+    sched->devices[device].invalid = true;
+    bool resume = !sched->running;
+    if (resume)
+    {
+        // Timer parado: o tick é gerado aqui mesmo, sem esperar um período, e a cadência recomeça a partir dele
+        sched->running = true;
+        sched->resumed = true;
+        frame_scheduler_signal(sched);
+    }
+    critical_section_exit(&sched->lock);
+
+    // O timer é reiniciado pela interrupção do pool (SDK 2.x: mesmo com o instante já passado, o
+    // alarme roda lá e nunca dentro desta chamada), e não por este núcleo
+    if (resume && add_alarm_in_us(0, frame_scheduler_restart, sched, true) <= 0)
+    {
+        // Pool sem alarmes livres: o timer fica parado e a próxima alteração tenta de novo
+        critical_section_enter_blocking(&sched->lock);
+        sched->running = false;
+        critical_section_exit(&sched->lock);
+    }
+}
+
+// Registra o término do quadro em andamento do dispositivo (pode ser chamada em contexto de interrupção)
+void frame_scheduler_done(frame_scheduler_t *sched, int device)
+{
+    frame_device_t *dev = &sched->devices[device];
+    uint32_t start = dev->start_us;
+    if (!start)
+        return;
+
+    uint32_t elapsed = time_us_32() - start;
+    if (elapsed > dev->frame_time_max_us)
+        dev->frame_time_max_us = elapsed;
+    dev->frame_time_total_us += elapsed;
+    dev->frames_done++;
+    dev->start_us = 0;
+}
+
+// Retorna true se há um tick aguardando atendimento
+bool frame_scheduler_pending(frame_scheduler_t *sched)
+{
+    return sched->ticks != sched->served;
+}
+
+// Atende o tick pendente, se houver, enviando os dispositivos alterados cujo intervalo mínimo já passou
+bool frame_scheduler_run(frame_scheduler_t *sched)
+{
+    if (sched->ticks == sched->served)
+        return false;
+
+    // ticks, served e tick_time_us também são alterados pela interrupção do timer no outro núcleo
+    critical_section_enter_blocking(&sched->lock);
+    uint32_t ticks = sched->ticks;
+    uint32_t now = time_us_32();
+    uint32_t delay = now - sched->tick_time_us;
+    sched->missed += ticks - sched->served - 1; // Ticks perdidos são agrupados neste
+    sched->served = ticks;
+    critical_section_exit(&sched->lock);
+
+    if (delay > sched->service_max_us)
+        sched->service_max_us = delay;
+
+    for (uint i = 0; i < sched->count; ++i)
+    {
+        frame_device_t *dev = &sched->devices[i];
+        if (ticks - dev->last_tick < dev->period_ticks)
+            continue; // Limite de fps do dispositivo
+
+        if (!dev->invalid)
+        {
+            dev->skipped++; // Nada mudou: nenhum tráfego no barramento
+            continue;
+        }
+
+        dev->start_us = now ? now : 1;
+        if (!dev->present(dev->ctx))
+        {
+            dev->start_us = 0;
+            dev->deferred++; // O envio anterior ainda não terminou: tenta no próximo tick
+            continue;
+        }
+
+        dev->invalid = false;
+        dev->last_tick = ticks;
+        dev->frames++;
+    }
+    return true;
+}
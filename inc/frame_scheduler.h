@@ -0,0 +1,71 @@
+#pragma once
+
+#include "pico/stdlib.h"
+#include "pico/critical_section.h"
+
+#define FRAME_MAX_DEVICES 4 // Número máximo de dispositivos de saída atendidos pelo escalonador
+
+// Dispositivo de saída atualizado pelo escalonador (display, matriz de LEDs, ...)
+typedef struct
+{
+    const char *name;            // Nome exibido nas estatísticas
+    uint32_t period_ticks;       // Intervalo mínimo entre quadros, em ticks (limite de fps)
+    uint32_t last_tick;          // Tick em que o último quadro foi iniciado
+    bool invalid;                // Há alterações ainda não enviadas
+    bool (*present)(void *ctx);  // Inicia o envio do quadro; retorna false se o dispositivo estiver ocupado
+    void *ctx;                   // Contexto repassado a present
+
+    volatile uint32_t start_us;  // Início do quadro em andamento (0 se não houver)
+
+    // Contadores
+    volatile uint32_t frames;              // Quadros enviados
+    volatile uint32_t skipped;             // Quadros pulados por não haver alteração
+    volatile uint32_t deferred;            // Quadros adiados porque o dispositivo ainda estava ocupado
+    volatile uint32_t frame_time_max_us;   // Maior duração de um quadro (início do envio até o término)
+    volatile uint32_t frame_time_total_us; // Soma das durações (para a média)
+    volatile uint32_t frames_done;         // Quadros com término registrado
+} frame_device_t;
+
+// Escalonador de quadros em cadência fixa, ritmado por um timer de hardware repetitivo
+// Sem alterações nem quadros em andamento, o timer para; a próxima alteração o reinicia com um tick imediato
+typedef struct
+{
+    uint32_t tick_us;                      // Período do timer
+    repeating_timer_t timer;               // Timer que gera os ticks
+    critical_section_t lock;               // Decide entre parar e reiniciar o timer e protege ticks, served e tick_time_us
+    volatile bool running;                 // Timer ativo ou com reinício agendado
+    bool resumed;                          // O próximo tick é o primeiro após reiniciar (sem medir jitter)
+    volatile uint32_t ticks;               // Ticks gerados (pela interrupção do timer, ou ao reiniciar com o timer parado)
+    volatile uint32_t tick_time_us;        // Instante do último tick
+    uint32_t served;                       // Último tick atendido
+
+    frame_device_t devices[FRAME_MAX_DEVICES];
+    uint count;                            // Dispositivos registrados
+
+    // Contadores
+    volatile uint32_t missed;              // Ticks não atendidos a tempo (agrupados com o seguinte)
+    volatile uint32_t jitter_max_us;       // Maior desvio do intervalo entre ticks em relação ao período
+    volatile uint32_t service_max_us;      // Maior atraso entre o tick e o seu atendimento
+    volatile uint32_t pauses;              // Vezes em que o timer parou por falta de trabalho
+} frame_scheduler_t;
+
+// Inicia o timer que gera um tick a cada tick_us
+bool frame_scheduler_init(frame_scheduler_t *sched, uint32_t tick_us);
+
+// Registra um dispositivo com limite de fps; retorna seu índice, ou -1 se não houver espaço
+int frame_scheduler_add(frame_scheduler_t *sched, const char *name, uint fps, bool (*present)(void *ctx), void *ctx);
+
+// Registra que o conteúdo do dispositivo mudou e deve ser enviado no próximo quadro permitido
+// Se o timer estiver parado, gera um tick imediato e agenda o reinício do timer na interrupção do pool de
+// alarmes, o único contexto que altera o timer (deve ser chamada pelo núcleo que chama frame_scheduler_run)
+void frame_scheduler_invalidate(frame_scheduler_t *sched, int device);
+
+// Registra o término do quadro em andamento do dispositivo (pode ser chamada em contexto de interrupção)
+void frame_scheduler_done(frame_scheduler_t *sched, int device);
+
+// Atende o tick pendente, se houver, enviando os dispositivos alterados cujo intervalo mínimo já passou
+// Retorna true se um tick foi atendido
+bool frame_scheduler_run(frame_scheduler_t *sched);
+
+// Retorna true se há um tick aguardando atendimento
+bool frame_scheduler_pending(frame_scheduler_t *sched);
@@ -0,0 +1,277 @@
+#include <string.h>
+#include "i2c_bus.h"
+#include "hardware/dma.h"
+
+static const char *const priority_names[I2C_PRIO_COUNT] = {"urgente", "normal", "lote"};
+
+// Tempo previsto de uma transação: 9 ciclos de SCL por palavra, mais START e STOP
+static uint32_t i2c_bus_time_us(uint32_t words, uint32_t baudrate)
+{
+    return (uint32_t)(((uint64_t)words * 9 + 2) * 1000000 / baudrate) + 1;
+}
+
+// Inicializa o controlador na frequência pedida (até I2C_BUS_FAST_PLUS) e destrava o barramento se necessário
+bool i2c_bus_init(i2c_bus_t *bus, i2c_inst_t *i2c, uint sda, uint scl, uint32_t baudrate)
+{
+    memset(bus, 0, sizeof(*bus));
+    bus->i2c = i2c;
+    bus->sda = sda;
+    bus->scl = scl;
+    bus->baudrate = baudrate > I2C_BUS_FAST_PLUS ? I2C_BUS_FAST_PLUS : baudrate;
+    critical_section_init(&bus->lock);
+
+    // Um dispositivo reiniciado no meio de uma leitura pode manter SDA em nível baixo
+    if (!gpio_get(sda))
+        i2c_bus_recover(bus);
+    else
+        i2c_init(i2c, bus->baudrate);
+
+    bus->dma_channel = dma_claim_unused_channel(false);
+    if (bus->dma_channel < 0)
+        return false;
+
+    dma_channel_config config = dma_channel_get_default_config(bus->dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);       // Uma palavra de IC_DATA_CMD por byte
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, i2c_get_dreq(i2c, true));         // Ritmo ditado pela FIFO de transmissão
+    dma_channel_configure(bus->dma_channel, &config, &i2c_get_hw(i2c)->data_cmd, NULL, 0, false);
+    return true;
+}
+
+// Prepara uma transação com palavras já codificadas
+void i2c_xfer_init(i2c_xfer_t *xfer, uint8_t address, i2c_priority_t priority, const uint16_t *words, uint16_t count)
+{
+    memset(xfer, 0, sizeof(*xfer));
+    xfer->address = address;
+    xfer->priority = priority;
+    xfer->words = words;
+    xfer->count = count;
+}
+
+// Codifica em words a escrita de tx seguida da leitura de rx_len bytes (com RESTART); retorna o número de palavras
+uint16_t i2c_bus_encode(uint16_t *words, const uint8_t *tx, uint16_t tx_len, uint8_t rx_len)
+{
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < tx_len; ++i)
+        words[count++] = tx[i];
+    for (uint8_t i = 0; i < rx_len; ++i)
+        words[count++] = I2C_IC_DATA_CMD_CMD_BITS | (i == 0 && tx_len ? I2C_IC_DATA_CMD_RESTART_BITS : 0);
+    if (count)
+        words[count - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    return count;
+}
+
+// Enfileira a transação (qualquer núcleo); retorna false se a fila da classe estiver cheia
+bool i2c_bus_submit(i2c_bus_t *bus, i2c_xfer_t *xfer)
+{
+    uint8_t prio = xfer->priority < I2C_PRIO_COUNT ? xfer->priority : I2C_PRIO_BULK;
+    if (xfer->count == 0 || xfer->rx_len > I2C_BUS_RX_MAX)
+        return false;
+
+    critical_section_enter_blocking(&bus->lock);
+    bool queued = bus->head[prio] - bus->tail[prio] < I2C_BUS_QUEUE_SIZE;
+    if (queued)
+    {
+        xfer->state = I2C_XFER_QUEUED;
+        xfer->queued_us = time_us_32();
+        bus->queue[prio][bus->head[prio]++ & (I2C_BUS_QUEUE_SIZE - 1)] = xfer;
+    }
+    else
+        bus->rejected++;
+    critical_section_exit(&bus->lock);
+
+    __sev(); // Acorda o núcleo que conduz o barramento caso esteja aguardando em __wfe
+    return queued;
+}
+
+// Inicia a transação mais urgente pendente
+static void i2c_bus_start_next(i2c_bus_t *bus)
+{
+    for (uint8_t prio = 0; prio < I2C_PRIO_COUNT; ++prio)
+    {
+        if (bus->tail[prio] == bus->head[prio])
+            continue;
+        i2c_xfer_t *xfer = bus->queue[prio][bus->tail[prio]++ & (I2C_BUS_QUEUE_SIZE - 1)];
+
+        // Seleciona o endereço do dispositivo (o controlador precisa estar desabilitado para alterar o TAR)
+        i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+        hw->enable = 0;
+        hw->tar = xfer->address;
+        hw->enable = 1;
+
+        xfer->state = I2C_XFER_ACTIVE;
+        xfer->rx_done = 0;
+        bus->active = xfer;
+        bus->deadline_us = time_us_32() + 2 * i2c_bus_time_us(xfer->count, bus->baudrate) + I2C_BUS_TIMEOUT_US;
+        dma_channel_transfer_from_buffer_now(bus->dma_channel, xfer->words, xfer->count);
+        return;
+    }
+}
+
+// Contabiliza o término da transação ativa e ajusta a frequência após falhas seguidas
+static void i2c_bus_finish(i2c_bus_t *bus, bool ok)
+{
+    i2c_xfer_t *xfer = bus->active;
+    bus->active = NULL;
+    xfer->state = ok ? I2C_XFER_DONE : I2C_XFER_FAILED;
+
+    if (!ok)
+    {
+        bus->failed++;
+        // Fast-mode Plus exige pull-ups fortes e dispositivos compatíveis: com falhas seguidas, recua para 400 kHz
+        if (++bus->errors >= I2C_BUS_FALLBACK_ERRORS && bus->baudrate > I2C_BUS_FAST)
+        {
+            bus->baudrate = I2C_BUS_FAST;
+            i2c_set_baudrate(bus->i2c, bus->baudrate);
+            bus->fallbacks++;
+            bus->errors = 0;
+        }
+        return;
+    }
+    bus->errors = 0;
+
+    uint8_t prio = xfer->priority < I2C_PRIO_COUNT ? xfer->priority : I2C_PRIO_BULK;
+    uint32_t latency = time_us_32() - xfer->queued_us;
+    uint8_t bin = 0;
+    while (bin + 1 < I2C_BUS_HIST_BINS && latency >> (bin + 1))
+        ++bin;
+    bus->latency_hist[prio][bin]++;
+    if (latency > bus->latency_max_us[prio])
+        bus->latency_max_us[prio] = latency;
+    bus->completed[prio]++;
+    bus->bytes += xfer->count + 1;
+}
+
+// Resultado da verificação da transação ativa
+typedef enum
+{
+    I2C_CHECK_PENDING, // Ainda em andamento
+    I2C_CHECK_DONE,    // Terminou (com sucesso ou recusada pelo dispositivo)
+    I2C_CHECK_STALLED, // Sem progresso no prazo: o barramento precisa ser destravado
+} i2c_check_t;
+
+// Verifica o andamento da transação ativa
+static i2c_check_t i2c_bus_check(i2c_bus_t *bus)
+{
+    i2c_xfer_t *xfer = bus->active;
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+
+    // Os bytes lidos são retirados à medida que chegam
+    while (xfer->rx_done < xfer->rx_len && hw->rxflr)
+        xfer->rx[xfer->rx_done++] = (uint8_t)hw->data_cmd;
+
+    if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+    {
+        // Dispositivo não respondeu: interrompe o DMA e descarta o restante da transação
+        dma_channel_abort(bus->dma_channel);
+        (void)hw->clr_tx_abrt;
+        i2c_bus_finish(bus, false);
+        return I2C_CHECK_DONE;
+    }
+
+    if (dma_channel_is_busy(bus->dma_channel) ||
+        !(hw->status & I2C_IC_STATUS_TFE_BITS) ||
+        (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS) ||
+        xfer->rx_done < xfer->rx_len)
+    {
+        if ((int32_t)(time_us_32() - bus->deadline_us) < 0)
+            return I2C_CHECK_PENDING; // Ainda há palavras no DMA, na FIFO ou no barramento
+        return I2C_CHECK_STALLED;     // Um dispositivo está segurando o barramento
+    }
+
+    i2c_bus_finish(bus, true);
+    return I2C_CHECK_DONE;
+}
+
+// Acompanha a transação ativa e inicia a próxima; deve ser chamada continuamente por um único núcleo
+// Retorna true quando o barramento está livre e não há pendências
+bool i2c_bus_poll(i2c_bus_t *bus)
+{
+    i2c_xfer_t *finished = NULL;
+    i2c_check_t check = I2C_CHECK_DONE;
+
+    critical_section_enter_blocking(&bus->lock);
+    if (bus->active)
+    {
+        finished = bus->active;
+        check = i2c_bus_check(bus);
+    }
+    if (!bus->active)
+        i2c_bus_start_next(bus); // Entre duas transações, a classe mais urgente passa à frente
+    bool idle = !bus->active;
+    critical_section_exit(&bus->lock);
+
+    if (check == I2C_CHECK_STALLED)
+    {
+        // O destravamento leva dezenas de µs com pulsos de SCL: fora da seção crítica, para não mascarar
+        // as interrupções nem prender o outro núcleo. Só este núcleo usa a transação ativa, que continua
+        // ocupando o barramento até o fim do destravamento; submit mexe apenas nas filas
+        dma_channel_abort(bus->dma_channel);
+        i2c_bus_recover(bus);
+        i2c_bus_finish(bus, false);
+
+        critical_section_enter_blocking(&bus->lock);
+        i2c_bus_start_next(bus);
+        idle = !bus->active;
+        critical_section_exit(&bus->lock);
+    }
+    else if (check == I2C_CHECK_PENDING)
+        finished = NULL;
+
+    // A notificação pode enfileirar novas transações, então ocorre fora da seção crítica
+    if (finished && finished->done)
+        finished->done(finished, finished->ctx);
+    return idle;
+}
+
+// Enfileira a transação e a conduz até o término (apenas no núcleo que chama i2c_bus_poll)
+bool i2c_bus_transfer(i2c_bus_t *bus, i2c_xfer_t *xfer)
+{
+    while (!i2c_bus_submit(bus, xfer))
+        i2c_bus_poll(bus); // Fila cheia: avança as pendências até abrir espaço
+    while (xfer->state == I2C_XFER_QUEUED || xfer->state == I2C_XFER_ACTIVE)
+        i2c_bus_poll(bus);
+    return xfer->state == I2C_XFER_DONE;
+}
+
+// Libera um barramento travado: pulsos de SCL até o dispositivo soltar SDA, STOP e reinício do controlador
+void i2c_bus_recover(i2c_bus_t *bus)
+{
+    // Os pinos passam a ser controlados por software em dreno aberto: saída em 0 puxa a linha, entrada a solta
+    gpio_set_function(bus->sda, GPIO_FUNC_SIO);
+    gpio_set_function(bus->scl, GPIO_FUNC_SIO);
+    gpio_set_dir(bus->sda, GPIO_IN);
+    gpio_set_dir(bus->scl, GPIO_IN);
+    gpio_put(bus->sda, 0);
+    gpio_put(bus->scl, 0);
+
+    // Até 9 pulsos completam o byte que o dispositivo estava enviando, até ele liberar SDA
+    for (uint8_t i = 0; i < 9 && !gpio_get(bus->sda); ++i)
+    {
+        gpio_set_dir(bus->scl, GPIO_OUT);
+        sleep_us(5);
+        gpio_set_dir(bus->scl, GPIO_IN);
+        sleep_us(5);
+    }
+
+    // STOP: SDA sobe com SCL em nível alto
+    gpio_set_dir(bus->scl, GPIO_OUT);
+    gpio_set_dir(bus->sda, GPIO_OUT);
+    sleep_us(5);
+    gpio_set_dir(bus->scl, GPIO_IN);
+    sleep_us(5);
+    gpio_set_dir(bus->sda, GPIO_IN);
+    sleep_us(5);
+
+    gpio_set_function(bus->sda, GPIO_FUNC_I2C);
+    gpio_set_function(bus->scl, GPIO_FUNC_I2C);
+    i2c_init(bus->i2c, bus->baudrate); // Reinicia o controlador, limpando as FIFOs e o estado de abort
+    bus->recoveries++;
+}
+
+// Nome da classe de prioridade (para as estatísticas)
+const char *i2c_bus_priority_name(i2c_priority_t priority)
+{
+    return priority < I2C_PRIO_COUNT ? priority_names[priority] : "?";
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "pico/stdlib.h"
+#include "pico/critical_section.h"
+#include "hardware/i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define I2C_BUS_QUEUE_SIZE 16        // Transações pendentes por classe de prioridade (potência de 2)
+#define I2C_BUS_RX_MAX 16            // Maior leitura por transação (profundidade da FIFO de recepção)
+#define I2C_BUS_HIST_BINS 16         // Faixas do histograma de latência (potências de 2 em µs)
+#define I2C_BUS_FAST_PLUS 1000000    // Fast-mode Plus
+#define I2C_BUS_FAST 400000          // Fast-mode (recuo quando o Fast-mode Plus falha)
+#define I2C_BUS_FALLBACK_ERRORS 3    // Falhas seguidas em Fast-mode Plus antes de recuar para Fast-mode
+#define I2C_BUS_TIMEOUT_US 2000      // Folga além do tempo previsto antes de considerar o barramento travado
+
+// Classes de prioridade: a cada transação concluída, a próxima vem da classe mais urgente com pendências
+typedef enum
+{
+    I2C_PRIO_URGENT, // Leituras de sensores com prazo
+    I2C_PRIO_NORMAL, // Comandos e leituras sem prazo rígido
+    I2C_PRIO_BULK,   // Transferências longas, como os quadros do display (enviados página a página)
+    I2C_PRIO_COUNT
+} i2c_priority_t;
+
+// Estado de uma transação
+typedef enum
+{
+    I2C_XFER_IDLE,   // Não enfileirada
+    I2C_XFER_QUEUED, // Aguardando o barramento
+    I2C_XFER_ACTIVE, // Em andamento
+    I2C_XFER_DONE,   // Concluída
+    I2C_XFER_FAILED, // Sem resposta do dispositivo ou barramento travado
+} i2c_xfer_state_t;
+
+// Transação no formato do registrador IC_DATA_CMD: cada palavra é um byte a escrever ou um comando de
+// leitura (I2C_IC_DATA_CMD_CMD_BITS), e a última leva o bit de STOP. As palavras e rx devem permanecer
+// válidos até o término.
+typedef struct i2c_xfer
+{
+    const uint16_t *words;    // Palavras enviadas ao controlador por DMA
+    uint16_t count;           // Número de palavras
+    uint8_t *rx;              // Destino dos bytes lidos (NULL se não houver leitura)
+    uint8_t rx_len;           // Bytes a ler (até I2C_BUS_RX_MAX)
+    uint8_t rx_done;          // Bytes já lidos
+    uint8_t address;          // Endereço de 7 bits do dispositivo
+    uint8_t priority;         // Classe de prioridade (i2c_priority_t)
+    volatile uint8_t state;   // Estado atual (i2c_xfer_state_t)
+    uint32_t queued_us;       // Instante em que foi enfileirada
+    void (*done)(struct i2c_xfer *xfer, void *ctx); // Chamada ao término (sucesso ou falha), fora da seção crítica
+    void *ctx;
+} i2c_xfer_t;
+
+// Barramento compartilhado: filas por prioridade atendidas uma transação por vez via DMA
+typedef struct
+{
+    i2c_inst_t *i2c;
+    uint sda, scl;        // Pinos, usados para destravar o barramento
+    uint32_t baudrate;    // Frequência atual
+    int dma_channel;      // Canal que alimenta a FIFO de transmissão
+    critical_section_t lock; // Protege as filas e a transação ativa (submissões de ambos os núcleos)
+
+    i2c_xfer_t *queue[I2C_PRIO_COUNT][I2C_BUS_QUEUE_SIZE];
+    uint32_t head[I2C_PRIO_COUNT], tail[I2C_PRIO_COUNT];
+    i2c_xfer_t *active;   // Transação em andamento (NULL se o barramento estiver livre)
+    uint32_t deadline_us; // Prazo da transação ativa antes de considerar o barramento travado
+    uint8_t errors;       // Falhas seguidas (para o recuo de frequência)
+
+    // Estatísticas
+    uint32_t completed[I2C_PRIO_COUNT];   // Transações concluídas por classe
+    uint32_t bytes;                       // Bytes das transações concluídas (incluindo o endereço)
+    uint32_t failed;                      // Transações com falha
+    uint32_t rejected;                    // Submissões recusadas por fila cheia
+    uint32_t recoveries;                  // Vezes em que o barramento foi destravado
+    uint32_t fallbacks;                   // Recuos de Fast-mode Plus para Fast-mode
+    uint32_t latency_max_us[I2C_PRIO_COUNT];                   // Maior atraso entre a submissão e o término
+    uint32_t latency_hist[I2C_PRIO_COUNT][I2C_BUS_HIST_BINS]; // Faixa b: atrasos em [2^b, 2^(b+1)) µs
+} i2c_bus_t;
+
+// Inicializa o controlador na frequência pedida (até I2C_BUS_FAST_PLUS) e destrava o barramento se necessário
+// Os pinos já devem estar na função I2C com pull-up; retorna false se não houver canal de DMA livre
+bool i2c_bus_init(i2c_bus_t *bus, i2c_inst_t *i2c, uint sda, uint scl, uint32_t baudrate);
+
+// Prepara uma transação com palavras já codificadas
+void i2c_xfer_init(i2c_xfer_t *xfer, uint8_t address, i2c_priority_t priority, const uint16_t *words, uint16_t count);
+
+// Codifica em words a escrita de tx seguida da leitura de rx_len bytes (com RESTART); retorna o número de palavras
+uint16_t i2c_bus_encode(uint16_t *words, const uint8_t *tx, uint16_t tx_len, uint8_t rx_len);
+
+// Enfileira a transação (qualquer núcleo); retorna false se a fila da classe estiver cheia
+bool i2c_bus_submit(i2c_bus_t *bus, i2c_xfer_t *xfer);
+
+// Acompanha a transação ativa e inicia a próxima; deve ser chamada continuamente por um único núcleo
+// Retorna true quando o barramento está livre e não há pendências
+bool i2c_bus_poll(i2c_bus_t *bus);
+
+// Enfileira a transação e a conduz até o término (apenas no núcleo que chama i2c_bus_poll)
+bool i2c_bus_transfer(i2c_bus_t *bus, i2c_xfer_t *xfer);
+
+// Libera um barramento travado: pulsos de SCL até o dispositivo soltar SDA, STOP e reinício do controlador
+void i2c_bus_recover(i2c_bus_t *bus);
+
+// Nome da classe de prioridade (para as estatísticas)
+const char *i2c_bus_priority_name(i2c_priority_t priority);
+
+#ifdef __cplusplus
+}
+#endif
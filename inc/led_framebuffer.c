@@ -0,0 +1,155 @@
+#include <string.h>
+#include "led_framebuffer.h"
+
+// Aloca o framebuffer apagado e calcula o mapa de coordenadas (retorna false se não houver memória)
+bool led_fb_init(led_fb_t *fb, uint width, uint height, led_map_t map)
+{
+    fb->width = width;
+    fb->height = height;
+    fb->count = width * height;
+    fb->layout = map;
+    if (fb->count > UINT16_MAX + 1)
+        return false; // O mapa usa índices de 16 bits
+
+    fb->pixels = calloc(fb->count, sizeof(uint32_t));
+    fb->map = malloc(fb->count * sizeof(uint16_t));
+    if (!fb->pixels || !fb->map)
+    {
+        led_fb_free(fb);
+        return false;
+    }
+
+    for (uint y = 0; y < height; ++y)
+    {
+        for (uint x = 0; x < width; ++x)
+        {
+            uint index;
+            switch (map)
+            {
+            case LED_MAP_SERPENTINE:
+                index = y * width + ((y & 1) ? width - 1 - x : x);
+                break;
+            case LED_MAP_COLUMNS:
+                index = x * height + y;
+                break;
+            default:
+                index = y * width + x;
+                break;
+            }
+            fb->map[y * width + x] = index;
+        }
+    }
+    return true;
+}
+
+// Libera a memória do framebuffer
+void led_fb_free(led_fb_t *fb)
+{
+    free(fb->pixels);
+    free(fb->map);
+    fb->pixels = NULL;
+    fb->map = NULL;
+    fb->count = 0;
+}
+
+// Preenche todos os LEDs com uma cor
+void led_fb_fill(led_fb_t *fb, uint32_t color)
+{
+    if (!color)
+    {
+        memset(fb->pixels, 0, fb->count * sizeof(uint32_t));
+        return;
+    }
+
+    uint32_t *p = fb->pixels, *end = p + fb->count;
+    while (p < end)
+        *p++ = color;
+}
+
+// Copia um padrão de 1 bit para a posição (x0, y0), recortando a parte fora da matriz
+void led_fb_blit(led_fb_t *fb, const uint32_t *bits, int x0, int y0, uint w, uint h, uint32_t on, uint32_t off)
+{
+    // Recorte: intervalo do padrão que cai dentro da matriz
+    uint sx0 = x0 < 0 ? -x0 : 0, sy0 = y0 < 0 ? -y0 : 0;
+    uint sx1 = w, sy1 = h;
+    if (x0 + (int)sx1 > (int)fb->width)
+        sx1 = x0 < (int)fb->width ? fb->width - x0 : 0;
+    if (y0 + (int)sy1 > (int)fb->height)
+        sy1 = y0 < (int)fb->height ? fb->height - y0 : 0;
+    if (sx0 >= sx1 || sy0 >= sy1)
+        return;
+
+    for (uint sy = sy0; sy < sy1; ++sy)
+    {
+        const uint16_t *map = &fb->map[(y0 + (int)sy) * (int)fb->width + x0 + (int)sx0]; // Primeira coluna visível
+        uint bit = sy * w + sx0;
+        uint32_t word = bits[bit >> 5] >> (bit & 31); // Uma leitura do padrão a cada 32 bits
+
+        for (uint sx = sx0; sx < sx1; ++sx, ++bit)
+        {
+            if (!(bit & 31))
+                word = bits[bit >> 5];
+            fb->pixels[*map++] = (word & 1) ? on : off;
+            word >>= 1;
+        }
+    }
+}
+
+// Preenche uma sequência de palavras com uma cor
+static void led_fb_fill_run(uint32_t *p, uint n, uint32_t color)
+{
+    while (n--)
+        *p++ = color;
+}
+
+// Desloca o conteúdo em (dx, dy); as posições descobertas recebem fill
+void led_fb_scroll(led_fb_t *fb, int dx, int dy, uint32_t fill)
+{
+    int width = fb->width, height = fb->height;
+    if (dx >= width || -dx >= width || dy >= height || -dy >= height)
+    {
+        led_fb_fill(fb, fill);
+        return;
+    }
+
+    uint32_t *pixels = fb->pixels;
+    uint keep = width - abs(dx); // Colunas preservadas em cada linha
+
+    // Ordem física igual à lógica: cada linha é uma cópia contínua de palavras
+    if (fb->layout == LED_MAP_ROWS)
+    {
+        int first = dy > 0 ? height - 1 : 0, last = dy > 0 ? -1 : height, step = dy > 0 ? -1 : 1;
+        for (int y = first; y != last; y += step)
+        {
+            uint32_t *row = &pixels[y * width];
+            int sy = y - dy;
+            if (sy < 0 || sy >= height)
+            {
+                led_fb_fill_run(row, width, fill);
+                continue;
+            }
+            const uint32_t *src = &pixels[sy * width];
+            memmove(row + (dx > 0 ? dx : 0), src + (dx < 0 ? -dx : 0), keep * sizeof(uint32_t));
+            led_fb_fill_run(dx > 0 ? row : row + keep, abs(dx), fill);
+        }
+        return;
+    }
+
+    // Outras ordens: em coordenadas lógicas, o destino i recebe a origem i - offset. Percorrendo no sentido do
+    // deslocamento, cada origem é lida antes de ser sobrescrita, independentemente da ordem física da cadeia
+    int offset = dy * width + dx;
+    int step = offset > 0 ? -1 : 1;
+    int y_first = offset > 0 ? height - 1 : 0, x_first = offset > 0 ? width - 1 : 0;
+    const uint16_t *map = fb->map;
+
+    for (int y = y_first, i = y_first * width + x_first; y >= 0 && y < height; y += step)
+    {
+        int sy = y - dy;
+        for (int x = x_first; x >= 0 && x < width; x += step, i += step)
+        {
+            int sx = x - dx;
+            bool inside = sy >= 0 && sy < height && sx >= 0 && sx < width;
+            pixels[map[i]] = inside ? pixels[map[i - offset]] : fill;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+// Ordem física dos LEDs na cadeia em relação às coordenadas (x, y), com (0, 0) no primeiro LED
+typedef enum
+{
+    LED_MAP_ROWS,       // Linha a linha, sempre da esquerda para a direita
+    LED_MAP_SERPENTINE, // Linha a linha, alternando o sentido (linhas ímpares da direita para a esquerda)
+    LED_MAP_COLUMNS,    // Coluna a coluna, sempre de cima para baixo
+} led_map_t;
+
+// Framebuffer de uma matriz de LEDs, dimensionado na inicialização
+typedef struct
+{
+    uint width, height, count;
+    uint32_t *pixels; // Cores na ordem da cadeia, já no formato da FIFO (G << 24 | R << 16 | B << 8 | W); pode ir direto ao DMA
+    uint16_t *map;    // Índice na cadeia de cada coordenada (y * width + x)
+    led_map_t layout; // Ordem física usada para calcular o mapa
+} led_fb_t;
+
+// Cor no formato da FIFO (o byte menos significativo é o branco, usado apenas em fitas RGBW com deslocamento de 32 bits)
+static inline uint32_t led_color(uint8_t r, uint8_t g, uint8_t b)
+{
+    return ((uint32_t)g << 24) | ((uint32_t)r << 16) | ((uint32_t)b << 8);
+}
+
+static inline uint32_t led_color_w(uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+{
+    return led_color(r, g, b) | w;
+}
+
+// Aloca o framebuffer apagado e calcula o mapa de coordenadas (retorna false se não houver memória)
+bool led_fb_init(led_fb_t *fb, uint width, uint height, led_map_t map);
+
+// Libera a memória do framebuffer
+void led_fb_free(led_fb_t *fb);
+
+// Define a cor de um LED (coordenadas fora da matriz são ignoradas)
+static inline void led_fb_set(led_fb_t *fb, uint x, uint y, uint32_t color)
+{
+    if (x < fb->width && y < fb->height)
+        fb->pixels[fb->map[y * fb->width + x]] = color;
+}
+
+// Retorna a cor de um LED (0 fora da matriz)
+static inline uint32_t led_fb_get(const led_fb_t *fb, uint x, uint y)
+{
+    return (x < fb->width && y < fb->height) ? fb->pixels[fb->map[y * fb->width + x]] : 0;
+}
+
+// Preenche todos os LEDs com uma cor
+void led_fb_fill(led_fb_t *fb, uint32_t color);
+
+// Copia um padrão de 1 bit (w x h, bit y * w + x a partir do menos significativo de cada palavra)
+// para a posição (x0, y0): bits 1 recebem on e bits 0 recebem off; a parte fora da matriz é recortada
+void led_fb_blit(led_fb_t *fb, const uint32_t *bits, int x0, int y0, uint w, uint h, uint32_t on, uint32_t off);
+
+// Desloca o conteúdo em (dx, dy); as posições descobertas recebem fill
+void led_fb_scroll(led_fb_t *fb, int dx, int dy, uint32_t fill);
@@ -0,0 +1,108 @@
+// Tabela de quadros da matriz de LEDs gerada em tempo de compilação
+// Cada quadro já está no formato da FIFO da PIO e é enviado pelo DMA diretamente da flash
+
+#include <array>
+#include <cstdint>
+#include "led_frames.h"
+
+namespace
+{
+
+using frame_t = std::array<uint32_t, LED_MTX_COUNT>;
+using table_t = std::array<std::array<frame_t, LED_FRAME_MODES>, LED_FRAME_DIGITS>;
+
+// Padrões de 25 bits dos números (bit i aceso = LED i aceso)
+constexpr uint32_t led_number_pattern[LED_FRAME_DIGITS] = {
+    0xe5294e, // Número 0
+    0x435084, // Número 1
+    0xe4384e, // Número 2
+    0xe4390e, // Número 3
+    0xa53902, // Número 4
+    0xe1390e, // Número 5
+    0xe4394e, // Número 6
+    0xe40902, // Número 7
+    0xe5394e, // Número 8
+    0xe5390e  // Número 9
+};
+
+// Formatação do valor GRB
+constexpr uint32_t grb(uint8_t r, uint8_t g, uint8_t b)
+{
+    return (uint32_t(g) << 24) | (uint32_t(r) << 16) | (uint32_t(b) << 8);
+}
+
+// Quadro de um padrão na cor do modo: vermelho com os dois LEDs apagados; caso contrário, verde e/ou azul
+constexpr frame_t make_frame(uint32_t pattern, unsigned mode)
+{
+    bool green = mode & 1, blue = mode & 2;
+    uint32_t color = grb(LED_MTX_LEVEL * (!green && !blue), LED_MTX_LEVEL * green, LED_MTX_LEVEL * blue);
+
+    frame_t frame{};
+    for (unsigned i = 0; i < LED_MTX_COUNT; ++i)
+        frame[i] = ((pattern >> i) & 1) ? color : 0;
+    return frame;
+}
+
+constexpr table_t make_table()
+{
+    table_t table{};
+    for (unsigned digit = 0; digit < LED_FRAME_DIGITS; ++digit)
+        for (unsigned mode = 0; mode < LED_FRAME_MODES; ++mode)
+            table[digit][mode] = make_frame(led_number_pattern[digit], mode);
+    return table;
+}
+
+constexpr table_t led_frames = make_table();
+
+// Reprodução do caminho anterior, calculado em tempo de execução a cada troca de número:
+// set_led_by_pattern -> apply_led_pattern (led_t por LED) -> write_leds (rgb_value por LED)
+struct led_t
+{
+    uint8_t G, R, B;
+};
+
+constexpr uint32_t rgb_value(uint8_t B, uint8_t R, uint8_t G)
+{
+    return (G << 24) | (R << 16) | (B << 8);
+}
+
+constexpr bool matches_runtime_path()
+{
+    for (unsigned digit = 0; digit < LED_FRAME_DIGITS; ++digit)
+    {
+        for (unsigned mode = 0; mode < LED_FRAME_MODES; ++mode)
+        {
+            bool green_led_on = mode & 1, blue_led_on = mode & 2;
+            unsigned lvl = LED_MTX_LEVEL;
+            uint8_t R = lvl * (!blue_led_on && !green_led_on), G = lvl * green_led_on, B = lvl * blue_led_on;
+
+            led_t led_matrix[LED_MTX_COUNT]{};
+            for (unsigned i = 0; i < LED_MTX_COUNT; i++)
+            {
+                if ((led_number_pattern[digit] >> i) & 1)
+                    led_matrix[i] = {G, R, B};
+                else
+                    led_matrix[i] = {0, 0, 0};
+            }
+
+            for (unsigned i = 0; i < LED_MTX_COUNT; ++i)
+                if (led_frames[digit][mode][i] != rgb_value(led_matrix[i].B, led_matrix[i].R, led_matrix[i].G))
+                    return false;
+        }
+    }
+    return true;
+}
+
+// A tabela deve ser idêntica, bit a bit, aos quadros montados pelo caminho anterior
+static_assert(matches_runtime_path(), "tabela de quadros difere do caminho em tempo de execucao");
+static_assert(led_frames[1][0][2] == uint32_t(LED_MTX_LEVEL) << 16, "número 1, LED 2: vermelho");
+static_assert(led_frames[1][3][2] == ((uint32_t(LED_MTX_LEVEL) << 24) | (uint32_t(LED_MTX_LEVEL) << 8)), "número 1, LED 2: verde e azul");
+static_assert(led_frames[1][1][0] == 0, "número 1, LED 0: apagado");
+
+} // namespace
+
+// Quadro GRB pronto para a FIFO da PIO (LED_MTX_COUNT palavras, em flash) para um número e um modo de cor
+const uint32_t *led_frame(unsigned digit, unsigned mode)
+{
+    return led_frames[digit % LED_FRAME_DIGITS][mode % LED_FRAME_MODES].data();
+}
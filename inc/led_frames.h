@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Definições para uso dos LEDs na Matriz 5x5
+#define LED_MTX_COUNT 25
+#define LED_MTX_LEVEL 20 // A intensidade está baixa para não causar incômodo (0-255, caso deseje alterar)
+
+#define LED_FRAME_DIGITS 10 // Números exibidos na matriz (0 a 9)
+#define LED_FRAME_MODES 4   // Combinações dos LEDs verde e azul (bit 0: verde, bit 1: azul)
+
+// Modo de cor correspondente ao estado dos LEDs verde e azul
+static inline unsigned led_frame_mode(bool green, bool blue)
+{
+    return (green ? 1u : 0u) | (blue ? 2u : 0u);
+}
+
+// Quadro GRB pronto para a FIFO da PIO (LED_MTX_COUNT palavras, em flash) para um número e um modo de cor
+const uint32_t *led_frame(unsigned digit, unsigned mode);
+
+#ifdef __cplusplus
+}
+#endif
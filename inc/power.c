@@ -0,0 +1,152 @@
+#include <string.h>
+#include "power.h"
+#include "hardware/sync.h"
+#include "hardware/irq.h"
+#include "hardware/regs/m0plus.h"
+
+static const char *const state_names[] = {"ativo", "reduzido", "desligado"};
+static const char *const wake_names[] = {"timer", "usb", "gpio", "dma", "fifo", "outra"};
+
+// Interrupções de cada origem no NVIC
+static const uint32_t wake_masks[POWER_WAKE_OTHER] = {
+    [POWER_WAKE_TIMER] = 1u << TIMER_IRQ_0 | 1u << TIMER_IRQ_1 | 1u << TIMER_IRQ_2 | 1u << TIMER_IRQ_3,
+    [POWER_WAKE_USB] = 1u << USBCTRL_IRQ,
+    [POWER_WAKE_GPIO] = 1u << IO_IRQ_BANK0,
+    [POWER_WAKE_DMA] = 1u << DMA_IRQ_0 | 1u << DMA_IRQ_1,
+    [POWER_WAKE_FIFO] = 1u << SIO_IRQ_PROC0,
+};
+
+// Alarme do próximo estágio: basta interromper o __wfi; o laço principal decide o que fazer
+static int64_t power_alarm(alarm_id_t id, void *user_data)
+{
+    power_t *pw = user_data;
+    pw->alarm = 0;
+    return 0;
+}
+
+// Inicia a política no estágio ativo
+void power_init(power_t *pw, uint32_t dim_ms, uint32_t off_ms)
+{
+    memset(pw, 0, sizeof(*pw));
+    pw->dim_us = dim_ms * 1000;
+    pw->off_us = off_ms * 1000;
+    pw->last_input_us = time_us_64();
+    pw->awake_since_us = pw->last_input_us;
+    pw->window_us = pw->last_input_us;
+}
+
+// Registra uma entrada; retorna o estágio anterior (diferente de POWER_ACTIVE se as saídas devem ser restauradas)
+power_state_t power_input(power_t *pw)
+{
+    power_state_t previous = pw->state;
+    pw->last_input_us = time_us_64();
+    if (previous != POWER_ACTIVE)
+    {
+        pw->state = POWER_ACTIVE;
+        pw->transitions++;
+    }
+    // Um alarme já agendado dispara antes do novo prazo e apenas é reagendado em power_update
+    return previous;
+}
+
+// Avança os estágios conforme o tempo sem entradas e agenda o alarme do próximo; retorna true se o estágio mudou
+bool power_update(power_t *pw)
+{
+    uint64_t idle = time_us_64() - pw->last_input_us;
+    uint8_t state = POWER_ACTIVE;
+    if (pw->off_us && idle >= pw->off_us)
+        state = POWER_OFF;
+    else if (pw->dim_us && idle >= pw->dim_us)
+        state = POWER_DIM;
+
+    bool changed = state != pw->state;
+    if (changed)
+    {
+        pw->state = state;
+        pw->transitions++;
+    }
+
+    // Prazo do próximo estágio, contado da última entrada
+    uint32_t next = 0;
+    if (state == POWER_ACTIVE && pw->dim_us)
+        next = pw->dim_us;
+    else if (state != POWER_OFF && pw->off_us)
+        next = pw->off_us;
+    if (next && !pw->alarm)
+    {
+        // O alarme é atendido por este núcleo: mascarado, ele não dispara antes de o identificador ser guardado
+        uint32_t irq = save_and_disable_interrupts();
+        alarm_id_t id = add_alarm_in_us(next > idle ? next - idle : 0, power_alarm, pw, true);
+        pw->alarm = id > 0 ? id : 0;
+        restore_interrupts(irq);
+    }
+    return changed;
+}
+
+// Dorme em __wfi até a próxima interrupção, a menos que busy indique trabalho pendente
+void power_sleep(power_t *pw, bool (*busy)(void))
+{
+    // Com as interrupções mascaradas, uma que chegue depois da verificação ainda acorda o __wfi,
+    // e é atendida logo após restore_interrupts
+    uint32_t irq = save_and_disable_interrupts();
+    if (busy && busy())
+    {
+        restore_interrupts(irq);
+        return;
+    }
+
+    pw->active_us += time_us_64() - pw->awake_since_us;
+    __wfi();
+    pw->awake_since_us = time_us_64();
+    pw->wakeups++;
+
+    // Ainda mascarada, a interrupção que acordou o núcleo continua pendente no NVIC
+    uint32_t pending = *(volatile uint32_t *)(PPB_BASE + M0PLUS_NVIC_ISPR_OFFSET);
+    bool known = false;
+    for (uint i = 0; i < POWER_WAKE_OTHER; ++i)
+        if (pending & wake_masks[i])
+        {
+            pw->wake_sources[i]++;
+            known = true;
+        }
+    if (!known)
+        pw->wake_sources[POWER_WAKE_OTHER]++;
+    restore_interrupts(irq);
+}
+
+// Calcula as taxas desde o último relatório (bytes: total acumulado enviado aos periféricos) e inicia nova janela
+void power_report(power_t *pw, uint32_t bytes, power_report_t *report)
+{
+    uint64_t now = time_us_64();
+    uint64_t active = pw->active_us + (now - pw->awake_since_us); // O relatório é feito acordado
+    uint64_t window = now - pw->window_us;
+    if (!window)
+        window = 1;
+
+    report->window_ms = (uint32_t)(window / 1000);
+    report->wakeups_per_min = (uint32_t)((uint64_t)(pw->wakeups - pw->window_wakeups) * 60000000 / window);
+    for (uint i = 0; i < POWER_WAKE_SOURCES; ++i)
+    {
+        report->sources_per_min[i] = (uint32_t)((uint64_t)(pw->wake_sources[i] - pw->window_sources[i]) * 60000000 / window);
+        pw->window_sources[i] = pw->wake_sources[i];
+    }
+    report->active_permille = (uint32_t)((active - pw->window_active_us) * 1000 / window);
+    report->bytes_per_min = (uint32_t)((uint64_t)(bytes - pw->window_bytes) * 60000000 / window);
+
+    pw->window_us = now;
+    pw->window_wakeups = pw->wakeups;
+    pw->window_active_us = active;
+    pw->window_bytes = bytes;
+}
+
+// Nome do estágio (para as estatísticas)
+const char *power_state_name(power_state_t state)
+{
+    return state <= POWER_OFF ? state_names[state] : "?";
+}
+
+// Nome da origem de um despertar (para as estatísticas)
+const char *power_wake_name(power_wake_t source)
+{
+    return source < POWER_WAKE_SOURCES ? wake_names[source] : "?";
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POWER_DIM_MS 30000       // Sem entradas por este tempo, o contraste do display é reduzido (0 desativa)
+#define POWER_OFF_MS 120000      // Sem entradas por este tempo, o display é desligado e a matriz apagada (0 desativa)
+#define POWER_DIM_CONTRAST 0x08  // Contraste no estágio reduzido (o normal é o máximo, 0xFF)
+
+// Estágios de economia, do mais ativo ao mais econômico
+typedef enum
+{
+    POWER_ACTIVE, // Display e matriz normais
+    POWER_DIM,    // Contraste reduzido
+    POWER_OFF,    // Display desligado e matriz apagada
+} power_state_t;
+
+// Origem de um despertar: a interrupção pendente ao sair do __wfi (com várias, cada uma é contada)
+typedef enum
+{
+    POWER_WAKE_TIMER, // Alarmes e timers do SDK, inclusive a tarefa periódica do stdio USB
+    POWER_WAKE_USB,   // Controlador USB (stdio USB)
+    POWER_WAKE_GPIO,  // Botões
+    POWER_WAKE_DMA,   // Fim de transferência (display e matriz)
+    POWER_WAKE_FIFO,  // FIFO entre os núcleos
+    POWER_WAKE_OTHER, // Outra interrupção, ou nenhuma pendente
+    POWER_WAKE_SOURCES,
+} power_wake_t;
+
+// Política de economia do laço principal: dorme em __wfi até uma interrupção e avança os estágios
+// conforme o tempo sem entradas
+typedef struct
+{
+    uint32_t dim_us, off_us;     // Tempo sem entradas até cada estágio (0 desativa)
+    uint8_t state;               // Estágio atual (power_state_t)
+    uint64_t last_input_us;      // Última entrada (64 bits: o tempo de 32 bits dá a volta em ~71,6 minutos)
+    volatile alarm_id_t alarm;   // Alarme que acorda o laço no próximo estágio (0 se não houver)
+    uint64_t awake_since_us;     // Início do período acordado atual
+
+    // Contadores desde a inicialização
+    uint32_t wakeups;            // Saídas de __wfi
+    uint64_t active_us;          // Tempo acordado (fora de __wfi)
+    uint32_t transitions;        // Mudanças de estágio
+    uint32_t wake_sources[POWER_WAKE_SOURCES]; // Despertares por origem
+
+    // Início da janela das taxas (desde o último relatório)
+    uint64_t window_us;
+    uint32_t window_wakeups;
+    uint32_t window_sources[POWER_WAKE_SOURCES];
+    uint64_t window_active_us;
+    uint32_t window_bytes;
+} power_t;
+
+// Taxas medidas em uma janela
+typedef struct
+{
+    uint32_t window_ms;        // Duração da janela
+    uint32_t wakeups_per_min;  // Despertares por minuto
+    uint32_t sources_per_min[POWER_WAKE_SOURCES]; // Despertares por minuto de cada origem
+    uint32_t active_permille;  // Fração do tempo acordado, em milésimos
+    uint32_t bytes_per_min;    // Bytes enviados aos periféricos por minuto
+} power_report_t;
+
+// Inicia a política no estágio ativo
+void power_init(power_t *pw, uint32_t dim_ms, uint32_t off_ms);
+
+// Registra uma entrada; retorna o estágio anterior (diferente de POWER_ACTIVE se as saídas devem ser restauradas)
+power_state_t power_input(power_t *pw);
+
+// Avança os estágios conforme o tempo sem entradas e agenda o alarme do próximo; retorna true se o estágio mudou
+bool power_update(power_t *pw);
+
+// Dorme em __wfi até a próxima interrupção, a menos que busy indique trabalho pendente
+void power_sleep(power_t *pw, bool (*busy)(void));
+
+// Calcula as taxas desde o último relatório (bytes: total acumulado enviado aos periféricos) e inicia nova janela
+void power_report(power_t *pw, uint32_t bytes, power_report_t *report);
+
+// Nome do estágio (para as estatísticas)
+const char *power_state_name(power_state_t state);
+
+// Nome da origem de um despertar (para as estatísticas)
+const char *power_wake_name(power_wake_t source);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,136 @@
+#include <string.h>
+#include "protocol.h"
+
+// Campos do quadro, na ordem em que chegam
+enum
+{
+    STATE_SYNC0, // Fora de um quadro
+    STATE_SYNC1,
+    STATE_TYPE,
+    STATE_SEQ,
+    STATE_LEN_LO,
+    STATE_LEN_HI,
+    STATE_PAYLOAD,
+    STATE_CRC_LO,
+    STATE_CRC_HI,
+};
+
+// CRC-16 (CCITT) processado meio byte por vez: tabela de 16 entradas em vez de 256
+static const uint16_t crc_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+// Atualiza o CRC-16 (CCITT) com um byte
+uint16_t proto_crc16(uint16_t crc, uint8_t byte)
+{
+    crc = (crc << 4) ^ crc_nibble[(crc >> 12) ^ (byte >> 4)];
+    crc = (crc << 4) ^ crc_nibble[(crc >> 12) ^ (byte & 0x0F)];
+    return crc;
+}
+
+// Prepara o receptor
+void proto_init(proto_parser_t *parser, const proto_handler_t *handler, void *ctx)
+{
+    memset(parser, 0, sizeof(*parser));
+    parser->handler = handler;
+    parser->ctx = ctx;
+}
+
+// Encerra o quadro em recepção e contabiliza o resultado
+static void proto_finish(proto_parser_t *parser, proto_status_t status)
+{
+    if (status == PROTO_OK && !parser->accepted)
+        status = PROTO_ERR_REJECTED; // Quadro íntegro, mas recusado pelo destino
+    status = parser->handler->end(parser->type, parser->seq, status, parser->ctx);
+    parser->frames[status]++;
+    parser->state = STATE_SYNC0;
+}
+
+// Cabeçalho completo: consulta o destino e segue para os dados (ou direto para o CRC)
+static void proto_begin(proto_parser_t *parser)
+{
+    parser->pos = 0;
+    parser->accepted = parser->handler->begin(parser->type, parser->length, parser->ctx);
+    parser->state = parser->length ? STATE_PAYLOAD : STATE_CRC_LO;
+}
+
+// Processa um byte; retorna false se ele não pertence a um quadro (texto comum)
+bool proto_feed(proto_parser_t *parser, uint8_t c)
+{
+    switch (parser->state)
+    {
+    case STATE_SYNC0:
+        if (c != PROTO_SYNC0)
+            return false;
+        parser->state = STATE_SYNC1;
+        break;
+    case STATE_SYNC1:
+        if (c == PROTO_SYNC0)
+            break; // Sincronismo repetido: o próximo byte ainda pode ser 0x5A
+        if (c != PROTO_SYNC1)
+        {
+            parser->state = STATE_SYNC0;
+            return false; // Não era um quadro: o byte segue como texto
+        }
+        parser->crc = 0xFFFF;
+        parser->state = STATE_TYPE;
+        break;
+    case STATE_TYPE:
+        parser->type = c;
+        parser->crc = proto_crc16(parser->crc, c);
+        parser->state = STATE_SEQ;
+        break;
+    case STATE_SEQ:
+        parser->seq = c;
+        parser->crc = proto_crc16(parser->crc, c);
+        parser->state = STATE_LEN_LO;
+        break;
+    case STATE_LEN_LO:
+        parser->length = c;
+        parser->crc = proto_crc16(parser->crc, c);
+        parser->state = STATE_LEN_HI;
+        break;
+    case STATE_LEN_HI:
+        parser->length |= (uint16_t)c << 8;
+        parser->crc = proto_crc16(parser->crc, c);
+        if (parser->length > PROTO_PAYLOAD_MAX)
+        {
+            // Comprimento impossível: provavelmente ruído, volta a procurar o sincronismo
+            proto_finish(parser, PROTO_ERR_REJECTED);
+            break;
+        }
+        proto_begin(parser);
+        break;
+    case STATE_PAYLOAD:
+        // Os dados vão direto ao destino final; um quadro com CRC inválido apenas não é aplicado
+        if (parser->accepted)
+            parser->handler->byte(parser->type, parser->pos, c, parser->ctx);
+        parser->crc = proto_crc16(parser->crc, c);
+        if (++parser->pos == parser->length)
+            parser->state = STATE_CRC_LO;
+        break;
+    case STATE_CRC_LO:
+        parser->crc_rx = c;
+        parser->state = STATE_CRC_HI;
+        break;
+    case STATE_CRC_HI:
+        parser->crc_rx |= (uint16_t)c << 8;
+        proto_finish(parser, parser->crc_rx == parser->crc ? PROTO_OK : PROTO_ERR_CRC);
+        break;
+    }
+    parser->bytes++;
+    return true;
+}
+
+// Abandona o quadro em recepção (o remetente ficou em silêncio por PROTO_BYTE_TIMEOUT_US)
+void proto_timeout(proto_parser_t *parser)
+{
+    if (parser->state > STATE_SEQ)
+        proto_finish(parser, PROTO_ERR_TIMEOUT); // A sequência já é conhecida: o remetente recebe a falha
+    else
+    {
+        parser->frames[PROTO_ERR_TIMEOUT]++;
+        parser->state = STATE_SYNC0;
+    }
+}
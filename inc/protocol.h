@@ -0,0 +1,95 @@
+#pragma once
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Quadro binário recebido pela USB (CDC), enviado por tools/frame_sender.py:
+//   0xA5 0x5A | tipo | sequência | comprimento (16 bits, little-endian) | dados | CRC-16 (little-endian)
+// O CRC (CCITT: polinômio 0x1021, valor inicial 0xFFFF) cobre do tipo ao último byte de dados.
+// Os bytes de texto (comandos do Serial Monitor) nunca começam com 0xA5 e seguem o caminho de sempre.
+#define PROTO_SYNC0 0xA5
+#define PROTO_SYNC1 0x5A
+#define PROTO_PAYLOAD_MAX 2048      // Maior comprimento aceito (acima disso o cabeçalho é tratado como ruído)
+#define PROTO_BYTE_TIMEOUT_US 5000  // Silêncio no meio de um quadro que faz o receptor desistir dele
+
+// Tipos de mensagem
+typedef enum
+{
+    PROTO_OLED_FRAME = 0x01, // Quadro inteiro do display, no layout do ram_buffer (coluna a coluna, páginas em sequência)
+    PROTO_OLED_PATCH = 0x02, // Janela do display: x0, página 0, x1, página 1 e os bytes da janela na mesma ordem
+    PROTO_LED_FRAME = 0x03,  // Quadro da matriz: G, R, B por LED, na ordem da cadeia
+    PROTO_CONTROL = 0x10,    // Comando: código (proto_control_t) e argumento
+} proto_type_t;
+
+// Comandos de controle
+typedef enum
+{
+    PROTO_CTRL_PING,     // Apenas confirma (medição de ida e volta)
+    PROTO_CTRL_CONTRAST, // Contraste do display
+    PROTO_CTRL_INVERT,   // Display invertido (argumento 1) ou normal (0)
+    PROTO_CTRL_POWER,    // Display ligado (argumento 1) ou desligado (0)
+} proto_control_t;
+
+// Resultado de um quadro, informado na confirmação
+typedef enum
+{
+    PROTO_OK,           // Quadro aplicado
+    PROTO_ERR_CRC,      // CRC não confere
+    PROTO_ERR_REJECTED, // Tipo desconhecido ou comprimento inválido para o tipo
+    PROTO_ERR_TIMEOUT,  // Quadro interrompido
+} proto_status_t;
+
+struct proto_parser;
+
+// Destino dos quadros: os dados são entregues byte a byte, já na posição final, enquanto o CRC é calculado
+typedef struct
+{
+    // Início dos dados; retorna false para descartar o quadro (os bytes ainda são consumidos até o CRC)
+    bool (*begin)(uint8_t type, uint16_t length, void *ctx);
+    // Byte de dados na posição pos (apenas em quadros aceitos)
+    void (*byte)(uint8_t type, uint16_t pos, uint8_t value, void *ctx);
+    // Fim do quadro; com PROTO_OK o destino aplica os dados e retorna o resultado final
+    proto_status_t (*end)(uint8_t type, uint8_t seq, proto_status_t status, void *ctx);
+} proto_handler_t;
+
+// Receptor dos quadros: máquina de estados alimentada um byte por vez
+typedef struct proto_parser
+{
+    const proto_handler_t *handler;
+    void *ctx;
+    uint8_t state;      // Campo esperado
+    uint8_t type, seq;  // Cabeçalho do quadro em recepção
+    uint16_t length, pos;
+    uint16_t crc;       // CRC calculado até aqui
+    uint16_t crc_rx;    // CRC recebido
+    bool accepted;      // O destino aceitou os dados
+
+    // Estatísticas
+    uint32_t frames[PROTO_ERR_TIMEOUT + 1]; // Quadros por resultado (proto_status_t)
+    uint32_t bytes;                         // Bytes consumidos pelo protocolo
+} proto_parser_t;
+
+// Prepara o receptor
+void proto_init(proto_parser_t *parser, const proto_handler_t *handler, void *ctx);
+
+// Processa um byte; retorna false se ele não pertence a um quadro (texto comum)
+bool proto_feed(proto_parser_t *parser, uint8_t c);
+
+// Indica se há um quadro em recepção
+static inline bool proto_busy(const proto_parser_t *parser)
+{
+    return parser->state != 0;
+}
+
+// Abandona o quadro em recepção (o remetente ficou em silêncio por PROTO_BYTE_TIMEOUT_US)
+void proto_timeout(proto_parser_t *parser);
+
+// Atualiza o CRC-16 (CCITT) com um byte
+uint16_t proto_crc16(uint16_t crc, uint8_t byte);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,326 @@
+#include <string.h>
+#include "render.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+#include "trace.h"
+
+render_stats_t render_stats;
+frame_scheduler_t render_frames;
+
+// Fila circular sem travas: o núcleo 0 produz e o núcleo 1 consome
+static render_cmd_t queue[RENDER_QUEUE_SIZE];
+static volatile uint32_t queue_head = 0; // Alterado apenas pelo núcleo 0
+static volatile uint32_t queue_tail = 0; // Alterado apenas pelo núcleo 1
+
+static ssd1306_t *display;
+static ws2812_t *leds;
+static int oled_device, led_device;    // Índices dos dispositivos no escalonador
+static const uint32_t *volatile led_next = NULL;   // Último quadro solicitado à matriz
+static const uint32_t *volatile led_active = NULL; // Quadro sendo lido pelo DMA da matriz
+
+// Latência das entradas aguardando envio e do envio em andamento
+static uint32_t pending_since_us = 0;
+static uint32_t inflight_since_us = 0;
+
+// Enfileira um comando, aguardando espaço se a fila estiver cheia
+static void render_push(const render_cmd_t *cmd)
+{
+    uint32_t head = queue_head;
+    if (head - queue_tail == RENDER_QUEUE_SIZE)
+    {
+        render_stats.stalls++;
+        while (head - queue_tail == RENDER_QUEUE_SIZE)
+            tight_loop_contents(); // O núcleo 1 esvazia a fila rapidamente
+    }
+
+    queue[head & (RENDER_QUEUE_SIZE - 1)] = *cmd;
+    __dmb();               // O comando precisa estar visível antes do novo índice
+    queue_head = head + 1;
+    render_stats.sent++;
+    __sev();               // Acorda o núcleo 1 caso esteja aguardando em __wfe
+}
+
+// Remove o próximo comando da fila; retorna false se estiver vazia
+static bool render_pop(render_cmd_t *cmd)
+{
+    uint32_t tail = queue_tail;
+    if (tail == queue_head)
+        return false;
+
+    __dmb();
+    *cmd = queue[tail & (RENDER_QUEUE_SIZE - 1)];
+    __dmb();
+    queue_tail = tail + 1;
+    return true;
+}
+
+// Término de um envio ao display: contabiliza a duração do quadro e a latência da entrada que ele exibiu
+static void render_flushed(ssd1306_t *ssd)
+{
+    trace_end(TRACE_OLED_FRAME);
+    frame_scheduler_done(&render_frames, oled_device);
+    if (!inflight_since_us)
+        return;
+
+    uint32_t latency = time_us_32() - inflight_since_us;
+    if (latency > render_stats.latency_max_us)
+        render_stats.latency_max_us = latency;
+    render_stats.latency_total_us += latency;
+    render_stats.latency_count++;
+    inflight_since_us = 0;
+}
+
+// Término de um quadro da matriz de LEDs (executada em contexto de interrupção)
+static void render_led_done(ws2812_t *strip)
+{
+    led_active = NULL;
+    frame_scheduler_done(&render_frames, led_device);
+}
+
+// Quadro do display: envia as regiões alteradas, se o envio anterior já terminou
+static bool render_present_oled(void *ctx)
+{
+    if (!ssd1306_flush_poll(display))
+        return false;
+
+    render_stats.flushes++;
+    inflight_since_us = pending_since_us;
+    pending_since_us = 0;
+    trace_begin(TRACE_OLED_FRAME);
+    ssd1306_flush_start(display, false); // Sem regiões alteradas, termina sem tráfego no barramento
+    return true;
+}
+
+// Quadro da matriz de LEDs: envia o último quadro solicitado, se o anterior já foi exibido
+static bool render_present_leds(void *ctx)
+{
+    if (!ws2812_idle(leds))
+        return false;
+
+    led_active = led_next;
+    ws2812_show_frame(leds, led_next);
+    render_stats.led_bytes += leds->count * 3;
+    return true;
+}
+
+// Contabiliza a região alterada por uma atualização de widget
+static void render_ui_damage(ui_rect_t damage)
+{
+    render_stats.ui_updates++;
+    if (damage.empty)
+        return;
+    render_stats.ui_damaged++;
+    render_stats.ui_damage_px += (damage.x1 - damage.x0 + 1) * (damage.y1 - damage.y0 + 1);
+}
+
+// Executa um comando no núcleo 1
+static void render_execute(const render_cmd_t *cmd)
+{
+    trace_instant(TRACE_RENDER_CMD, cmd->op);
+    switch (cmd->op)
+    {
+    case RENDER_STRING:
+        ssd1306_draw_string(display, cmd->text, cmd->x, cmd->y);
+        break;
+    case RENDER_CHAR:
+        ssd1306_draw_char(display, cmd->text[0], cmd->x, cmd->y);
+        break;
+    case RENDER_ICON:
+        ssd1306_draw_icon(display, cmd->icon, cmd->x, cmd->y);
+        break;
+    case RENDER_UI_LABEL:
+        render_ui_damage(ui_label_set(display, cmd->widget, cmd->text));
+        break;
+    case RENDER_UI_ICON:
+        render_ui_damage(ui_icon_set(display, cmd->widget, cmd->icon));
+        break;
+    case RENDER_UI_NUMBER:
+        render_ui_damage(ui_number_set(display, cmd->widget, cmd->value));
+        break;
+    case RENDER_CONSOLE_LINE:
+        console_write_line(cmd->console, cmd->text);
+        break;
+    case RENDER_LED_FRAME:
+        if (cmd->frame != led_next)
+        {
+            led_next = cmd->frame; // Quadros repetidos não são reenviados
+            frame_scheduler_invalidate(&render_frames, led_device);
+        }
+        break;
+    case RENDER_OLED_SWAP:
+        ssd1306_swap_buffer(display, cmd->buffer);
+        ssd1306_set_start_line(display, 0); // O quadro recebido começa no topo da memória
+        ui_invalidate_all(); // Os widgets não estão no quadro recebido: a próxima atualização os redesenha inteiros
+        break;
+    case RENDER_OLED_PATCH:
+        ssd1306_copy_window(display, cmd->buffer, cmd->x, cmd->y, cmd->x1, cmd->page1);
+        ui_invalidate_all(); // A janela pode ter coberto um widget
+        break;
+    case RENDER_DISPLAY_CMD:
+    {
+        ssd1306_cmdlist_t list;
+        ssd1306_cmdlist_begin(&list);
+        for (uint8_t i = 0; i < cmd->x && i < sizeof(cmd->bytes); ++i)
+            ssd1306_cmdlist_add(display, &list, cmd->bytes[i]);
+        ssd1306_cmdlist_send(display, &list);
+        break;
+    }
+    case RENDER_FLUSH:
+        if (cmd->since_us && !pending_since_us)
+            pending_since_us = cmd->since_us; // Mantém a entrada mais antiga ainda não exibida
+        frame_scheduler_invalidate(&render_frames, oled_device);
+        break;
+    }
+}
+
+// Laço do núcleo 1: executa os comandos e, a cada tick do escalonador, envia os quadros alterados
+static void render_main()
+{
+    while (true)
+    {
+        render_cmd_t cmd;
+        while (render_pop(&cmd))
+        {
+            render_execute(&cmd);
+            render_stats.executed++;
+        }
+
+        frame_scheduler_run(&render_frames);
+
+        // O núcleo 1 conduz o barramento I2C compartilhado, se houver (display e demais dispositivos)
+        bool bus_idle = !display->bus || i2c_bus_poll(display->bus);
+
+        // Sem envio em andamento, dorme até o próximo tick, comando do núcleo 0 ou nova transação no barramento
+        if (ssd1306_flush_poll(display) && bus_idle && queue_tail == queue_head && !frame_scheduler_pending(&render_frames))
+            __wfe();
+    }
+}
+
+// Inicia o serviço no núcleo 1; a partir daqui apenas ele acessa o display e a matriz de LEDs
+void render_start(ssd1306_t *ssd, ws2812_t *strip)
+{
+    display = ssd;
+    leds = strip;
+    ssd1306_set_flush_callback(ssd, render_flushed);
+    ws2812_set_callback(strip, render_led_done);
+
+    // O timer é atendido pelo núcleo 0, que apenas sinaliza o tick ao núcleo 1
+    frame_scheduler_init(&render_frames, RENDER_TICK_US);
+    oled_device = frame_scheduler_add(&render_frames, "OLED", RENDER_OLED_FPS, render_present_oled, NULL);
+    led_device = frame_scheduler_add(&render_frames, "Matriz", RENDER_LED_FPS, render_present_leds, NULL);
+    multicore_launch_core1(render_main);
+}
+
+// Enfileira o desenho de uma string (truncada em RENDER_TEXT_MAX caracteres)
+void render_draw_string(const char *text, uint8_t x, uint8_t y)
+{
+    render_cmd_t cmd = {.op = RENDER_STRING, .x = x, .y = y};
+    strncpy(cmd.text, text, RENDER_TEXT_MAX);
+    cmd.text[RENDER_TEXT_MAX] = '\0';
+    render_push(&cmd);
+}
+
+// Enfileira o desenho de um caractere
+void render_draw_char(char c, uint8_t x, uint8_t y)
+{
+    render_cmd_t cmd = {.op = RENDER_CHAR, .x = x, .y = y};
+    cmd.text[0] = c;
+    render_push(&cmd);
+}
+
+// Enfileira o desenho de um ícone
+void render_draw_icon(uint8_t id, uint8_t x, uint8_t y)
+{
+    render_cmd_t cmd = {.op = RENDER_ICON, .x = x, .y = y};
+    cmd.icon = id;
+    render_push(&cmd);
+}
+
+// Enfileira a atualização de um rótulo (o widget passa a ser acessado pelo núcleo 1)
+void render_ui_label(ui_widget_t *widget, const char *text)
+{
+    render_cmd_t cmd = {.op = RENDER_UI_LABEL, .widget = widget};
+    strncpy(cmd.text, text, RENDER_TEXT_MAX);
+    cmd.text[RENDER_TEXT_MAX] = '\0';
+    render_push(&cmd);
+}
+
+// Enfileira a atualização de um ícone
+void render_ui_icon(ui_widget_t *widget, uint8_t id)
+{
+    render_cmd_t cmd = {.op = RENDER_UI_ICON, .widget = widget};
+    cmd.icon = id;
+    render_push(&cmd);
+}
+
+// Enfileira a atualização de um campo numérico
+void render_ui_number(ui_widget_t *widget, int32_t value)
+{
+    render_cmd_t cmd = {.op = RENDER_UI_NUMBER, .widget = widget};
+    cmd.value = value;
+    render_push(&cmd);
+}
+
+// Enfileira uma linha do console (o console passa a ser acessado pelo núcleo 1)
+void render_console_line(console_t *console, const char *text)
+{
+    render_cmd_t cmd = {.op = RENDER_CONSOLE_LINE, .console = console};
+    strncpy(cmd.text, text, RENDER_TEXT_MAX);
+    cmd.text[RENDER_TEXT_MAX] = '\0';
+    render_push(&cmd);
+}
+
+// Enfileira o envio de um quadro à matriz de LEDs (deve permanecer válido, p.ex. tabela em flash)
+void render_led_frame(const uint32_t *frame)
+{
+    render_cmd_t cmd = {.op = RENDER_LED_FRAME};
+    cmd.frame = frame;
+    render_push(&cmd);
+}
+
+// Enfileira a troca do buffer do display por buffer (quadro inteiro); o anterior é liberado quando render_drained
+void render_oled_swap(uint8_t *buffer)
+{
+    render_cmd_t cmd = {.op = RENDER_OLED_SWAP, .buffer = buffer};
+    render_push(&cmd);
+}
+
+// Enfileira a cópia da janela (x0..x1, páginas page0..page1) de buffer para o display
+void render_oled_patch(uint8_t *buffer, uint8_t x0, uint8_t page0, uint8_t x1, uint8_t page1)
+{
+    render_cmd_t cmd = {.op = RENDER_OLED_PATCH, .x = x0, .y = page0, .buffer = buffer};
+    cmd.x1 = x1;
+    cmd.page1 = page1;
+    render_push(&cmd);
+}
+
+// Enfileira até 4 bytes de comando ao display
+void render_display_command(const uint8_t *bytes, uint8_t count)
+{
+    render_cmd_t cmd = {.op = RENDER_DISPLAY_CMD};
+    cmd.x = count < sizeof(cmd.bytes) ? count : sizeof(cmd.bytes);
+    memcpy(cmd.bytes, bytes, cmd.x);
+    render_push(&cmd);
+}
+
+// Confirma as alterações enfileiradas até aqui; o display é atualizado no próximo quadro do escalonador
+void render_flush(uint32_t since_us)
+{
+    render_cmd_t cmd = {.op = RENDER_FLUSH};
+    cmd.since_us = since_us;
+    render_push(&cmd);
+}
+
+// Indica se o núcleo 1 já executou todos os comandos enviados
+bool render_drained(void)
+{
+    // executed só avança depois da execução, ao contrário do índice da fila
+    return render_stats.executed == render_stats.sent;
+}
+
+// Indica se o quadro da matriz pode ser reescrito: nenhum comando pendente o referencia e o DMA não o está lendo
+bool render_led_released(const uint32_t *frame)
+{
+    // Com a fila executada, led_next já é o quadro mais recente, e apenas ele pode voltar ao DMA
+    return render_drained() && led_next != frame && led_active != frame;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+#include "ws2812.h"
+#include "frame_scheduler.h"
+#include "ui.h"
+#include "console.h"
+
+#define RENDER_QUEUE_SIZE 64 // Capacidade da fila de comandos entre os núcleos (potência de 2)
+#define RENDER_TEXT_MAX 16   // Tamanho máximo de uma string em um único comando (uma linha do console)
+
+// Cadência dos quadros
+#define RENDER_TICK_US 5000  // Período do timer do escalonador de quadros
+#define RENDER_OLED_FPS 50   // Limite de quadros por segundo do display
+#define RENDER_LED_FPS 100   // Limite de quadros por segundo da matriz de LEDs
+
+// Operações executadas pelo serviço de renderização
+typedef enum
+{
+    RENDER_STRING,      // Desenha uma string no display
+    RENDER_CHAR,        // Desenha um caractere no display
+    RENDER_ICON,        // Desenha um ícone no display
+    RENDER_UI_LABEL,    // Atualiza o texto de um rótulo
+    RENDER_UI_ICON,     // Atualiza um ícone
+    RENDER_UI_NUMBER,   // Atualiza um campo numérico
+    RENDER_CONSOLE_LINE, // Acrescenta uma linha ao console rolante
+    RENDER_LED_FRAME,   // Envia à matriz de LEDs um quadro GRB pronto
+    RENDER_OLED_SWAP,   // Passa a desenhar no buffer recebido (quadro inteiro vindo da USB)
+    RENDER_OLED_PATCH,  // Copia uma janela recebida para o buffer de desenho
+    RENDER_DISPLAY_CMD, // Envia comandos ao display (contraste, inversão, liga/desliga)
+    RENDER_FLUSH,       // Confirma as alterações do display para o próximo quadro
+} render_op_t;
+
+// Comando compacto enviado do núcleo 0 ao serviço de renderização
+typedef struct
+{
+    uint8_t op;   // Operação (render_op_t)
+    uint8_t x, y; // Posição no display
+    union
+    {
+        ui_widget_t *widget; // Widget alvo (RENDER_UI_*)
+        console_t *console;  // Console alvo (RENDER_CONSOLE_LINE)
+        uint8_t *buffer;     // Buffer no layout do ram_buffer (RENDER_OLED_SWAP / RENDER_OLED_PATCH)
+    };
+    union
+    {
+        char text[RENDER_TEXT_MAX + 1]; // RENDER_STRING / RENDER_CHAR / RENDER_UI_LABEL / RENDER_CONSOLE_LINE
+        uint8_t icon;                   // RENDER_ICON / RENDER_UI_ICON
+        int32_t value;                  // RENDER_UI_NUMBER
+        uint32_t since_us;              // RENDER_FLUSH: instante da entrada que originou as alterações (0 se não houver)
+        const uint32_t *frame;          // RENDER_LED_FRAME
+        struct
+        {
+            uint8_t x1, page1;          // RENDER_OLED_PATCH: fim da janela (x e y guardam o início, em páginas)
+        };
+        uint8_t bytes[4];               // RENDER_DISPLAY_CMD: comandos (x guarda a quantidade)
+    };
+} render_cmd_t;
+
+// Estatísticas do serviço de renderização
+typedef struct
+{
+    volatile uint32_t sent;        // Comandos enfileirados pelo núcleo 0
+    volatile uint32_t executed;    // Comandos executados pelo núcleo 1
+    volatile uint32_t stalls;      // Vezes em que o núcleo 0 encontrou a fila cheia
+    volatile uint32_t flushes;     // Envios ao display iniciados
+    volatile uint32_t led_bytes;   // Bytes enviados à matriz de LEDs (3 por LED)
+    volatile uint32_t ui_updates;  // Atualizações de widgets
+    volatile uint32_t ui_damaged;  // Atualizações que alteraram o display
+    volatile uint32_t ui_damage_px; // Pixels das regiões alteradas pelos widgets
+    volatile uint32_t latency_max_us;   // Maior atraso entre a entrada e o fim do envio que a exibiu
+    volatile uint32_t latency_total_us; // Soma dos atrasos (para a média)
+    volatile uint32_t latency_count;    // Envios com entrada associada
+} render_stats_t;
+
+extern render_stats_t render_stats;
+extern frame_scheduler_t render_frames; // Escalonador de quadros (display e matriz de LEDs)
+
+// Inicia o serviço no núcleo 1; a partir daqui apenas ele acessa o display e a matriz de LEDs
+// e, se o display estiver em um barramento compartilhado, conduz esse barramento
+void render_start(ssd1306_t *ssd, ws2812_t *strip);
+
+// Enfileira o desenho de uma string (truncada em RENDER_TEXT_MAX caracteres)
+void render_draw_string(const char *text, uint8_t x, uint8_t y);
+
+// Enfileira o desenho de um caractere
+void render_draw_char(char c, uint8_t x, uint8_t y);
+
+// Enfileira o desenho de um ícone
+void render_draw_icon(uint8_t id, uint8_t x, uint8_t y);
+
+// Enfileira a atualização de um rótulo (o widget passa a ser acessado pelo núcleo 1)
+void render_ui_label(ui_widget_t *widget, const char *text);
+
+// Enfileira a atualização de um ícone
+void render_ui_icon(ui_widget_t *widget, uint8_t id);
+
+// Enfileira a atualização de um campo numérico
+void render_ui_number(ui_widget_t *widget, int32_t value);
+
+// Enfileira uma linha do console (o console passa a ser acessado pelo núcleo 1)
+void render_console_line(console_t *console, const char *text);
+
+// Enfileira o envio de um quadro à matriz de LEDs (deve permanecer válido, p.ex. tabela em flash)
+void render_led_frame(const uint32_t *frame);
+
+// Enfileira a troca do buffer do display por buffer (quadro inteiro); o anterior é liberado quando render_drained
+void render_oled_swap(uint8_t *buffer);
+
+// Enfileira a cópia da janela (x0..x1, páginas page0..page1) de buffer para o display
+void render_oled_patch(uint8_t *buffer, uint8_t x0, uint8_t page0, uint8_t x1, uint8_t page1);
+
+// Enfileira até 4 bytes de comando ao display
+void render_display_command(const uint8_t *bytes, uint8_t count);
+
+// Confirma as alterações enfileiradas até aqui; o display é atualizado no próximo quadro do escalonador
+void render_flush(uint32_t since_us);
+
+// Indica se o núcleo 1 já executou todos os comandos enviados
+bool render_drained(void);
+
+// Indica se o quadro da matriz pode ser reescrito: nenhum comando pendente o referencia e o DMA não o está lendo
+bool render_led_released(const uint32_t *frame);
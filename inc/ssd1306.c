@@ -1,83 +1,581 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
+#include "font_table.h"
+#include "trace.h"
+#include "hardware/sync.h"
 
-// Inicializa o display SSD1306
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c)
+// Custo, em bytes no barramento, de abrir uma nova janela de escrita (endereço I2C + cabeçalho da janela)
+#define SSD1306_WINDOW_OVERHEAD (1 + SSD1306_WINDOW_HEADER)
+
+// Marca todas as páginas como limpas (nenhuma coluna pendente de envio)
+static void ssd1306_clear_dirty(ssd1306_t *ssd)
+{
+    for (uint8_t page = 0; page < SSD1306_MAX_PAGES; ++page)
+    {
+        ssd->dirty_x0[page] = 0xFF;
+        ssd->dirty_x1[page] = 0;
+    }
+}
+
+// Inicializa o display SSD1306 com buffers fornecidos pelo chamador (sem alocação dinâmica)
+void ssd1306_init_with_buffers(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address,
+                               i2c_inst_t *i2c, uint8_t *ram_buffer, uint8_t *tx_buffer, uint16_t *dma_buffer)
 {
     ssd->width = width;                                      // Define a largura do display
     ssd->height = height;                                    // Define a altura do display
     ssd->pages = height / 8U;                                // Calcula o número de páginas (cada página tem 8 linhas)
     ssd->address = address;                                  // Define o endereço I2C do display
     ssd->i2c_port = i2c;                                     // Define a instância do barramento I2C
-    ssd->bufsize = ssd->pages * ssd->width + 1;              // Calcula o tamanho do buffer de memória
-    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t)); // Aloca memória para o buffer
+    ssd->external_vcc = external_vcc;
+    ssd->bufsize = SSD1306_BUFFER_SIZE(width, height);       // Calcula o tamanho do buffer de memória
+    ssd->ram_buffer = ram_buffer;
+    memset(ssd->ram_buffer, 0, ssd->bufsize);
     ssd->ram_buffer[0] = 0x40;                               // Define o primeiro byte do buffer como 0x40 (comando de dados)
     ssd->port_buffer[0] = 0x80;                              // Define o primeiro byte do buffer de porta como 0x80 (comando)
+    ssd->tx_buffer = tx_buffer;                              // Buffer de transmissão (cabeçalho + janela)
+    ssd1306_clear_dirty(ssd);
+    ssd->start_line = 0;
+    ssd->start_line_pending = false;
+    ssd->dma_buffer = dma_buffer;                            // Usado pelo envio assíncrono (ssd1306_async_init aloca se for NULL)
+    ssd->dma_len = 0;
+    ssd->dma_channel = -1;
+    ssd->flush_busy = false;
+    ssd->flush_callback = NULL;
+    ssd->bus = NULL;
+    ssd->bus_pending = 0;
+    ssd1306_reset_stats(ssd);
+}
+
+// Inicializa o display SSD1306
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c)
+{
+    ssd1306_init_with_buffers(ssd, width, height, external_vcc, address, i2c,
+                              calloc(SSD1306_BUFFER_SIZE(width, height), sizeof(uint8_t)),
+                              calloc(SSD1306_TX_BUFFER_SIZE(width, height), sizeof(uint8_t)),
+                              NULL);
 }
 
 // Configura o display SSD1306 com parâmetros padrão
 void ssd1306_config(ssd1306_t *ssd)
 {
-    ssd1306_command(ssd, SET_DISP | 0x00);            // Desliga o display
-    ssd1306_command(ssd, SET_MEM_ADDR);               // Define o modo de endereçamento de memória
-    ssd1306_command(ssd, 0x01);                       // Modo de endereçamento de página
-    ssd1306_command(ssd, SET_DISP_START_LINE | 0x00); // Define a linha inicial do display
-    ssd1306_command(ssd, SET_SEG_REMAP | 0x01);       // Inverte o mapeamento de segmentos (horizontal flip)
-    ssd1306_command(ssd, SET_MUX_RATIO);              // Define a proporção de multiplexação
-    ssd1306_command(ssd, HEIGHT - 1);                 // Configura a altura do display
-    ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);     // Inverte a direção dos pinos COM
-    ssd1306_command(ssd, SET_DISP_OFFSET);            // Define o deslocamento vertical do display
-    ssd1306_command(ssd, 0x00);                       // Sem deslocamento
-    ssd1306_command(ssd, SET_COM_PIN_CFG);            // Configura os pinos COM
-    ssd1306_command(ssd, 0x12);                       // Configuração específica para o display
-    ssd1306_command(ssd, SET_DISP_CLK_DIV);           // Define o divisor de clock do display
-    ssd1306_command(ssd, 0x80);                       // Frequência de clock padrão
-    ssd1306_command(ssd, SET_PRECHARGE);              // Define o tempo de pré-carga
-    ssd1306_command(ssd, 0xF1);                       // Configuração específica para o display
-    ssd1306_command(ssd, SET_VCOM_DESEL);             // Define o nível de desseleção VCOM
-    ssd1306_command(ssd, 0x30);                       // Configuração específica para o display
-    ssd1306_command(ssd, SET_CONTRAST);               // Define o contraste do display
-    ssd1306_command(ssd, 0xFF);                       // Contraste máximo
-    ssd1306_command(ssd, SET_ENTIRE_ON);              // Liga a exibição de todos os pixels
-    ssd1306_command(ssd, SET_NORM_INV);               // Define a exibição normal (não invertida)
-    ssd1306_command(ssd, SET_CHARGE_PUMP);            // Configura a bomba de carga
-    ssd1306_command(ssd, 0x14);                       // Habilita a bomba de carga para alimentação externa
-    ssd1306_command(ssd, SET_DISP | 0x01);            // Liga o display
+    ssd1306_cmdlist_t list;
+    ssd1306_cmdlist_begin(&list);
+    ssd1306_cmdlist_add(ssd, &list, SET_DISP | 0x00);             // Desliga o display
+    ssd1306_cmdlist_add(ssd, &list, SET_MEM_ADDR);                // Define o modo de endereçamento de memória
+    ssd1306_cmdlist_add(ssd, &list, 0x01);                        // Modo de endereçamento de página
+    ssd1306_cmdlist_add(ssd, &list, SET_DISP_START_LINE | 0x00);  // Define a linha inicial do display
+    ssd1306_cmdlist_add(ssd, &list, SET_SEG_REMAP | 0x01);        // Inverte o mapeamento de segmentos (horizontal flip)
+    ssd1306_cmdlist_add(ssd, &list, SET_MUX_RATIO);               // Define a proporção de multiplexação
+    ssd1306_cmdlist_add(ssd, &list, ssd->height - 1);             // Configura a altura do display
+    ssd1306_cmdlist_add(ssd, &list, SET_COM_OUT_DIR | 0x08);      // Inverte a direção dos pinos COM
+    ssd1306_cmdlist_add(ssd, &list, SET_DISP_OFFSET);             // Define o deslocamento vertical do display
+    ssd1306_cmdlist_add(ssd, &list, 0x00);                        // Sem deslocamento
+    ssd1306_cmdlist_add(ssd, &list, SET_COM_PIN_CFG);             // Configura os pinos COM
+    ssd1306_cmdlist_add(ssd, &list, ssd->height == 32 ? 0x02 : 0x12); // Sequencial em 128x32, alternado em 128x64
+    ssd1306_cmdlist_add(ssd, &list, SET_DISP_CLK_DIV);            // Define o divisor de clock do display
+    ssd1306_cmdlist_add(ssd, &list, 0x80);                        // Frequência de clock padrão
+    ssd1306_cmdlist_add(ssd, &list, SET_PRECHARGE);               // Define o tempo de pré-carga
+    ssd1306_cmdlist_add(ssd, &list, 0xF1);                        // Configuração específica para o display
+    ssd1306_cmdlist_add(ssd, &list, SET_VCOM_DESEL);              // Define o nível de desseleção VCOM
+    ssd1306_cmdlist_add(ssd, &list, 0x30);                        // Configuração específica para o display
+    ssd1306_cmdlist_add(ssd, &list, SET_CONTRAST);                // Define o contraste do display
+    ssd1306_cmdlist_add(ssd, &list, 0xFF);                        // Contraste máximo
+    ssd1306_cmdlist_add(ssd, &list, SET_ENTIRE_ON);               // Liga a exibição de todos os pixels
+    ssd1306_cmdlist_add(ssd, &list, SET_NORM_INV);                // Define a exibição normal (não invertida)
+    ssd1306_cmdlist_add(ssd, &list, SET_CHARGE_PUMP);             // Configura a bomba de carga
+    ssd1306_cmdlist_add(ssd, &list, 0x14);                        // Habilita a bomba de carga para alimentação externa
+    ssd1306_cmdlist_add(ssd, &list, SET_DISP | 0x01);             // Liga o display
+    ssd1306_cmdlist_send(ssd, &list);                             // Envia toda a configuração em uma única transação
+}
+
+// Escreve uma transação no barramento, contabilizando-a nas estatísticas de transmissão
+static void ssd1306_write(ssd1306_t *ssd, const uint8_t *buffer, size_t length)
+{
+    if (ssd->bus)
+    {
+        // Pelo barramento compartilhado: dma_buffer está livre, pois todo envio aguarda o anterior terminar
+        for (size_t i = 0; i < length; ++i)
+            ssd->dma_buffer[i] = buffer[i];
+        ssd->dma_buffer[length - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+        i2c_xfer_t xfer;
+        i2c_xfer_init(&xfer, ssd->address, ssd->bus_priority, ssd->dma_buffer, length);
+        i2c_bus_transfer(ssd->bus, &xfer);
+    }
+    else
+        i2c_write_blocking(ssd->i2c_port, ssd->address, buffer, length, false);
+    ssd->tx_transactions++;
+    ssd->tx_bytes += length + 1; // Inclui o byte de endereço
 }
 
 // Envia um comando para o display
 void ssd1306_command(ssd1306_t *ssd, uint8_t command)
 {
+    trace_begin(TRACE_COMMAND);
+    ssd1306_flush_wait(ssd);       // Não intercala comandos com um envio assíncrono em andamento
     ssd->port_buffer[1] = command; // Armazena o comando no buffer de porta
-    i2c_write_blocking(
-        ssd->i2c_port,
-        ssd->address,
-        ssd->port_buffer,
-        2,
-        false); // Envia o comando via I2C
+    ssd1306_write(ssd, ssd->port_buffer, 2); // Envia o comando via I2C
+    trace_end(TRACE_COMMAND);
+}
+
+// Inicia uma lista de comandos vazia (todos os bytes seguintes ao controle 0x00 são comandos)
+void ssd1306_cmdlist_begin(ssd1306_cmdlist_t *list)
+{
+    list->buffer[0] = 0x00;
+    list->length = 1;
+}
+
+// Acrescenta um comando (ou parâmetro) à lista, enviando-a antes caso esteja cheia
+void ssd1306_cmdlist_add(ssd1306_t *ssd, ssd1306_cmdlist_t *list, uint8_t command)
+{
+    if (list->length == SSD1306_CMDLIST_SIZE)
+    {
+        ssd1306_cmdlist_send(ssd, list);
+        ssd1306_cmdlist_begin(list);
+    }
+    list->buffer[list->length++] = command;
+}
+
+// Envia todos os comandos da lista em uma única transação I2C
+void ssd1306_cmdlist_send(ssd1306_t *ssd, ssd1306_cmdlist_t *list)
+{
+    if (list->length <= 1)
+        return; // Lista vazia
+    ssd1306_flush_wait(ssd);
+    ssd1306_write(ssd, list->buffer, list->length);
+}
+
+// Escreve o cabeçalho que posiciona a janela x0..x1, p0..p1 e abre o bloco de dados; retorna seu tamanho
+static uint8_t ssd1306_window_header(uint8_t *out, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1)
+{
+    const uint8_t window[] = {SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, p0, p1};
+    for (uint8_t i = 0; i < sizeof(window); ++i)
+    {
+        *out++ = 0x80; // Co = 1: apenas o próximo byte é um comando
+        *out++ = window[i];
+    }
+    *out = 0x40; // Co = 0, D/C = 1: o restante da transação são dados
+    return SSD1306_WINDOW_HEADER;
+}
+
+// Envia a janela de colunas x0..x1 e páginas p0..p1 (modo de endereçamento vertical)
+static void ssd1306_send_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1)
+{
+    ssd1306_flush_wait(ssd); // O buffer de transmissão e o barramento não podem estar em uso pelo DMA
+
+    // Copia as colunas da janela para o buffer de transmissão, após o cabeçalho, na ordem em que o display as espera
+    uint8_t *out = ssd->tx_buffer + ssd1306_window_header(ssd->tx_buffer, x0, x1, p0, p1);
+    for (uint8_t x = x0; x <= x1; ++x)
+    {
+        const uint8_t *column = ssd->ram_buffer + 1 + x * ssd->pages;
+        for (uint8_t page = p0; page <= p1; ++page)
+            *out++ = column[page];
+    }
+
+    ssd1306_write(ssd, ssd->tx_buffer, out - ssd->tx_buffer); // Envia comandos e dados da janela em uma única transação
+}
+
+// Envia a linha inicial pendente, depois dos dados, para que a rolagem exiba o conteúdo já atualizado
+static void ssd1306_send_start_line(ssd1306_t *ssd)
+{
+    if (!ssd->start_line_pending)
+        return;
+    ssd->start_line_pending = false;
+    const uint8_t command[] = {0x00, SET_DISP_START_LINE | ssd->start_line};
+    ssd1306_write(ssd, command, sizeof(command));
 }
 
 // Envia o conteúdo do buffer de memória para o display
 void ssd1306_send_data(ssd1306_t *ssd)
 {
-    ssd1306_command(ssd, SET_COL_ADDR);   // Define o intervalo de colunas
-    ssd1306_command(ssd, 0);              // Coluna inicial
-    ssd1306_command(ssd, ssd->width - 1); // Coluna final
-    ssd1306_command(ssd, SET_PAGE_ADDR);  // Define o intervalo de páginas
-    ssd1306_command(ssd, 0);              // Página inicial
-    ssd1306_command(ssd, ssd->pages - 1); // Página final
-    i2c_write_blocking(
-        ssd->i2c_port,
-        ssd->address,
-        ssd->ram_buffer,
-        ssd->bufsize,
-        false); // Envia o buffer de memória via I2C
+    trace_begin(TRACE_SEND_DATA);
+    if (ssd->bus)
+    {
+        // Também em transações de uma página, para não monopolizar o barramento compartilhado
+        ssd1306_flush_start(ssd, true);
+        ssd1306_flush_wait(ssd);
+    }
+    else
+    {
+        ssd1306_send_window(ssd, 0, ssd->width - 1, 0, ssd->pages - 1); // Janela cobrindo todo o display
+        ssd1306_clear_dirty(ssd);                                       // O display agora reflete todo o buffer
+        ssd1306_send_start_line(ssd);
+    }
+    trace_end(TRACE_SEND_DATA);
+}
+
+// Percorre as regiões alteradas, agrupadas em retângulos, chamando send para cada uma
+static void ssd1306_for_each_dirty(ssd1306_t *ssd, void (*send)(ssd1306_t *, uint8_t, uint8_t, uint8_t, uint8_t))
+{
+    uint8_t page = 0;
+    while (page < ssd->pages)
+    {
+        if (ssd->dirty_x0[page] > ssd->dirty_x1[page])
+        {
+            ++page; // Página sem alterações
+            continue;
+        }
+
+        // Agrupa páginas consecutivas em um único retângulo enquanto isso custar menos que abrir uma nova janela
+        // (no barramento compartilhado cada página já é uma transação, então não há o que agrupar)
+        uint8_t x0 = ssd->dirty_x0[page], x1 = ssd->dirty_x1[page];
+        uint8_t last = page;
+        uint16_t cost = x1 - x0 + 1;
+        while (!ssd->bus && last + 1 < ssd->pages && ssd->dirty_x0[last + 1] <= ssd->dirty_x1[last + 1])
+        {
+            uint8_t nx0 = ssd->dirty_x0[last + 1] < x0 ? ssd->dirty_x0[last + 1] : x0;
+            uint8_t nx1 = ssd->dirty_x1[last + 1] > x1 ? ssd->dirty_x1[last + 1] : x1;
+            uint16_t merged = (nx1 - nx0 + 1) * (last + 2 - page);
+            uint16_t split = cost + (ssd->dirty_x1[last + 1] - ssd->dirty_x0[last + 1] + 1) + SSD1306_WINDOW_OVERHEAD;
+            if (merged > split)
+                break;
+            x0 = nx0;
+            x1 = nx1;
+            cost = merged;
+            ++last;
+        }
+
+        send(ssd, x0, x1, page, last);
+        page = last + 1;
+    }
+    ssd1306_clear_dirty(ssd);
+}
+
+// Envia para o display apenas as regiões alteradas desde o último envio
+void ssd1306_send_dirty(ssd1306_t *ssd)
+{
+    if (ssd->bus)
+    {
+        ssd1306_flush_start(ssd, false);
+        ssd1306_flush_wait(ssd);
+        return;
+    }
+    ssd1306_for_each_dirty(ssd, ssd1306_send_window);
+    ssd1306_send_start_line(ssd);
+}
+
+// Acrescenta ao quadro de DMA uma transação com a janela x0..x1, p0..p1 e seus dados
+static void ssd1306_stream_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1)
+{
+    uint8_t header[SSD1306_WINDOW_HEADER];
+    uint16_t *out = ssd->dma_buffer + ssd->dma_len;
+
+    uint8_t length = ssd1306_window_header(header, x0, x1, p0, p1);
+    for (uint8_t i = 0; i < length; ++i)
+        *out++ = header[i];
+    for (uint8_t x = x0; x <= x1; ++x)
+    {
+        const uint8_t *column = ssd->ram_buffer + 1 + x * ssd->pages;
+        for (uint8_t page = p0; page <= p1; ++page)
+            *out++ = column[page];
+    }
+    out[-1] |= I2C_IC_DATA_CMD_STOP_BITS; // Encerra a transação; a próxima janela começa com um novo START
+
+    ssd->tx_transactions++;
+    ssd->tx_bytes += (out - ssd->dma_buffer) - ssd->dma_len + 1; // Inclui o byte de endereço
+    ssd->dma_len = out - ssd->dma_buffer;
+}
+
+// Acrescenta ao quadro de DMA uma transação por página da janela, para o barramento compartilhado
+static void ssd1306_stream_pages(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1)
+{
+    for (uint8_t page = p0; page <= p1; ++page)
+        ssd1306_stream_window(ssd, x0, x1, page, page);
+}
+
+// Acrescenta ao quadro de DMA a transação com a linha inicial pendente
+static void ssd1306_stream_start_line(ssd1306_t *ssd)
+{
+    if (!ssd->start_line_pending)
+        return;
+    ssd->start_line_pending = false;
+
+    uint16_t *out = ssd->dma_buffer + ssd->dma_len;
+    out[0] = 0x00; // Co = 0, D/C = 0: o byte seguinte é um comando
+    out[1] = (SET_DISP_START_LINE | ssd->start_line) | I2C_IC_DATA_CMD_STOP_BITS;
+    ssd->dma_len += 2;
+    ssd->tx_transactions++;
+    ssd->tx_bytes += 3; // Inclui o byte de endereço
+}
+
+// Configura o envio assíncrono via DMA (retorna false se não houver canal de DMA livre)
+bool ssd1306_async_init(ssd1306_t *ssd)
+{
+    int channel = dma_claim_unused_channel(false);
+    if (channel < 0)
+        return false;
+
+    // Pior caso: uma janela por página, cada uma com seu cabeçalho, mais todo o quadro de dados
+    if (!ssd->dma_buffer)
+        ssd->dma_buffer = calloc(SSD1306_DMA_BUFFER_WORDS(ssd->width, ssd->height), sizeof(uint16_t));
+    if (!ssd->dma_buffer)
+    {
+        dma_channel_unclaim(channel);
+        return false;
+    }
+
+    dma_channel_config config = dma_channel_get_default_config(channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);           // Uma palavra de IC_DATA_CMD por byte
+    channel_config_set_read_increment(&config, true);                      // Percorre o quadro de DMA
+    channel_config_set_write_increment(&config, false);                    // Sempre no registrador de dados do I2C
+    channel_config_set_dreq(&config, i2c_get_dreq(ssd->i2c_port, true));   // Ritmo ditado pela FIFO de transmissão
+    dma_channel_configure(channel, &config, &i2c_get_hw(ssd->i2c_port)->data_cmd, ssd->dma_buffer, 0, false);
+
+    ssd->dma_channel = channel;
+    return true;
+}
+
+// Término de uma transação do quadro enviado pelo barramento compartilhado
+static void ssd1306_bus_chunk_done(i2c_xfer_t *xfer, void *ctx)
+{
+    ssd1306_t *ssd = ctx;
+    if (xfer->state == I2C_XFER_FAILED)
+        ssd->bus_failed = true;
+    if (--ssd->bus_pending)
+        return;
+
+    if (ssd->bus_failed)
+    {
+        // Parte do quadro não chegou ao display: tudo é reenviado no próximo envio
+        ssd1306_mark_dirty(ssd, 0, 0, ssd->width - 1, ssd->height - 1);
+        ssd->start_line_pending = true;
+    }
+    ssd->flush_busy = false;
+    if (ssd->flush_callback)
+        ssd->flush_callback(ssd);
+}
+
+// Envia o display pelo barramento compartilhado, com a prioridade indicada, em vez de usar o controlador diretamente
+// O barramento passa a ser conduzido por quem chama ssd1306_flush_poll ou i2c_bus_poll
+bool ssd1306_attach_bus(ssd1306_t *ssd, i2c_bus_t *bus, i2c_priority_t priority)
+{
+    // Pior caso: uma transação por página, cada uma com seu cabeçalho, mais todo o quadro de dados
+    if (!ssd->dma_buffer)
+        ssd->dma_buffer = calloc(SSD1306_DMA_BUFFER_WORDS(ssd->width, ssd->height), sizeof(uint16_t));
+    if (!ssd->dma_buffer)
+        return false;
+
+    ssd1306_flush_wait(ssd);
+    ssd->bus = bus;
+    ssd->bus_priority = priority;
+    return true;
+}
+
+// Divide o quadro de DMA nas transações terminadas em STOP e as enfileira no barramento compartilhado
+static void ssd1306_bus_submit(ssd1306_t *ssd)
+{
+    uint8_t count = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < ssd->dma_len; ++i)
+    {
+        if (!(ssd->dma_buffer[i] & I2C_IC_DATA_CMD_STOP_BITS))
+            continue;
+        i2c_xfer_t *chunk = &ssd->bus_chunks[count++];
+        i2c_xfer_init(chunk, ssd->address, ssd->bus_priority, ssd->dma_buffer + start, i + 1 - start);
+        chunk->done = ssd1306_bus_chunk_done;
+        chunk->ctx = ssd;
+        start = i + 1;
+    }
+
+    ssd->bus_pending = count;
+    ssd->bus_failed = false;
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        if (!i2c_bus_submit(ssd->bus, &ssd->bus_chunks[i]))
+        {
+            // Fila cheia: a transação é dada como perdida e o quadro será reenviado
+            ssd->bus_chunks[i].state = I2C_XFER_FAILED;
+            ssd1306_bus_chunk_done(&ssd->bus_chunks[i], ssd);
+        }
+    }
+}
+
+// Define a função chamada ao término de cada envio assíncrono
+void ssd1306_set_flush_callback(ssd1306_t *ssd, void (*callback)(ssd1306_t *ssd))
+{
+    ssd->flush_callback = callback;
+}
+
+// Inicia o envio assíncrono do quadro (completo ou apenas as regiões alteradas); retorna false se houver envio em andamento
+bool ssd1306_flush_start(ssd1306_t *ssd, bool full)
+{
+    if (ssd->dma_channel < 0 && !ssd->bus)
+    {
+        // Sem DMA configurado, recorre ao envio bloqueante
+        if (full)
+            ssd1306_send_data(ssd);
+        else
+            ssd1306_send_dirty(ssd);
+        return true;
+    }
+
+    if (!ssd1306_flush_poll(ssd))
+        return false;
+
+    // Reserva o envio de forma atômica, pois a função pode ser chamada tanto no laço principal quanto em interrupções
+    uint32_t irq_state = save_and_disable_interrupts();
+    bool busy = ssd->flush_busy;
+    ssd->flush_busy = true;
+    restore_interrupts(irq_state);
+    if (busy)
+        return false;
+
+    // Copia o quadro para o buffer de DMA; a partir daqui ram_buffer pode ser alterado livremente
+    // No barramento compartilhado, cada página é uma transação separada
+    void (*stream)(ssd1306_t *, uint8_t, uint8_t, uint8_t, uint8_t) = ssd->bus ? ssd1306_stream_pages : ssd1306_stream_window;
+    ssd->dma_len = 0;
+    if (full)
+    {
+        stream(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+        ssd1306_clear_dirty(ssd);
+    }
+    else
+        ssd1306_for_each_dirty(ssd, stream);
+    ssd1306_stream_start_line(ssd);
+
+    if (ssd->dma_len == 0)
+    {
+        ssd->flush_busy = false; // Nada a enviar: o envio termina imediatamente
+        if (ssd->flush_callback)
+            ssd->flush_callback(ssd);
+        return true;
+    }
+
+    if (ssd->bus)
+    {
+        ssd1306_bus_submit(ssd);
+        return true;
+    }
+
+    // Seleciona o endereço do display (o controlador precisa estar desabilitado para alterar o TAR)
+    i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+    hw->enable = 0;
+    hw->tar = ssd->address;
+    hw->enable = 1;
+
+    dma_channel_transfer_from_buffer_now(ssd->dma_channel, ssd->dma_buffer, ssd->dma_len);
+    return true;
+}
+
+// Verifica o andamento do envio assíncrono; retorna true quando não há envio pendente
+bool ssd1306_flush_poll(ssd1306_t *ssd)
+{
+    if (!ssd->flush_busy)
+        return true;
+    if (ssd->bus)
+    {
+        i2c_bus_poll(ssd->bus); // As transações do quadro terminam em ssd1306_bus_chunk_done
+        return !ssd->flush_busy;
+    }
+
+    i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+    if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+    {
+        // Display não respondeu: interrompe o DMA e descarta o restante do quadro, que é reenviado inteiro no próximo envio
+        dma_channel_abort(ssd->dma_channel);
+        (void)hw->clr_tx_abrt;
+        ssd1306_mark_dirty(ssd, 0, 0, ssd->width - 1, ssd->height - 1);
+        ssd->start_line_pending = true;
+    }
+    else if (dma_channel_is_busy(ssd->dma_channel) ||
+             !(hw->status & I2C_IC_STATUS_TFE_BITS) ||
+             (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS))
+        return false; // Ainda há palavras no DMA, na FIFO ou no barramento
+
+    ssd->flush_busy = false;
+    if (ssd->flush_callback)
+        ssd->flush_callback(ssd);
+    return true;
+}
+
+// Aguarda o término do envio assíncrono em andamento
+void ssd1306_flush_wait(ssd1306_t *ssd)
+{
+    while (!ssd1306_flush_poll(ssd))
+        tight_loop_contents();
+}
+
+// Zera os contadores de transações e bytes enviados
+void ssd1306_reset_stats(ssd1306_t *ssd)
+{
+    ssd->tx_transactions = 0;
+    ssd->tx_bytes = 0;
+}
+
+// Estima o tempo de barramento, em microssegundos, de bytes e transações a uma dada frequência de I2C
+uint32_t ssd1306_bus_time_us(uint32_t bytes, uint32_t transactions, uint32_t baudrate)
+{
+    // Cada byte ocupa 9 ciclos de SCL (8 bits + ACK); START e STOP somam cerca de 2 ciclos por transação
+    uint64_t bits = (uint64_t)bytes * 9 + (uint64_t)transactions * 2;
+    return (uint32_t)((bits * 1000000 + baudrate - 1) / baudrate);
+}
+
+// Marca a região (x0..x1, y0..y1) como alterada para o próximo envio incremental
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+    if (x0 >= ssd->width || y0 >= ssd->height || x0 > x1 || y0 > y1)
+        return;
+    if (x1 >= ssd->width)
+        x1 = ssd->width - 1;
+    if (y1 >= ssd->height)
+        y1 = ssd->height - 1;
+
+    for (uint8_t page = y0 >> 3; page <= (y1 >> 3); ++page)
+    {
+        if (x0 < ssd->dirty_x0[page])
+            ssd->dirty_x0[page] = x0;
+        if (x1 > ssd->dirty_x1[page])
+            ssd->dirty_x1[page] = x1;
+    }
+}
+
+// Define a linha da memória exibida no topo da tela; o comando segue no próximo envio, após os dados
+void ssd1306_set_start_line(ssd1306_t *ssd, uint8_t line)
+{
+    line &= 0x3F;
+    if (line == ssd->start_line && !ssd->start_line_pending)
+        return;
+    ssd->start_line = line;
+    ssd->start_line_pending = true;
+}
+
+// Troca o buffer de desenho por outro de mesmo tamanho (p.ex. um quadro recebido pela USB)
+// Retorna o buffer anterior; o quadro inteiro é marcado como alterado
+uint8_t *ssd1306_swap_buffer(ssd1306_t *ssd, uint8_t *buffer)
+{
+    uint8_t *previous = ssd->ram_buffer;
+    buffer[0] = 0x40; // Mesmo prefixo de dados do buffer original
+    ssd->ram_buffer = buffer;
+    ssd1306_mark_dirty(ssd, 0, 0, ssd->width - 1, ssd->height - 1);
+    return previous;
+}
+
+// Copia a janela (x0..x1, páginas page0..page1) de outro buffer no layout do ram_buffer e a marca como alterada
+void ssd1306_copy_window(ssd1306_t *ssd, const uint8_t *src, uint8_t x0, uint8_t page0, uint8_t x1, uint8_t page1)
+{
+    if (x0 > x1 || page0 > page1 || x1 >= ssd->width || page1 >= ssd->pages)
+        return;
+
+    // No endereçamento vertical, as páginas de uma coluna são contíguas
+    size_t offset = 1 + x0 * ssd->pages + page0;
+    for (uint8_t x = x0; x <= x1; ++x, offset += ssd->pages)
+        memcpy(ssd->ram_buffer + offset, src + offset, page1 - page0 + 1);
+    ssd1306_mark_dirty(ssd, x0, page0 * 8, x1, page1 * 8 + 7);
 }
 
 // Desenha um pixel na posição (x, y) com o valor especificado (ligado/desligado)
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value)
 {
-    uint16_t index = (y >> 3) + (x << 3) + 1; // Calcula o índice no buffer de memória
+    if (x >= ssd->width || y >= ssd->height)
+        return; // Ignora pixels fora da área do display
+
+    uint8_t page = y >> 3; // Registra a coluna alterada na página do pixel
+    if (x < ssd->dirty_x0[page])
+        ssd->dirty_x0[page] = x;
+    if (x > ssd->dirty_x1[page])
+        ssd->dirty_x1[page] = x;
+
+    uint16_t index = 1 + x * ssd->pages + page; // Calcula o índice no buffer de memória (colunas de "pages" bytes)
     uint8_t pixel = (y & 0b111);              // Calcula o bit específico dentro do byte
     if (value)
         ssd->ram_buffer[index] |= (1 << pixel); // Liga o pixel
@@ -85,45 +583,95 @@ void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value)
         ssd->ram_buffer[index] &= ~(1 << pixel); // Desliga o pixel
 }
 
-// Preenche todo o display com o valor especificado (ligado/desligado)
-void ssd1306_fill(ssd1306_t *ssd, bool value)
+// Aplica a máscara a um byte do buffer conforme o modo de desenho
+static inline void ssd1306_apply(uint8_t *byte, uint8_t mask, ssd1306_mode_t mode)
+{
+    if (mode == SSD1306_CLEAR)
+        *byte &= ~mask;
+    else if (mode == SSD1306_XOR)
+        *byte ^= mask;
+    else
+        *byte |= mask; // SSD1306_SET e SSD1306_COPY
+}
+
+// Aplica o modo a um trecho contíguo do buffer
+static void ssd1306_apply_run(uint8_t *start, size_t length, ssd1306_mode_t mode)
 {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y)
+    if (mode != SSD1306_XOR)
     {
-        for (uint8_t x = 0; x < ssd->width; ++x)
-        {
-            ssd1306_pixel(ssd, x, y, value); // Define o valor do pixel
-        }
+        memset(start, mode == SSD1306_CLEAR ? 0x00 : 0xFF, length);
+        return;
     }
+
+    // Byte a byte: o compilador já agrupa o laço em palavras, sem acessar o buffer de bytes como uint32_t
+    for (uint8_t *end = start + length; start < end; ++start)
+        *start ^= 0xFF;
 }
 
-// Desenha um retângulo na posição (top, left) com as dimensões (width, height)
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill)
+// Preenche a área (x0..x1, y0..y1) no modo especificado
+void ssd1306_fill_area(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, ssd1306_mode_t mode)
 {
-    // Desenha as bordas do retângulo
-    for (uint8_t x = left; x < left + width; ++x)
+    if (x0 > x1 || y0 > y1 || x0 >= ssd->width || y0 >= ssd->height)
+        return;
+    if (x1 >= ssd->width)
+        x1 = ssd->width - 1; // Recorta na borda direita
+    if (y1 >= ssd->height)
+        y1 = ssd->height - 1; // Recorta na borda inferior
+    ssd1306_mark_dirty(ssd, x0, y0, x1, y1);
+
+    uint8_t p0 = y0 >> 3, p1 = y1 >> 3;
+    uint8_t top = 0xFF << (y0 & 0b111);          // Linhas cobertas na primeira página
+    uint8_t bottom = 0xFF >> (7 - (y1 & 0b111)); // Linhas cobertas na última página
+    uint8_t *column = ssd->ram_buffer + 1 + x0 * ssd->pages;
+
+    // Colunas inteiras são contíguas no modo de endereçamento vertical
+    if (p0 == 0 && p1 == ssd->pages - 1 && top == 0xFF && bottom == 0xFF)
     {
-        ssd1306_pixel(ssd, x, top, value);              // Borda superior
-        ssd1306_pixel(ssd, x, top + height - 1, value); // Borda inferior
+        ssd1306_apply_run(column, (x1 - x0 + 1) * ssd->pages, mode);
+        return;
     }
-    for (uint8_t y = top; y < top + height; ++y)
+
+    for (uint8_t x = x0; x <= x1; ++x, column += ssd->pages)
     {
-        ssd1306_pixel(ssd, left, y, value);             // Borda esquerda
-        ssd1306_pixel(ssd, left + width - 1, y, value); // Borda direita
+        if (p0 == p1)
+        {
+            ssd1306_apply(&column[p0], top & bottom, mode); // A área cabe em uma única página
+            continue;
+        }
+        ssd1306_apply(&column[p0], top, mode);
+        for (uint8_t page = p0 + 1; page < p1; ++page)
+            ssd1306_apply(&column[page], 0xFF, mode); // Páginas intermediárias inteiras
+        ssd1306_apply(&column[p1], bottom, mode);
     }
+}
+
+// Preenche todo o display com o valor especificado (ligado/desligado)
+void ssd1306_fill(ssd1306_t *ssd, bool value)
+{
+    ssd1306_fill_area(ssd, 0, 0, ssd->width - 1, ssd->height - 1, value ? SSD1306_SET : SSD1306_CLEAR);
+}
 
-    // Preenche o retângulo, se necessário
+// Desenha um retângulo na posição (top, left) com as dimensões (width, height)
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill)
+{
+    if (width == 0 || height == 0)
+        return;
+
+    ssd1306_mode_t mode = value ? SSD1306_SET : SSD1306_CLEAR;
+    uint8_t right = (left + width - 1 > 0xFF) ? 0xFF : left + width - 1; // Bordas além do display são recortadas
+    uint8_t bottom = (top + height - 1 > 0xFF) ? 0xFF : top + height - 1;
+
+    // Preenchido: a borda e o interior têm o mesmo valor, então basta uma única área
     if (fill)
     {
-        for (uint8_t x = left + 1; x < left + width - 1; ++x)
-        {
-            for (uint8_t y = top + 1; y < top + height - 1; ++y)
-            {
-                ssd1306_pixel(ssd, x, y, value); // Preenche o interior do retângulo
-            }
-        }
+        ssd1306_fill_area(ssd, left, top, right, bottom, mode);
+        return;
     }
+
+    ssd1306_fill_area(ssd, left, top, right, top, mode);        // Borda superior
+    ssd1306_fill_area(ssd, left, bottom, right, bottom, mode);  // Borda inferior
+    ssd1306_fill_area(ssd, left, top, left, bottom, mode);      // Borda esquerda
+    ssd1306_fill_area(ssd, right, top, right, bottom, mode);    // Borda direita
 }
 
 // Desenha uma linha entre os pontos (x0, y0) e (x1, y1)
@@ -163,60 +711,230 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 // Desenha uma linha horizontal entre os pontos (x0, y) e (x1, y)
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value)
 {
-    for (uint8_t x = x0; x <= x1; ++x)
-        ssd1306_pixel(ssd, x, y, value); // Desenha cada pixel da linha
+    ssd1306_fill_area(ssd, x0, y, x1, y, value ? SSD1306_SET : SSD1306_CLEAR);
 }
 
 // Desenha uma linha vertical entre os pontos (x, y0) e (x, y1)
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value)
 {
-    for (uint8_t y = y0; y <= y1; ++y)
-        ssd1306_pixel(ssd, x, y, value); // Desenha cada pixel da linha
+    ssd1306_fill_area(ssd, x, y0, x, y1, value ? SSD1306_SET : SSD1306_CLEAR);
+}
+
+// Desenha uma sequência de colunas de 8 pixels (bit 0 no topo) a partir de (x, y), sobrescrevendo o fundo
+void ssd1306_draw_columns(ssd1306_t *ssd, const uint8_t *columns, uint8_t count, uint8_t x, uint8_t y)
+{
+    if (x >= ssd->width || y >= ssd->height || count == 0)
+        return;
+    if (count > ssd->width - x)
+        count = ssd->width - x; // Recorta na borda direita
+    ssd1306_mark_dirty(ssd, x, y, x + count - 1, y + 7);
+
+    uint8_t page = y >> 3;
+    uint8_t shift = y & 0b111;
+    uint8_t *dest = ssd->ram_buffer + 1 + x * ssd->pages + page;
+
+    if (shift == 0)
+    {
+        // Alinhado à página: cada coluna é um único byte do buffer
+        for (uint8_t i = 0; i < count; ++i, dest += ssd->pages)
+            *dest = columns[i];
+        return;
+    }
+
+    // Desalinhado: cada coluna ocupa a parte de baixo de uma página e a parte de cima da seguinte
+    bool has_next = page + 1 < ssd->pages; // Recorta na borda inferior
+    uint8_t low_mask = 0xFF << shift;
+    uint8_t high_mask = 0xFF >> (8 - shift);
+    for (uint8_t i = 0; i < count; ++i, dest += ssd->pages)
+    {
+        dest[0] = (dest[0] & ~low_mask) | (columns[i] << shift);
+        if (has_next)
+            dest[1] = (dest[1] & ~high_mask) | (columns[i] >> (8 - shift));
+    }
 }
 
-// Desenha um caractere na posição (x, y)
+// Desenha um caractere na posição (x, y), ocupando a célula inteira da fonte (texto monoespaçado)
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
-    uint16_t index = 0;
-    char ver = c;
-    if (c >= 'A' && c <= 'Z')
+    const font_t *font = &font8x8;
+    const font_glyph_t *glyph = font_glyph(font, c); // Acesso direto pela tabela; ausentes ficam em branco
+
+    for (uint8_t page = 0; page < font->pages; ++page)
     {
-        index = (c - 'A' + 11) * 8; // Para letras maiúsculas
+        uint8_t cell[FONT_MAX_CELL] = {0};
+        if (glyph && glyph->width)
+            memcpy(&cell[glyph->left], font_glyph_columns(font, glyph, page), glyph->width);
+        ssd1306_draw_columns(ssd, cell, font->cell, x, y + page * 8);
     }
-    else if (c >= '0' && c <= '9')
+}
+
+// Desenha um texto com largura proporcional a partir de (x, y), sem quebra de linha
+// Retorna a posição x após o último caractere desenhado
+uint8_t ssd1306_draw_text(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+{
+    static const uint8_t blank[FONT_MAX_CELL] = {0};
+    const font_t *font = &font8x8;
+
+    for (; *str; ++str)
     {
-        index = (c - '0' + 1) * 8; // Para números
+        const font_glyph_t *glyph = font_glyph(font, *str);
+        if (!glyph || !glyph->width)
+            continue; // Caractere ausente na fonte
+        if (x + glyph->width > ssd->width)
+            break; // Não cabe na linha
+
+        // Glifo seguido do espaçamento, sobrescrevendo o fundo
+        for (uint8_t page = 0; page < font->pages; ++page)
+        {
+            ssd1306_draw_columns(ssd, font_glyph_columns(font, glyph, page), glyph->width, x, y + page * 8);
+            ssd1306_draw_columns(ssd, blank, font->spacing, x + glyph->width, y + page * 8);
+        }
+        x += glyph->width + font->spacing;
     }
-    else if (c >= 'a' && c <= 'z')
+    return x;
+}
+
+// Leitura sequencial dos dados de um bitmap
+typedef struct
+{
+    const uint8_t *src; // Próximo byte de data
+    uint8_t format;     // Codificação (bitmap_format_t)
+    uint8_t count;      // Bytes restantes da sequência RLE atual
+    bool repeat;        // A sequência atual repete value (senão, é literal)
+    uint8_t value;      // Byte repetido
+} bitmap_reader_t;
+
+// Avança até n bytes (no máximo uma sequência); retorna quantos, com os bytes em *literal ou,
+// se *literal for NULL, o byte repetido em *value
+static uint8_t bitmap_next(bitmap_reader_t *reader, size_t n, const uint8_t **literal, uint8_t *value)
+{
+    if (reader->format == BITMAP_RAW)
     {
-        index = (c - 'a' + 37) * 8; // Para letras minúsculas
+        uint8_t k = n < 0xFF ? n : 0xFF;
+        *literal = reader->src;
+        reader->src += k;
+        return k;
     }
 
-    // Desenha cada linha do caractere
-    for (uint8_t i = 0; i < 8; ++i)
+    if (reader->count == 0)
     {
-        uint8_t line = font[index + i];
-        for (uint8_t j = 0; j < 8; ++j)
+        uint8_t control = *reader->src++;
+        reader->repeat = control & 0x80;
+        if (reader->repeat)
         {
-            ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
+            reader->count = (control & 0x7F) + 2;
+            reader->value = *reader->src++;
         }
+        else
+            reader->count = control + 1;
+    }
+
+    uint8_t k = n < reader->count ? n : reader->count;
+    reader->count -= k;
+    if (reader->repeat)
+    {
+        *literal = NULL;
+        *value = reader->value;
+        return k;
     }
+    *literal = reader->src;
+    reader->src += k;
+    return k;
 }
 
-// Desenha um ícone na posição (x, y) com base no ID fornecido
-void ssd1306_draw_icon(ssd1306_t *ssd, const int id, uint8_t x, uint8_t y)
+// Descarta os próximos n bytes (colunas e páginas fora do display)
+static void bitmap_skip(bitmap_reader_t *reader, size_t n)
+{
+    const uint8_t *literal;
+    uint8_t value;
+    while (n)
+        n -= bitmap_next(reader, n, &literal, &value);
+}
+
+// Combina um byte da imagem (value, nas linhas rows) com um byte do buffer
+static inline void ssd1306_blit_byte(uint8_t *byte, uint8_t value, uint8_t rows, ssd1306_mode_t mode)
+{
+    if (mode == SSD1306_COPY)
+        *byte = (*byte & ~rows) | value; // As linhas fora da imagem são zero em value
+    else
+        ssd1306_apply(byte, value, mode);
+}
+
+// Desenha um bitmap com o canto superior esquerdo em (x, y), recortado nas bordas, no modo especificado
+void ssd1306_blit(ssd1306_t *ssd, const bitmap_t *bitmap, int16_t x, int16_t y, ssd1306_mode_t mode)
 {
-    // Desenha cada linha do ícone
-    for (uint8_t i = 0; i < 8; ++i)
+    if (!bitmap->width || !bitmap->height)
+        return;
+
+    // Área visível
+    int16_t x0 = x < 0 ? 0 : x;
+    int16_t y0 = y < 0 ? 0 : y;
+    int16_t x1 = x + bitmap->width - 1;
+    int16_t y1 = y + bitmap->height - 1;
+    if (x1 >= ssd->width)
+        x1 = ssd->width - 1; // Recorta na borda direita
+    if (y1 >= ssd->height)
+        y1 = ssd->height - 1; // Recorta na borda inferior
+    if (x0 > x1 || y0 > y1)
+        return;
+    ssd1306_mark_dirty(ssd, x0, y0, x1, y1);
+
+    // Cada byte da imagem cobre a parte de baixo da página page0 + p e a parte de cima da seguinte
+    uint8_t shift = y & 0b111;
+    int page0 = (y - shift) / 8; // Negativa se a imagem começa acima do display
+    uint8_t last_rows = 0xFF >> (bitmap->pages * 8 - bitmap->height); // Linhas válidas da última página
+    size_t left = x0 - x, visible = x1 - x0 + 1, right = bitmap->width - left - visible;
+
+    bitmap_reader_t reader = {bitmap->data, bitmap->format, 0, false, 0};
+    for (uint8_t p = 0; p < bitmap->pages; ++p)
     {
-        uint8_t line = icon[id * 8 + i]; // Obtém a linha do ícone
-        for (uint8_t j = 0; j < 8; ++j)
+        int page = page0 + p;
+        if (page >= ssd->pages)
+            break; // Abaixo do display: nada mais é visível
+        bool low = page >= 0;                  // A parte de baixo do byte cai em uma página do display
+        bool high = shift && page + 1 < ssd->pages && page + 1 >= 0; // A parte de cima cai na página seguinte
+        if (!low && !high)
         {
-            ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do ícone
+            bitmap_skip(&reader, bitmap->width); // Página inteira acima do display
+            continue;
         }
+
+        uint8_t rows = p == bitmap->pages - 1 ? last_rows : 0xFF;
+        uint8_t low_rows = rows << shift, high_rows = shift ? rows >> (8 - shift) : 0;
+        uint8_t *dest = ssd->ram_buffer + 1 + x0 * ssd->pages + page; // Percorre a linha de páginas com passo pages
+
+        bitmap_skip(&reader, left);
+        for (size_t n = visible; n;)
+        {
+            const uint8_t *literal;
+            uint8_t value = 0;
+            uint8_t k = bitmap_next(&reader, n, &literal, &value);
+            n -= k;
+
+            if (!literal && value == 0 && mode != SSD1306_COPY)
+            {
+                dest += k * ssd->pages; // Sequência apagada: não altera o buffer nos modos OR, XOR e apagar
+                continue;
+            }
+            for (uint8_t i = 0; i < k; ++i, dest += ssd->pages)
+            {
+                uint8_t v = literal ? literal[i] : value;
+                if (low)
+                    ssd1306_blit_byte(dest, v << shift, low_rows, mode);
+                if (high)
+                    ssd1306_blit_byte(dest + 1, v >> (8 - shift), high_rows, mode);
+            }
+        }
+        bitmap_skip(&reader, right);
     }
 }
 
+// Desenha um ícone na posição (x, y) com base no ID fornecido
+void ssd1306_draw_icon(ssd1306_t *ssd, const int id, uint8_t x, uint8_t y)
+{
+    ssd1306_draw_columns(ssd, &icon[id * 8], 8, x, y); // Os ícones usam o mesmo formato da fonte
+}
+
 // Desenha uma string na posição (x, y)
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
 {
@@ -1,10 +1,31 @@
+#pragma once
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "i2c_bus.h"
+#include "bitmap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 #define WIDTH 128 // Largura do display OLED
 #define HEIGHT 64 // Altura do display OLED
 
+#define SSD1306_MAX_PAGES 8     // Número máximo de páginas suportadas (displays de até 64 linhas)
+#define SSD1306_CMDLIST_SIZE 32 // Capacidade de uma lista de comandos (byte de controle + comandos)
+
+// Tamanho do cabeçalho de uma janela: 6 comandos precedidos de 0x80 (Co = 1) e o byte de controle de dados 0x40
+#define SSD1306_WINDOW_HEADER 13
+
+// Tamanhos dos buffers do driver para um display width x height (para alocação estática)
+#define SSD1306_BUFFER_SIZE(width, height) ((width) * ((height) / 8) + 1)                          // ram_buffer: 0x40 + quadro
+#define SSD1306_TX_BUFFER_SIZE(width, height) (SSD1306_BUFFER_SIZE(width, height) + SSD1306_WINDOW_HEADER) // tx_buffer
+#define SSD1306_DMA_BUFFER_WORDS(width, height) \
+    (SSD1306_BUFFER_SIZE(width, height) + SSD1306_MAX_PAGES * SSD1306_WINDOW_HEADER + 2) // dma_buffer, em palavras de 16 bits
+
 // Enumeração dos comandos suportados pelo display SSD1306
 typedef enum
 {
@@ -28,7 +49,7 @@ typedef enum
 } ssd1306_command_t;
 
 // Estrutura para armazenar o estado e configurações do display SSD1306
-typedef struct
+typedef struct ssd1306
 {
     uint8_t width, height, pages, address; // Dimensões e endereço I2C do display
     i2c_inst_t *i2c_port;                  // Instância do barramento I2C
@@ -36,25 +57,125 @@ typedef struct
     uint8_t *ram_buffer;                   // Buffer de memória para o conteúdo do display
     size_t bufsize;                        // Tamanho do buffer de memória
     uint8_t port_buffer[2];                // Buffer temporário para envio de comandos/dados
+    uint8_t *tx_buffer;                    // Buffer de transmissão para o envio de janelas parciais
+    uint8_t dirty_x0[SSD1306_MAX_PAGES];   // Primeira coluna alterada em cada página desde o último envio
+    uint8_t dirty_x1[SSD1306_MAX_PAGES];   // Última coluna alterada em cada página (x0 > x1 indica página limpa)
+    uint8_t start_line;                    // Linha da memória exibida no topo da tela (rolagem por hardware)
+    bool start_line_pending;               // start_line ainda não foi enviada ao display
+
+    // Envio assíncrono: ram_buffer é o quadro em desenho (back) e dma_buffer o quadro em transmissão (front)
+    uint16_t *dma_buffer;                      // Quadro em transmissão, no formato de palavras do registrador IC_DATA_CMD
+    size_t dma_len;                            // Número de palavras válidas em dma_buffer
+    int dma_channel;                           // Canal de DMA do envio assíncrono (-1 se não configurado)
+    volatile bool flush_busy;                  // Indica se há um envio assíncrono em andamento
+    void (*flush_callback)(struct ssd1306 *);  // Chamada quando um envio assíncrono termina
+
+    // Barramento compartilhado (opcional): o quadro segue em transações de uma página, entre as quais
+    // transações mais urgentes de outros dispositivos podem ser atendidas
+    i2c_bus_t *bus;                              // NULL: o display usa o controlador I2C diretamente
+    uint8_t bus_priority;                        // Classe das transações do display (i2c_priority_t)
+    i2c_xfer_t bus_chunks[SSD1306_MAX_PAGES + 1]; // Uma transação por página, mais a linha inicial
+    uint8_t bus_pending;                         // Transações do quadro ainda não concluídas
+    bool bus_failed;                             // Alguma transação do quadro falhou
+
+    uint32_t tx_transactions; // Transações I2C enviadas desde a última chamada de ssd1306_reset_stats
+    uint32_t tx_bytes;        // Bytes enviados (incluindo o endereço) desde a última chamada de ssd1306_reset_stats
 } ssd1306_t;
 
+// Modos de desenho das operações de preenchimento e de ssd1306_blit
+typedef enum
+{
+    SSD1306_SET,   // Liga os pixels (no blit: OR com a imagem)
+    SSD1306_CLEAR, // Desliga os pixels (no blit: apaga onde a imagem é 1)
+    SSD1306_XOR,   // Inverte os pixels (no blit: XOR com a imagem)
+    SSD1306_COPY   // No blit, substitui a área pela imagem; no preenchimento equivale a SSD1306_SET
+} ssd1306_mode_t;
+
+// Lista de comandos enviada ao display em uma única transação I2C
+typedef struct
+{
+    uint8_t buffer[SSD1306_CMDLIST_SIZE]; // Byte de controle 0x00 seguido dos comandos
+    uint8_t length;                       // Número de bytes válidos no buffer
+} ssd1306_cmdlist_t;
+
 // Protótipos das funções para controle do display SSD1306
 
-// Inicializa o display SSD1306
+// Inicializa o display SSD1306 (buffers alocados com calloc e nunca liberados; para alocação estática,
+// use ssd1306_init_with_buffers, como o firmware)
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 
+// Inicializa o display SSD1306 com buffers fornecidos pelo chamador, dimensionados com as macros SSD1306_*_SIZE
+// dma_buffer pode ser NULL: nesse caso ssd1306_async_init o aloca
+void ssd1306_init_with_buffers(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address,
+                               i2c_inst_t *i2c, uint8_t *ram_buffer, uint8_t *tx_buffer, uint16_t *dma_buffer);
+
 // Configura o display com parâmetros padrão
 void ssd1306_config(ssd1306_t *ssd);
 
 // Envia um comando para o display
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 
+// Inicia uma lista de comandos vazia
+void ssd1306_cmdlist_begin(ssd1306_cmdlist_t *list);
+
+// Acrescenta um comando (ou parâmetro) à lista, enviando-a antes caso esteja cheia
+void ssd1306_cmdlist_add(ssd1306_t *ssd, ssd1306_cmdlist_t *list, uint8_t command);
+
+// Envia todos os comandos da lista em uma única transação I2C
+void ssd1306_cmdlist_send(ssd1306_t *ssd, ssd1306_cmdlist_t *list);
+
 // Envia o conteúdo do buffer de memória para o display
 void ssd1306_send_data(ssd1306_t *ssd);
 
+// Envia para o display apenas as regiões alteradas desde o último envio
+void ssd1306_send_dirty(ssd1306_t *ssd);
+
+// Configura o envio assíncrono via DMA (retorna false se não houver canal de DMA livre ou memória)
+// Sem dma_buffer fornecido na inicialização, o buffer do DMA é alocado aqui com calloc
+bool ssd1306_async_init(ssd1306_t *ssd);
+
+// Envia o display pelo barramento compartilhado, com a prioridade indicada, em vez de usar o controlador diretamente
+// O barramento passa a ser conduzido por quem chama ssd1306_flush_poll ou i2c_bus_poll
+// Como em ssd1306_async_init, sem dma_buffer fornecido, o buffer das transações é alocado com calloc
+bool ssd1306_attach_bus(ssd1306_t *ssd, i2c_bus_t *bus, i2c_priority_t priority);
+
+// Define a função chamada ao término de cada envio assíncrono
+void ssd1306_set_flush_callback(ssd1306_t *ssd, void (*callback)(ssd1306_t *ssd));
+
+// Inicia o envio assíncrono do quadro (completo ou apenas as regiões alteradas); retorna false se houver envio em andamento
+bool ssd1306_flush_start(ssd1306_t *ssd, bool full);
+
+// Verifica o andamento do envio assíncrono; retorna true quando não há envio pendente
+bool ssd1306_flush_poll(ssd1306_t *ssd);
+
+// Aguarda o término do envio assíncrono em andamento
+void ssd1306_flush_wait(ssd1306_t *ssd);
+
+// Zera os contadores de transações e bytes enviados
+void ssd1306_reset_stats(ssd1306_t *ssd);
+
+// Estima o tempo de barramento, em microssegundos, de bytes e transações a uma dada frequência de I2C
+uint32_t ssd1306_bus_time_us(uint32_t bytes, uint32_t transactions, uint32_t baudrate);
+
+// Marca a região (x0..x1, y0..y1) como alterada para o próximo envio incremental
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
+
+// Define a linha da memória exibida no topo da tela; o comando segue no próximo envio, após os dados
+void ssd1306_set_start_line(ssd1306_t *ssd, uint8_t line);
+
+// Troca o buffer de desenho por outro de mesmo tamanho (p.ex. um quadro recebido pela USB)
+// Retorna o buffer anterior; o quadro inteiro é marcado como alterado
+uint8_t *ssd1306_swap_buffer(ssd1306_t *ssd, uint8_t *buffer);
+
+// Copia a janela (x0..x1, páginas page0..page1) de outro buffer no layout do ram_buffer e a marca como alterada
+void ssd1306_copy_window(ssd1306_t *ssd, const uint8_t *src, uint8_t x0, uint8_t page0, uint8_t x1, uint8_t page1);
+
 // Desenha um pixel na posição (x, y) com o valor especificado (ligado/desligado)
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 
+// Preenche a área (x0..x1, y0..y1) no modo especificado
+void ssd1306_fill_area(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, ssd1306_mode_t mode);
+
 // Preenche todo o display com o valor especificado (ligado/desligado)
 void ssd1306_fill(ssd1306_t *ssd, bool value);
 
@@ -70,11 +191,26 @@ void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value
 // Desenha uma linha vertical entre os pontos (x, y0) e (x, y1)
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 
-// Desenha um caractere na posição (x, y)
+// Desenha uma sequência de colunas de 8 pixels (bit 0 no topo) a partir de (x, y), sobrescrevendo o fundo
+void ssd1306_draw_columns(ssd1306_t *ssd, const uint8_t *columns, uint8_t count, uint8_t x, uint8_t y);
+
+// Desenha um caractere na posição (x, y), ocupando a célula inteira da fonte (texto monoespaçado)
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
 
+// Desenha um texto com largura proporcional a partir de (x, y), sem quebra de linha
+// Retorna a posição x após o último caractere desenhado
+uint8_t ssd1306_draw_text(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
 // Desenha uma string na posição (x, y)
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
 
+// Desenha um bitmap com o canto superior esquerdo em (x, y), recortado nas bordas, no modo especificado
+// Os dados são decodificados direto da flash para o ram_buffer, sem cópia intermediária do quadro
+void ssd1306_blit(ssd1306_t *ssd, const bitmap_t *bitmap, int16_t x, int16_t y, ssd1306_mode_t mode);
+
 // Desenha um ícone na posição (x, y) com base no ID fornecido
-void ssd1306_draw_icon(ssd1306_t *ssd, const int id, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_icon(ssd1306_t *ssd, const int id, uint8_t x, uint8_t y);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include "trace.h"
+#include "hardware/sync.h"
+
+#define TRACE_EVENTS_PER_LINE 8
+
+trace_ring_t trace_rings[TRACE_CORES];
+
+// Registra um evento na fila do núcleo atual (descartado se estiver cheia)
+// Executada da RAM: o registro não pode esperar pela cache da flash
+void __not_in_flash_func(trace_record)(trace_id_t id, trace_phase_t phase, uint16_t arg)
+{
+    trace_ring_t *ring = &trace_rings[get_core_num()];
+
+    // Cada núcleo escreve apenas na própria fila, sem travas entre os núcleos; as interrupções ficam
+    // mascaradas por poucas instruções para que uma interrupção no mesmo núcleo não divida o slot
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t head = ring->head;
+    if (head - ring->tail == TRACE_RING_SIZE)
+        ring->dropped++;
+    else
+    {
+        trace_event_t *event = &ring->events[head & (TRACE_RING_SIZE - 1)];
+        event->time_us = time_us_32();
+        event->id = id;
+        event->phase = phase;
+        event->arg = arg;
+        __dmb();               // O evento precisa estar visível antes do novo índice
+        ring->head = head + 1;
+    }
+    restore_interrupts(irq_state);
+}
+
+// Esvazia as filas de ambos os núcleos no stdio, em linhas "#trace" lidas por tools/trace_decode.py
+// Os eventos seguem em hexadecimal (tempo, id, fase, argumento), imunes à conversão de fim de linha do stdio
+void trace_dump(void)
+{
+    printf("#trace begin\n");
+    for (uint core = 0; core < TRACE_CORES; ++core)
+    {
+        trace_ring_t *ring = &trace_rings[core];
+        uint32_t head = ring->head;
+        __dmb();
+        uint n = 0;
+        for (uint32_t tail = ring->tail; tail != head; ++tail, ++n)
+        {
+            const trace_event_t *event = &ring->events[tail & (TRACE_RING_SIZE - 1)];
+            if (n % TRACE_EVENTS_PER_LINE == 0)
+                printf(n ? "\n#trace %u " : "#trace %u ", core);
+            printf("%08lx%02x%02x%04x", (unsigned long)event->time_us, event->id, event->phase, event->arg);
+        }
+        if (n)
+            printf("\n");
+        __dmb();
+        ring->tail = head;
+    }
+    printf("#trace dropped %lu %lu\n", (unsigned long)trace_rings[0].dropped, (unsigned long)trace_rings[1].dropped);
+    printf("#trace end\n");
+}
+
+// Descarta os eventos pendentes e zera os contadores de descarte
+void trace_reset(void)
+{
+    for (uint core = 0; core < TRACE_CORES; ++core)
+    {
+        trace_rings[core].tail = trace_rings[core].head;
+        trace_rings[core].dropped = 0;
+    }
+}
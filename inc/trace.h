@@ -0,0 +1,87 @@
+#pragma once
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRACE_RING_SIZE 512 // Eventos por núcleo (potência de 2)
+#define TRACE_CORES 2
+
+// Identificadores dos eventos; tools/trace_decode.py lê os nomes desta enumeração, então a ordem importa
+typedef enum
+{
+    TRACE_MAIN_LOOP,   // Iteração do laço principal (núcleo 0)
+    TRACE_BUTTON_ISR,  // Interrupção dos botões
+    TRACE_SEND_DATA,   // ssd1306_send_data
+    TRACE_COMMAND,     // ssd1306_command
+    TRACE_WRITE_LEDS,  // write_leds
+    TRACE_OLED_FRAME,  // Quadro do display, do início do envio assíncrono ao seu término (núcleo 1)
+    TRACE_RENDER_CMD,  // Comando executado pelo serviço de renderização (arg = operação)
+    TRACE_BENCHMARK,   // Eventos de medição do próprio rastreamento
+    TRACE_BUTTON_EDGE, // Borda de um botão (arg = gpio << 1 | nível lido), exportada por trace_decode.py --bounce
+} trace_id_t;
+
+// Fase do evento: início e fim de um intervalo, ou evento instantâneo
+typedef enum
+{
+    TRACE_PHASE_BEGIN,
+    TRACE_PHASE_END,
+    TRACE_PHASE_INSTANT,
+} trace_phase_t;
+
+// Evento compacto: 8 bytes
+typedef struct
+{
+    uint32_t time_us; // Timer de 1 MHz
+    uint8_t id;       // trace_id_t
+    uint8_t phase;    // trace_phase_t
+    uint16_t arg;     // Argumento livre
+} trace_event_t;
+
+// Fila circular de um núcleo: apenas ele produz, e quem esvazia o rastreamento consome
+typedef struct
+{
+    trace_event_t events[TRACE_RING_SIZE];
+    volatile uint32_t head;    // Próxima posição de escrita (alterada apenas pelo núcleo dono)
+    volatile uint32_t tail;    // Próxima posição de leitura (alterada apenas pelo consumidor)
+    volatile uint32_t dropped; // Eventos descartados por falta de espaço
+} trace_ring_t;
+
+extern trace_ring_t trace_rings[TRACE_CORES];
+
+// Registra um evento na fila do núcleo atual (descartado se estiver cheia)
+void trace_record(trace_id_t id, trace_phase_t phase, uint16_t arg);
+
+// Esvazia as filas de ambos os núcleos no stdio, em linhas "#trace" lidas por tools/trace_decode.py
+void trace_dump(void);
+
+// Descarta os eventos pendentes e zera os contadores de descarte
+void trace_reset(void);
+
+// Pontos de rastreamento: sem a opção TRACE da compilação, não geram código
+static inline void trace_begin(trace_id_t id)
+{
+#ifdef TRACE
+    trace_record(id, TRACE_PHASE_BEGIN, 0);
+#endif
+}
+
+static inline void trace_end(trace_id_t id)
+{
+#ifdef TRACE
+    trace_record(id, TRACE_PHASE_END, 0);
+#endif
+}
+
+static inline void trace_instant(trace_id_t id, uint16_t arg)
+{
+#ifdef TRACE
+    trace_record(id, TRACE_PHASE_INSTANT, arg);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,137 @@
+#include <string.h>
+#include "ui.h"
+
+static const ui_rect_t ui_no_damage = {.empty = true};
+
+// Geração atual do display: um widget só confia no cache preenchido na mesma geração
+static uint32_t ui_generation;
+
+static void ui_init(ui_widget_t *widget, ui_kind_t kind, uint8_t x, uint8_t y, uint8_t length)
+{
+    memset(widget, 0, sizeof(*widget));
+    widget->kind = kind;
+    widget->x = x;
+    widget->y = y;
+    widget->length = length > UI_TEXT_MAX ? UI_TEXT_MAX : length;
+}
+
+// Cria um rótulo com o número de células indicado (textos menores são completados com espaços)
+void ui_label_init(ui_widget_t *widget, uint8_t x, uint8_t y, uint8_t length)
+{
+    ui_init(widget, UI_LABEL, x, y, length);
+}
+
+// Cria um ícone
+void ui_icon_init(ui_widget_t *widget, uint8_t x, uint8_t y)
+{
+    ui_init(widget, UI_ICON, x, y, 1);
+}
+
+// Cria um campo numérico com o número de dígitos indicado (valores negativos deixam o campo em branco)
+void ui_number_init(ui_widget_t *widget, uint8_t x, uint8_t y, uint8_t digits)
+{
+    ui_init(widget, UI_NUMBER, x, y, digits);
+}
+
+// Descarta o cache: a próxima atualização redesenha o widget inteiro
+void ui_invalidate(ui_widget_t *widget)
+{
+    widget->valid = false;
+}
+
+// Descarta o cache de todos os widgets, p.ex. quando o conteúdo do display é substituído por fora deles
+void ui_invalidate_all(void)
+{
+    ui_generation++; // Sem lista de widgets: cada um percebe a troca na próxima atualização
+}
+
+// Indica se o cache do widget ainda corresponde ao display
+static bool ui_cached(const ui_widget_t *widget)
+{
+    return widget->valid && widget->generation == ui_generation;
+}
+
+// O cache passa a corresponder ao display
+static void ui_cache_fill(ui_widget_t *widget)
+{
+    widget->valid = true;
+    widget->generation = ui_generation;
+}
+
+// Compara as células com o cache e redesenha somente as diferentes
+static ui_rect_t ui_update_cells(ssd1306_t *ssd, ui_widget_t *widget, const char *cells)
+{
+    int first = -1, last = -1;
+    bool cached = ui_cached(widget);
+    for (uint8_t i = 0; i < widget->length; ++i)
+    {
+        if (cached && widget->shown[i] == cells[i])
+            continue;
+
+        // O desenho marca apenas as colunas da célula como alteradas no driver
+        ssd1306_draw_char(ssd, cells[i], widget->x + i * UI_CELL, widget->y);
+        widget->shown[i] = cells[i];
+        widget->cells_drawn++;
+        if (first < 0)
+            first = i;
+        last = i;
+    }
+    ui_cache_fill(widget);
+
+    if (first < 0)
+        return ui_no_damage;
+    ui_rect_t damage = {
+        .x0 = widget->x + first * UI_CELL,
+        .y0 = widget->y,
+        .x1 = widget->x + (last + 1) * UI_CELL - 1,
+        .y1 = widget->y + 7,
+        .empty = false,
+    };
+    return damage;
+}
+
+// Atualiza o texto do rótulo, redesenhando apenas as células alteradas; retorna a região alterada
+ui_rect_t ui_label_set(ssd1306_t *ssd, ui_widget_t *widget, const char *text)
+{
+    char cells[UI_TEXT_MAX];
+    for (uint8_t i = 0; i < widget->length; ++i)
+        cells[i] = *text ? *text++ : ' ';
+    return ui_update_cells(ssd, widget, cells);
+}
+
+// Atualiza o ícone, se mudou; retorna a região alterada
+ui_rect_t ui_icon_set(ssd1306_t *ssd, ui_widget_t *widget, uint8_t id)
+{
+    if (ui_cached(widget) && widget->value == id)
+        return ui_no_damage;
+
+    ssd1306_draw_icon(ssd, id, widget->x, widget->y);
+    widget->value = id;
+    ui_cache_fill(widget);
+    widget->cells_drawn++;
+
+    ui_rect_t damage = {widget->x, widget->y, widget->x + UI_CELL - 1, widget->y + 7, false};
+    return damage;
+}
+
+// Atualiza o número, redesenhando apenas os dígitos alterados; retorna a região alterada
+ui_rect_t ui_number_set(ssd1306_t *ssd, ui_widget_t *widget, int32_t value)
+{
+    if (ui_cached(widget) && widget->value == value)
+        return ui_no_damage;
+    widget->value = value;
+
+    // Alinhado à direita; dígitos que não cabem são descartados à esquerda
+    char cells[UI_TEXT_MAX];
+    memset(cells, ' ', widget->length);
+    if (value >= 0)
+    {
+        int i = widget->length - 1;
+        do
+        {
+            cells[i--] = '0' + value % 10;
+            value /= 10;
+        } while (value && i >= 0);
+    }
+    return ui_update_cells(ssd, widget, cells);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+
+#define UI_TEXT_MAX 16 // Maior número de células de texto de um widget
+#define UI_CELL 8      // Largura de uma célula de texto ou ícone
+
+// Região do display alterada por uma atualização (vazia quando nada mudou)
+typedef struct
+{
+    uint8_t x0, y0, x1, y1;
+    bool empty;
+} ui_rect_t;
+
+// Tipos de widget
+typedef enum
+{
+    UI_LABEL,  // Texto monoespaçado de largura fixa
+    UI_ICON,   // Ícone 8x8
+    UI_NUMBER, // Número alinhado à direita em um campo de largura fixa
+} ui_kind_t;
+
+// Widget retido: guarda o conteúdo exibido para redesenhar apenas o que mudar
+typedef struct
+{
+    uint8_t kind;               // Tipo do widget (ui_kind_t)
+    uint8_t x, y;               // Posição no display
+    uint8_t length;             // Células de texto (rótulo e número) ou 1 (ícone)
+    char shown[UI_TEXT_MAX];    // Caracteres exibidos em cada célula (rótulo e número)
+    int32_t value;              // Ícone ou número exibido
+    bool valid;                 // O conteúdo exibido corresponde ao cache
+    uint32_t generation;        // Geração do display em que o cache foi preenchido (veja ui_invalidate_all)
+    uint32_t cells_drawn;       // Células redesenhadas desde a criação
+} ui_widget_t;
+
+// Cria um rótulo com o número de células indicado (textos menores são completados com espaços)
+void ui_label_init(ui_widget_t *widget, uint8_t x, uint8_t y, uint8_t length);
+
+// Cria um ícone
+void ui_icon_init(ui_widget_t *widget, uint8_t x, uint8_t y);
+
+// Cria um campo numérico com o número de dígitos indicado (valores negativos deixam o campo em branco)
+void ui_number_init(ui_widget_t *widget, uint8_t x, uint8_t y, uint8_t digits);
+
+// Descarta o cache: a próxima atualização redesenha o widget inteiro
+void ui_invalidate(ui_widget_t *widget);
+
+// Descarta o cache de todos os widgets, p.ex. quando o conteúdo do display é substituído por fora deles
+void ui_invalidate_all(void);
+
+// Atualiza o texto do rótulo, redesenhando apenas as células alteradas; retorna a região alterada
+ui_rect_t ui_label_set(ssd1306_t *ssd, ui_widget_t *widget, const char *text);
+
+// Atualiza o ícone, se mudou; retorna a região alterada
+ui_rect_t ui_icon_set(ssd1306_t *ssd, ui_widget_t *widget, uint8_t id);
+
+// Atualiza o número, redesenhando apenas os dígitos alterados; retorna a região alterada
+ui_rect_t ui_number_set(ssd1306_t *ssd, ui_widget_t *widget, int32_t value);
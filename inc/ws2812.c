@@ -0,0 +1,142 @@
+#include <string.h>
+#include "ws2812.h"
+#include "hardware/irq.h"
+
+// Cadeias registradas no tratador de interrupção do DMA
+static ws2812_t *strips[WS2812_MAX_STRIPS];
+
+// Inicia a transmissão do quadro pendente, se a cadeia estiver livre (chamada com a trava obtida)
+// Em contexto de interrupção, apenas troca ponteiros: nenhum quadro é copiado
+static void ws2812_start(ws2812_t *strip)
+{
+    const uint32_t *frame = ws2812_frames_start(&strip->state);
+    if (frame)
+        dma_channel_transfer_from_buffer_now(strip->dma_channel, frame, strip->count);
+}
+
+// Fim do tempo de reset: a cadeia travou o quadro e pode receber o próximo
+static int64_t ws2812_latch_done(alarm_id_t id, void *user_data)
+{
+    ws2812_t *strip = user_data;
+    if (strip->callback)
+        strip->callback(strip);
+
+    // O alarme pode rodar em um núcleo diferente daquele que chama ws2812_show
+    uint32_t irq_state = spin_lock_blocking(strip->lock);
+    ws2812_frames_latched(&strip->state);
+    ws2812_start(strip); // Um novo quadro pode ter sido solicitado durante a transmissão
+    spin_unlock(strip->lock, irq_state);
+    return 0;
+}
+
+// O DMA terminou de alimentar a FIFO: aguarda o esvaziamento da FIFO e o tempo de reset antes de liberar a cadeia
+static void ws2812_dma_handler(void)
+{
+    for (uint i = 0; i < WS2812_MAX_STRIPS; ++i)
+    {
+        ws2812_t *strip = strips[i];
+        if (!strip || !dma_channel_get_irq0_status(strip->dma_channel))
+            continue;
+        dma_channel_acknowledge_irq0(strip->dma_channel);
+
+        // Até WS2812_FIFO_DEPTH palavras na FIFO, mais a que está sendo deslocada, a 24 bits cada
+        uint32_t drain_us = ((WS2812_FIFO_DEPTH + 1) * 24 * WS2812_BIT_NS) / 1000;
+        add_alarm_in_us(drain_us + WS2812_RESET_US, ws2812_latch_done, strip, true);
+    }
+}
+
+// Configura a saída de quadros (retorna false se não houver memória ou canal de DMA livre)
+bool ws2812_init(ws2812_t *strip, PIO pio, uint sm, uint count)
+{
+    strip->pio = pio;
+    strip->sm = sm;
+    strip->count = count;
+    strip->callback = NULL;
+    strip->lock = spin_lock_instance(spin_lock_claim_unused(true));
+
+    // Em edição, solicitado e em transmissão, para que nenhuma troca precise copiar quadros
+    uint32_t *frames = calloc(3 * (size_t)count, sizeof(uint32_t));
+    strip->dma_channel = dma_claim_unused_channel(false);
+    if (!frames || strip->dma_channel < 0)
+        return false;
+    ws2812_frames_init(&strip->state, frames, frames + count, frames + 2 * (size_t)count);
+
+    // Registra a cadeia para o tratador de interrupção compartilhado
+    uint slot = 0;
+    while (slot < WS2812_MAX_STRIPS && strips[slot])
+        ++slot;
+    if (slot == WS2812_MAX_STRIPS)
+        return false;
+    strips[slot] = strip;
+    if (slot == 0)
+    {
+        irq_add_shared_handler(DMA_IRQ_0, ws2812_dma_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+    }
+
+    dma_channel_config config = dma_channel_get_default_config(strip->dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);  // Uma palavra GRB por LED
+    channel_config_set_read_increment(&config, true);             // Percorre o quadro
+    channel_config_set_write_increment(&config, false);           // Sempre na FIFO da máquina de estados
+    channel_config_set_dreq(&config, pio_get_dreq(pio, sm, true)); // Ritmo ditado pela FIFO de transmissão
+    dma_channel_configure(strip->dma_channel, &config, &pio->txf[sm], NULL, count, false);
+    dma_channel_set_irq0_enabled(strip->dma_channel, true);
+    return true;
+}
+
+// Retorna o quadro em edição, onde devem ser escritos os valores dos LEDs
+uint32_t *ws2812_frame(ws2812_t *strip)
+{
+    return ws2812_frames_back(&strip->state);
+}
+
+// Define a cor de um LED no quadro em edição
+void ws2812_set(ws2812_t *strip, uint index, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (index < strip->count)
+        ws2812_frames_back(&strip->state)[index] = ws2812_grb(r, g, b);
+}
+
+// Solicita o envio do quadro em edição; se houver um quadro em transmissão, o envio ocorre ao seu término
+void ws2812_show(ws2812_t *strip, bool keep)
+{
+    uint32_t irq_state = spin_lock_blocking(strip->lock);
+    const uint32_t *shown = ws2812_frames_submit(&strip->state);
+    ws2812_start(strip);
+    spin_unlock(strip->lock, irq_state);
+
+    // O quadro enviado não muda mais (o DMA e as trocas só o leem), então a cópia dispensa a trava
+    if (keep)
+        memcpy(ws2812_frames_back(&strip->state), shown, strip->count * sizeof(uint32_t));
+}
+
+// Solicita o envio de um quadro externo já no formato da FIFO (deve permanecer válido até ser exibido)
+void ws2812_show_frame(ws2812_t *strip, const uint32_t *frame)
+{
+    uint32_t irq_state = spin_lock_blocking(strip->lock);
+    ws2812_frames_submit_external(&strip->state, frame);
+    ws2812_start(strip);
+    spin_unlock(strip->lock, irq_state);
+}
+
+// Retorna true quando não há quadro em transmissão nem envio pendente
+bool ws2812_idle(ws2812_t *strip)
+{
+    uint32_t irq_state = spin_lock_blocking(strip->lock);
+    bool idle = ws2812_frames_idle(&strip->state);
+    spin_unlock(strip->lock, irq_state);
+    return idle;
+}
+
+// Aguarda até que todos os quadros solicitados tenham sido exibidos
+void ws2812_wait(ws2812_t *strip)
+{
+    while (!ws2812_idle(strip))
+        tight_loop_contents();
+}
+
+// Define a função chamada ao término de cada quadro
+void ws2812_set_callback(ws2812_t *strip, void (*callback)(ws2812_t *strip))
+{
+    strip->callback = callback;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/sync.h"
+#include "ws2812_frames.h"
+
+#define WS2812_BIT_NS 1250    // Duração de um bit no protocolo WS2812 (800 kHz)
+#define WS2812_RESET_US 300   // Tempo mínimo em nível baixo para o LED travar o quadro (WS2812B: > 280 us)
+#define WS2812_FIFO_DEPTH 8   // Profundidade da FIFO de transmissão com PIO_FIFO_JOIN_TX
+#define WS2812_MAX_STRIPS 4   // Número máximo de cadeias atendidas pelo tratador de interrupção do DMA
+
+// Estrutura para a saída de quadros de uma fita/matriz WS2812 via PIO + DMA
+typedef struct ws2812
+{
+    PIO pio;                             // Instância da PIO que executa o programa ws2812
+    uint sm;                             // Máquina de estados usada
+    uint count;                          // Número de LEDs na cadeia
+    ws2812_frames_t state;               // Quadros GRB no formato da FIFO e suas trocas (ws2812_frames.h)
+    int dma_channel;                     // Canal de DMA que alimenta a FIFO da PIO
+    spin_lock_t *lock;                   // Protege o estado entre núcleos e interrupções
+    void (*callback)(struct ws2812 *);   // Chamada quando um quadro termina de ser exibido
+} ws2812_t;
+
+// Configura a saída de quadros (retorna false se não houver memória ou canal de DMA livre)
+bool ws2812_init(ws2812_t *strip, PIO pio, uint sm, uint count);
+
+// Retorna o quadro em edição, onde devem ser escritos os valores dos LEDs
+uint32_t *ws2812_frame(ws2812_t *strip);
+
+// Define a cor de um LED no quadro em edição
+void ws2812_set(ws2812_t *strip, uint index, uint8_t r, uint8_t g, uint8_t b);
+
+// Solicita o envio do quadro em edição; se houver um quadro em transmissão, o envio ocorre ao seu término
+// Os quadros são trocados por ponteiro: com keep, o quadro enviado é copiado para o novo quadro em
+// edição (aqui, fora de interrupção); sem keep, o novo quadro em edição contém um quadro anterior
+void ws2812_show(ws2812_t *strip, bool keep);
+
+// Solicita o envio de um quadro externo já no formato da FIFO (deve permanecer válido até ser exibido)
+// O quadro em edição não é alterado
+void ws2812_show_frame(ws2812_t *strip, const uint32_t *frame);
+
+// Retorna true quando não há quadro em transmissão nem envio pendente
+bool ws2812_idle(ws2812_t *strip);
+
+// Aguarda até que todos os quadros solicitados tenham sido exibidos
+void ws2812_wait(ws2812_t *strip);
+
+// Define a função chamada ao término de cada quadro (executada em contexto de interrupção)
+void ws2812_set_callback(ws2812_t *strip, void (*callback)(ws2812_t *strip));
@@ -0,0 +1,63 @@
+#include <stddef.h>
+#include "ws2812_frames.h"
+
+// Prepara o estado com três quadros de mesmo tamanho
+void ws2812_frames_init(ws2812_frames_t *f, uint32_t *a, uint32_t *b, uint32_t *c)
+{
+    f->frames[0] = a;
+    f->frames[1] = b;
+    f->frames[2] = c;
+    f->back = 0;
+    f->ready = 1;
+    f->front = 2;
+    f->busy = false;
+    f->pending = false;
+    f->source = NULL;
+}
+
+// Solicita o envio do quadro em edição, que troca de lugar com o último solicitado
+const uint32_t *ws2812_frames_submit(ws2812_frames_t *f)
+{
+    uint8_t back = f->back;
+    f->back = f->ready; // Se ainda não foi enviado, o pedido anterior é descartado e volta para edição
+    f->ready = back;
+    f->pending = true;
+    f->source = NULL; // Prevalece a solicitação mais recente
+    return f->frames[f->ready];
+}
+
+// Solicita o envio de um quadro externo; o quadro em edição não muda
+void ws2812_frames_submit_external(ws2812_frames_t *f, const uint32_t *frame)
+{
+    f->pending = true;
+    f->source = frame;
+}
+
+// Marca a cadeia ocupada e retorna o quadro a transmitir, se estiver livre e houver envio pendente
+const uint32_t *ws2812_frames_start(ws2812_frames_t *f)
+{
+    if (f->busy || !f->pending)
+        return NULL;
+    f->pending = false;
+    f->busy = true;
+
+    if (f->source)
+    {
+        // Quadro externo: o DMA lê diretamente dele
+        const uint32_t *frame = f->source;
+        f->source = NULL;
+        return frame;
+    }
+
+    // O quadro transmitido anteriormente já foi travado pela cadeia e fica livre em ready
+    uint8_t ready = f->ready;
+    f->ready = f->front;
+    f->front = ready;
+    return f->frames[f->front];
+}
+
+// Fim do tempo de reset: a cadeia travou o quadro e está livre
+void ws2812_frames_latched(ws2812_frames_t *f)
+{
+    f->busy = false;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sem dependências do SDK: o empacotamento e as trocas de quadros de ws2812.c rodam no computador
+
+// Converte uma cor para o formato da FIFO do programa ws2812 (G << 24 | R << 16 | B << 8)
+static inline uint32_t ws2812_grb(uint8_t r, uint8_t g, uint8_t b)
+{
+    return ((uint32_t)g << 24) | ((uint32_t)r << 16) | ((uint32_t)b << 8);
+}
+
+// Três quadros trocados apenas por ponteiro: o quadro em edição (back), o último solicitado (ready)
+// e o quadro em transmissão (front). Solicitar um envio troca back e ready; iniciar a transmissão
+// troca ready e front. Nenhuma transição copia o conteúdo dos quadros.
+typedef struct
+{
+    uint32_t *frames[3];
+    uint8_t back, ready, front; // Índices em frames
+    bool busy;                  // Quadro em transmissão (incluindo o tempo de reset)
+    bool pending;               // Há um quadro solicitado aguardando o fim da transmissão
+    const uint32_t *source;     // Quadro externo solicitado no lugar de ready (NULL se não houver)
+} ws2812_frames_t;
+
+// Prepara o estado com três quadros de mesmo tamanho
+void ws2812_frames_init(ws2812_frames_t *f, uint32_t *a, uint32_t *b, uint32_t *c);
+
+// Quadro em edição
+static inline uint32_t *ws2812_frames_back(const ws2812_frames_t *f)
+{
+    return f->frames[f->back];
+}
+
+// Solicita o envio do quadro em edição, que troca de lugar com o último solicitado; retorna o quadro
+// solicitado, que não muda mais até a próxima solicitação. O novo quadro em edição contém um quadro
+// anterior qualquer.
+const uint32_t *ws2812_frames_submit(ws2812_frames_t *f);
+
+// Solicita o envio de um quadro externo; o quadro em edição não muda
+void ws2812_frames_submit_external(ws2812_frames_t *f, const uint32_t *frame);
+
+// Se a cadeia está livre e há envio pendente, marca a cadeia ocupada e retorna o quadro a transmitir;
+// caso contrário retorna NULL
+const uint32_t *ws2812_frames_start(ws2812_frames_t *f);
+
+// Fim do tempo de reset: a cadeia travou o quadro e está livre
+void ws2812_frames_latched(ws2812_frames_t *f);
+
+// Nenhum quadro em transmissão nem envio pendente
+static inline bool ws2812_frames_idle(const ws2812_frames_t *f)
+{
+    return !f->busy && !f->pending;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,105 @@
+#include "ws2812_parallel.h"
+#include "ws2812.h"
+#include "ws2812_parallel.pio.h"
+
+// Transposição 8x8 de bits em duas palavras de 32 bits (troca de blocos de 1, 2 e 4 bits)
+// Entrada: x = fitas 7..4 e y = fitas 3..0, um byte por fita (fita 7 no byte mais significativo de x)
+// Saída: 8 planos, o primeiro com o bit mais significativo de cada fita; bit s do plano = bit da fita s
+static inline void ws2812_transpose8(uint32_t x, uint32_t y, uint32_t *planes)
+{
+    uint32_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+
+    // A PIO desloca à direita: o primeiro plano precisa estar no byte menos significativo
+    planes[0] = __builtin_bswap32(t);
+    planes[1] = __builtin_bswap32(y);
+}
+
+// Converte os quadros GRB de cada fita (G << 24 | R << 16 | B << 8) em planos de bits
+void ws2812_parallel_pack(uint32_t *planes, const uint32_t *const *frames, uint strips, uint count)
+{
+    const uint32_t *src[WS2812_PARALLEL_MAX_STRIPS];
+    static const uint32_t off = 0;
+    for (uint s = 0; s < WS2812_PARALLEL_MAX_STRIPS; ++s)
+        src[s] = (s < strips && frames[s]) ? frames[s] : &off;
+    uint step[WS2812_PARALLEL_MAX_STRIPS];
+    for (uint s = 0; s < WS2812_PARALLEL_MAX_STRIPS; ++s)
+        step[s] = src[s] != &off; // Fitas ausentes leem sempre a mesma palavra apagada
+
+    for (uint i = 0; i < count; ++i)
+    {
+        uint32_t w[WS2812_PARALLEL_MAX_STRIPS];
+        for (uint s = 0; s < WS2812_PARALLEL_MAX_STRIPS; ++s)
+            w[s] = src[s][i * step[s]];
+
+        // Um byte de cor por vez (G, R, B): junta o byte das 8 fitas e transpõe
+        for (uint shift = 24; shift >= 8; shift -= 8)
+        {
+            uint32_t x = ((w[7] >> shift & 0xff) << 24) | ((w[6] >> shift & 0xff) << 16) |
+                         ((w[5] >> shift & 0xff) << 8) | (w[4] >> shift & 0xff);
+            uint32_t y = ((w[3] >> shift & 0xff) << 24) | ((w[2] >> shift & 0xff) << 16) |
+                         ((w[1] >> shift & 0xff) << 8) | (w[0] >> shift & 0xff);
+            ws2812_transpose8(x, y, planes);
+            planes += 2;
+        }
+    }
+}
+
+// Configura a saída paralela (retorna false se não houver memória, máquina de estados ou canal de DMA livre)
+bool ws2812_parallel_init(ws2812_parallel_t *out, PIO pio, uint pin_base, uint strips, uint count)
+{
+    if (!strips || strips > WS2812_PARALLEL_MAX_STRIPS || !pio_can_add_program(pio, &ws2812_parallel_program))
+        return false;
+
+    out->pio = pio;
+    out->strips = strips;
+    out->count = count;
+    out->latch_at = get_absolute_time();
+    out->planes = calloc(count * WS2812_PARALLEL_WORDS_PER_LED, sizeof(uint32_t));
+    int sm = pio_claim_unused_sm(pio, false);
+    out->dma_channel = dma_claim_unused_channel(false);
+    if (!out->planes || sm < 0 || out->dma_channel < 0)
+        return false;
+    out->sm = sm;
+
+    uint offset = pio_add_program(pio, &ws2812_parallel_program);
+    ws2812_parallel_program_init(pio, sm, offset, pin_base, strips, 1e9f / WS2812_BIT_NS);
+
+    dma_channel_config config = dma_channel_get_default_config(out->dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);  // 4 planos por palavra
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, pio_get_dreq(pio, sm, true)); // Ritmo ditado pela FIFO de transmissão
+    dma_channel_configure(out->dma_channel, &config, &pio->txf[sm], NULL, 0, false);
+    return true;
+}
+
+// Converte os quadros e inicia a transmissão; retorna false se o quadro anterior ainda não foi travado
+bool ws2812_parallel_show(ws2812_parallel_t *out, const uint32_t *const *frames)
+{
+    if (!ws2812_parallel_idle(out))
+        return false;
+
+    ws2812_parallel_pack(out->planes, frames, out->strips, out->count);
+    dma_channel_transfer_from_buffer_now(out->dma_channel, out->planes, out->count * WS2812_PARALLEL_WORDS_PER_LED);
+
+    // A duração não depende do número de fitas: 24 bits por LED, mais o tempo de reset
+    uint32_t frame_us = (out->count * 24 * WS2812_BIT_NS) / 1000;
+    out->latch_at = make_timeout_time_us(frame_us + WS2812_RESET_US);
+    return true;
+}
+
+// Retorna true quando não há quadro em transmissão (incluindo o tempo de reset)
+bool ws2812_parallel_idle(ws2812_parallel_t *out)
+{
+    return time_reached(out->latch_at) && !dma_channel_is_busy(out->dma_channel);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+
+#define WS2812_PARALLEL_MAX_STRIPS 8      // Fitas atendidas por uma máquina de estados (GPIOs consecutivas)
+#define WS2812_PARALLEL_WORDS_PER_LED 6   // 24 planos de bits de 8 bits por LED, 4 planos por palavra
+
+// Saída de até 8 fitas WS2812 em paralelo por uma única máquina de estados, um bit de cada fita por ciclo
+typedef struct
+{
+    PIO pio;                 // Instância da PIO que executa o programa ws2812_parallel
+    uint sm;                 // Máquina de estados usada
+    uint strips;             // Número de fitas (pinos consecutivos a partir do pino base)
+    uint count;              // LEDs por fita
+    uint32_t *planes;        // Planos de bits já no formato da FIFO (count * WS2812_PARALLEL_WORDS_PER_LED palavras)
+    int dma_channel;         // Canal de DMA que alimenta a FIFO da PIO
+    absolute_time_t latch_at; // Instante em que o último quadro terá sido travado pelas fitas
+} ws2812_parallel_t;
+
+// Configura a saída paralela (retorna false se não houver memória, máquina de estados ou canal de DMA livre)
+bool ws2812_parallel_init(ws2812_parallel_t *out, PIO pio, uint pin_base, uint strips, uint count);
+
+// Converte os quadros GRB de cada fita (G << 24 | R << 16 | B << 8) em planos de bits
+// frames[s] é o quadro da fita s; fitas ausentes (NULL ou s >= strips) são enviadas apagadas
+void ws2812_parallel_pack(uint32_t *planes, const uint32_t *const *frames, uint strips, uint count);
+
+// Converte os quadros e inicia a transmissão; retorna false se o quadro anterior ainda não foi travado
+bool ws2812_parallel_show(ws2812_parallel_t *out, const uint32_t *const *frames);
+
+// Retorna true quando não há quadro em transmissão (incluindo o tempo de reset)
+bool ws2812_parallel_idle(ws2812_parallel_t *out);
@@ -4,8 +4,21 @@
 #include "hardware/clocks.h"
 #include "hardware/i2c.h"
 #include "inc/ssd1306.h"
+#include "inc/i2c_bus.h"
+#include "inc/benchmark.h"
 #include "inc/font.h"
 #include "inc/ws2812.pio.h"
+#include "inc/ws2812.h"
+#include "inc/event_queue.h"
+#include "inc/render.h"
+#include "inc/ui.h"
+#include "inc/console.h"
+#include "inc/led_frames.h"
+#include "inc/led_framebuffer.h"
+#include "inc/trace.h"
+#include "inc/protocol.h"
+#include "inc/debounce.h"
+#include "inc/power.h"
 
 // Definição dos pinos para conexão com os LEDs RGB
 #define LED_G_PIN 11
@@ -15,40 +28,50 @@
 #define BTN_A_PIN 5
 #define BTN_B_PIN 6
 
-// Definições para uso dos LEDs na Matriz 5x5
-#define LED_MTX_COUNT 25
-#define LED_MTX_LEVEL 20 // A intensidade está baixa para não causar incômodo (0-255, caso deseje alterar)
+// Pino e lado da Matriz 5x5 (quantidade de LEDs e intensidade em inc/led_frames.h)
 #define LED_MTX_PIN 7
+#define LED_MTX_SIZE 5
 
 // Definições para o uso da comunicação serial I2C
 #define I2C_PORT i2c1
 #define I2C_SDA 14
 #define I2C_SCL 15
 #define ADDRESS 0x3C
-
-#define DEBOUNCE_DELAY_MS 200
-volatile uint32_t last_interrupt_time = 0;
-
-// Pix GRB
-typedef struct pixel_t
-{
-    uint8_t G, R, B;
-} led_t;
-
-led_t led_matrix[LED_MTX_COUNT]; // Buffer de pixels que compõem a matriz
-
-uint32_t led_number_pattern[10] = {
-    0xe5294e, // Número 0
-    0x435084, // Número 1
-    0xe4384e, // Número 2
-    0xe4390e, // Número 3
-    0xa53902, // Número 4
-    0xe1390e, // Número 5
-    0xe4394e, // Número 6
-    0xe40902, // Número 7
-    0xe5394e, // Número 8
-    0xe5390e  // Número 9
-};
+#define SPLASH_MS 1500 // Duração da tela de abertura (images/logo.pbm)
+
+// Debounce independente por botão: a borda inicia a amostragem por timer (DEBOUNCE_SAMPLE_US), que
+// confirma o pressionamento em poucos ms e para quando os dois botões estão em repouso
+#define BUTTON_COUNT 2
+const uint button_pins[BUTTON_COUNT] = {BTN_A_PIN, BTN_B_PIN};
+debounce_t buttons[BUTTON_COUNT];
+repeating_timer_t button_timer;
+volatile bool button_sampling = false; // Amostragem em andamento
+
+// Fila de eventos entre a interrupção dos botões e o laço principal
+event_queue_t input_events;
+
+// Instrumentação do tratamento de eventos
+volatile uint32_t isr_max_us = 0;   // Maior duração observada da interrupção dos botões
+uint32_t event_latency_max_us = 0;  // Maior atraso entre o registro de um evento e seu tratamento
+uint32_t event_latency_total_us = 0; // Soma dos atrasos (para a média)
+uint32_t events_handled = 0;        // Eventos tratados pelo laço principal
+
+// Entrada serial: os caracteres disponíveis a cada despertar são tratados juntos, com no máximo um envio ao display
+#define NUMBER_X 64                           // Posição fixa para exibir números
+#define NUMBER_Y 23
+volatile bool serial_pending = false;         // Há caracteres a ler (sinalizado pela interrupção do stdio)
+volatile uint32_t serial_arrival_us = 0;      // Instante em que chegou o primeiro caractere ainda não lido
+uint32_t serial_chars = 0;                    // Caracteres lidos
+uint32_t serial_batches = 0;                  // Lotes de entrada lidos
+uint32_t serial_batch_max = 0;                // Maior quantidade de caracteres tratados em uma única leitura
+#define SERIAL_BUDGET_US 5000                 // Tempo máximo lendo quadros binários antes de devolver o controle ao laço
+
+led_fb_t led_matrix; // Framebuffer da matriz na ordem da cadeia, enviado diretamente pelo DMA
+
+// Economia de energia: o laço principal dorme em __wfi entre as entradas e, sem entradas por
+// POWER_DIM_MS e POWER_OFF_MS, reduz o contraste e depois desliga o display e apaga a matriz
+power_t power;
+const uint32_t led_off[LED_MTX_COUNT] = {0}; // Quadro apagado da matriz
 
 /*
  * Inicialização das GPIOs
@@ -77,6 +100,7 @@ void init_gpio()
 // Variáveis para uso da PIO
 PIO pio;
 uint sm;
+ws2812_t strip; // Saída de quadros da matriz via DMA
 
 /*
  * Inicialização da PIO
@@ -89,143 +113,625 @@ void init_pio(uint pin)
     sm = pio_claim_unused_sm(pio, false);
 
     ws2812_program_init(pio, sm, offset, pin);
+    ws2812_init(&strip, pio, sm, LED_MTX_COUNT);
+    // Mapa identidade: os quadros dos números (inc/led_frames.cpp) e os recebidos pela USB já vêm na ordem
+    // da cadeia (LED i do quadro = LED i da cadeia) e são copiados sem conversão; o firmware não desenha
+    // por coordenadas na matriz, e pixels é usado apenas como buffer nessa ordem
+    led_fb_init(&led_matrix, LED_MTX_SIZE, LED_MTX_SIZE, LED_MAP_ROWS);
 }
 
 ssd1306_t ssd; // Inicializa a estrutura do display
+
+// Barramento I2C compartilhado: o display envia seus quadros página a página, com a menor prioridade,
+// para que leituras de sensores no mesmo barramento não esperem por um quadro inteiro
+i2c_bus_t i2c_bus;
+
+// Buffers do display alocados estaticamente (sem calloc)
+uint8_t ssd_ram[SSD1306_BUFFER_SIZE(WIDTH, HEIGHT)];
+uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(WIDTH, HEIGHT)];
+uint16_t ssd_dma[SSD1306_DMA_BUFFER_WORDS(WIDTH, HEIGHT)];
+
+// Widgets da interface: cada atualização redesenha apenas o que mudou
+ui_widget_t green_label;  // Estado do LED verde
+ui_widget_t blue_label;   // Estado do LED azul
+ui_widget_t status_icon;  // Ícone dos LEDs ligados
+ui_widget_t number_field; // Último número digitado
+
+#ifdef SERIAL_CONSOLE
+// Modo console: a entrada serial é exibida como um log rolante, no lugar da interface
+console_t console;
+char console_input[CONSOLE_COLS + 1]; // Linha em digitação
+uint console_input_len = 0;
+#endif
+
+// Quadros recebidos pela USB (tools/frame_sender.py): os dados são gravados direto no buffer inativo do
+// display ou da matriz, que o núcleo 1 passa a exibir ao fim do quadro, sem cópias intermediárias
+proto_parser_t link;
+uint8_t ssd_remote[SSD1306_BUFFER_SIZE(WIDTH, HEIGHT)]; // Segunda metade do buffer duplo do display
+uint8_t *oled_back = ssd_remote;                        // Buffer inativo do display (o ativo está com o núcleo 1)
+uint32_t led_remote[LED_MTX_COUNT];                     // Segunda metade do buffer duplo da matriz
+uint32_t *led_back = led_remote;                        // Buffer inativo da matriz
+uint16_t link_length;                                   // Comprimento do quadro em recepção
+uint8_t link_window[4];                                 // Janela de PROTO_OLED_PATCH: x0, página 0, x1, página 1
+bool link_window_ok = false;                            // Janela válida e coerente com o comprimento
+uint8_t link_x, link_page;                              // Posição do próximo byte da janela
+uint8_t link_control[2];                                // Código e argumento de PROTO_CONTROL
+bool link_applied = false;                              // Algum quadro alterou o display na leitura atual
+
 void init_display()
 {
-    ssd1306_init(&ssd, WIDTH, HEIGHT, false, ADDRESS, I2C_PORT); // Inicializa o display
+    ssd1306_init_with_buffers(&ssd, WIDTH, HEIGHT, false, ADDRESS, I2C_PORT, ssd_ram, ssd_tx, ssd_dma); // Inicializa o display
+    ssd1306_attach_bus(&ssd, &i2c_bus, I2C_PRIO_BULK);           // Todo o tráfego do display passa pelo barramento
     ssd1306_config(&ssd);                                        // Configura o display
     ssd1306_send_data(&ssd);                                     // Envia os dados para o display
 
+#ifdef BENCHMARK
+    benchmark_run(&ssd); // Mede as primitivas de desenho e o envio ao display
+#endif
+
+    // Tela de abertura, decodificada da flash direto no buffer do display
+    ssd1306_blit(&ssd, &bitmap_logo, 0, 0, SSD1306_COPY);
+    ssd1306_send_data(&ssd);
+    sleep_ms(SPLASH_MS);
+
     // Limpa o display
     ssd1306_fill(&ssd, false);
     ssd1306_send_data(&ssd);
 
+#ifdef SERIAL_CONSOLE
+    // Cada nova linha é enviada sozinha; a rolagem apenas gira a linha inicial do display
+    console_init(&console, &ssd);
+    console_write_line(&console, "Console serial");
+#else
     // Valores iniciais
-    ssd1306_draw_string(&ssd, "Digite o que deseja!", 8, 10);
-    ssd1306_draw_string(&ssd, "G OFF", 8, 48);
-    ssd1306_draw_icon(&ssd, 2, 58, 48);
-    ssd1306_draw_string(&ssd, "B OFF", 80, 48);
+    ssd1306_draw_text(&ssd, "Digite o que deseja!", 8, 10); // Texto proporcional: cabe em uma linha
+    ui_label_init(&green_label, 8, 48, 5);
+    ui_icon_init(&status_icon, 58, 48);
+    ui_label_init(&blue_label, 80, 48, 5);
+    ui_number_init(&number_field, NUMBER_X, NUMBER_Y, 1);
+    ui_label_set(&ssd, &green_label, "G OFF");
+    ui_icon_set(&ssd, &status_icon, 2);
+    ui_label_set(&ssd, &blue_label, "B OFF");
+    ui_number_set(&ssd, &number_field, -1); // Em branco até o primeiro número
+#endif
     ssd1306_send_data(&ssd);
+
+    // A partir daqui as atualizações seguem pelo DMA do barramento, sem bloquear a CPU
 }
 
 /*
- * Atribuição de cor a um LED
+ * Limpeza do buffer de LEDs
  */
-void set_led(const uint id, const uint8_t R, const uint8_t G, const uint8_t B)
+void clear_leds()
 {
-    led_matrix[id].R = R;
-    led_matrix[id].G = G;
-    led_matrix[id].B = B;
+    led_fb_fill(&led_matrix, 0);
 }
 
 /*
- * Limpeza do buffer de LEDs
+ * Transferência dos valores do buffer para a matriz de LEDs
+ * O framebuffer já está no formato da FIFO e é entregue ao DMA, sem esperar a transmissão terminar
  */
-void clear_leds()
+void write_leds()
+{
+    trace_begin(TRACE_WRITE_LEDS);
+    ws2812_show_frame(&strip, led_matrix.pixels);
+    trace_end(TRACE_WRITE_LEDS);
+}
+
+volatile bool green_led_on = false;
+volatile bool blue_led_on = false;
+volatile int number_id = -1;
+
+/*
+ * Exibe o número na matriz com a cor dos LEDs verde e azul
+ * O quadro vem pronto da tabela em flash (inc/led_frames.cpp) e é enviado pelo DMA sem cálculo por LED
+ */
+void set_led_by_number(uint number)
+{
+    render_led_frame(led_frame(number, led_frame_mode(green_led_on, blue_led_on)));
+}
+
+/*
+ * Amostragem dos botões (interrupção do timer): alimenta o debounce e enfileira os eventos confirmados
+ * Retorna false para parar o timer quando todos os botões estão em repouso
+ */
+bool button_sample(repeating_timer_t *timer)
+{
+    uint32_t now = time_us_32();
+    bool idle = true;
+    for (uint i = 0; i < BUTTON_COUNT; ++i)
+    {
+        uint32_t time_us;
+        debounce_event_t result = debounce_sample(&buttons[i], !gpio_get(button_pins[i]), now, &time_us);
+        if (result != DEBOUNCE_NONE)
+        {
+            event_t event = {.time_us = time_us, .type = EVENT_BUTTON_PRESS + result - DEBOUNCE_PRESS, .data = button_pins[i]};
+            event_queue_push(&input_events, &event);
+        }
+        idle &= debounce_idle(&buttons[i]);
+    }
+
+    if (idle)
+        button_sampling = false; // A próxima borda reinicia o timer
+    return !idle;
+}
+
+/*
+ * Interrupção dos botões: registra a borda e inicia a amostragem, se estiver parada
+ */
+void button_callback(uint gpio, uint32_t events)
 {
-    for (uint i = 0; i < LED_MTX_COUNT; i++)
+    uint32_t start = time_us_32();
+    trace_begin(TRACE_BUTTON_ISR);
+    trace_instant(TRACE_BUTTON_EDGE, gpio << 1 | gpio_get(gpio)); // Bordas para reproduzir no debounce_replay
+
+    for (uint i = 0; i < BUTTON_COUNT; ++i)
+        if (button_pins[i] == gpio)
+            debounce_edge(&buttons[i], start);
+
+    // O timer e a GPIO são atendidos pelo mesmo núcleo, sem aninhamento: não há corrida com button_sample
+    if (!button_sampling)
     {
-        led_matrix[i].R = 0;
-        led_matrix[i].G = 0;
-        led_matrix[i].B = 0;
+        button_sampling = true;
+        add_repeating_timer_us(-DEBOUNCE_SAMPLE_US, button_sample, NULL, &button_timer);
     }
+
+    uint32_t elapsed = time_us_32() - start;
+    if (elapsed > isr_max_us)
+        isr_max_us = elapsed;
+    trace_end(TRACE_BUTTON_ISR);
 }
 
-// Formatação do valor GRB
-uint32_t rgb_value(uint8_t B, uint8_t R, uint8_t G)
+/*
+ * Exibe o estado dos LEDs: nos widgets da interface ou, no modo console, como uma linha do log
+ */
+void show_led_status(uint gpio)
 {
-    return (G << 24) | (R << 16) | (B << 8);
+#ifdef SERIAL_CONSOLE
+    if (gpio == BTN_A_PIN)
+        render_console_line(&console, green_led_on ? "LED Verde ON" : "LED Verde OFF");
+    else
+        render_console_line(&console, blue_led_on ? "LED Azul ON" : "LED Azul OFF");
+#else
+    // Os widgets redesenham apenas os caracteres alterados
+    if (gpio == BTN_A_PIN)
+        render_ui_label(&green_label, green_led_on ? "G ON" : "G OFF");
+    else
+        render_ui_label(&blue_label, blue_led_on ? "B ON" : "B OFF");
+
+    // Atualiza o ícone no display de acordo com os LEDs ligados/desligados
+    if (green_led_on && blue_led_on)
+        render_ui_icon(&status_icon, 0); // Ambos ligados
+    else if (green_led_on || blue_led_on)
+        render_ui_icon(&status_icon, 1); // Apenas um ligado
+    else
+        render_ui_icon(&status_icon, 2); // Ambos desligados
+#endif
 }
 
 /*
- * Transferência dos valores do buffer para a matriz de LEDs
+ * Tratamento de um pressionamento confirmado no laço principal
+ * O debounce é feito por botão: pressionar A logo após B não descarta nenhum dos dois
  */
-void write_leds()
+void handle_button(uint gpio)
 {
-    uint32_t value;
-    for (uint i = 0; i < LED_MTX_COUNT; ++i)
+    // Alterna o estado do LED verde se o botão A for pressionado
+    if (gpio == BTN_A_PIN)
+    {
+        green_led_on = !green_led_on;
+        gpio_put(LED_G_PIN, green_led_on);
+        printf(green_led_on ? "LED Verde ON\n" : "LED Verde OFF\n");
+    }
+    // Alterna o estado do LED azul se o botão B for pressionado
+    else if (gpio == BTN_B_PIN)
     {
-        value = rgb_value(led_matrix[i].B, led_matrix[i].R, led_matrix[i].G);
-        pio_sm_put_blocking(pio, sm, value);
+        blue_led_on = !blue_led_on;
+        gpio_put(LED_B_PIN, blue_led_on);
+        printf(blue_led_on ? "LED Azul ON\n" : "LED Azul OFF\n");
+    }
+    show_led_status(gpio); // Atualiza o display
+
+    // Atualiza os LEDs da matriz se um número válido estiver selecionado
+    if (number_id >= 0 && number_id <= 9)
+    {
+        set_led_by_number(number_id); // Define o padrão dos LEDs e envia à matriz
     }
 }
 
 /*
- * Decodificação do padrão binário para LEDs da matriz
+ * Pressionamento longo de qualquer botão: apaga o número da matriz e do display
  */
+void handle_long_press(uint gpio)
+{
+    printf("Botao %c longo: numero apagado\n", gpio == BTN_A_PIN ? 'A' : 'B');
+    number_id = -1;
+    render_led_frame(led_off);
+#ifndef SERIAL_CONSOLE
+    render_ui_number(&number_field, -1);
+#endif
+}
 
-volatile bool green_led_on = false;
-volatile bool blue_led_on = false;
-volatile int number_id = -1;
+/*
+ * Trata todos os eventos pendentes na fila; o envio ao display fica a cargo do laço principal
+ * Retorna true se algum evento foi tratado
+ */
+bool dispatch_events()
+{
+    event_t event;
+    bool handled = false;
+    while (event_queue_pop(&input_events, &event))
+    {
+        if (event.type == EVENT_BUTTON_PRESS)
+            handle_button(event.data);
+        else if (event.type == EVENT_BUTTON_LONG_PRESS)
+            handle_long_press(event.data);
+
+        uint32_t latency = time_us_32() - event.time_us;
+        if (latency > event_latency_max_us)
+            event_latency_max_us = latency;
+        event_latency_total_us += latency;
+        events_handled++;
+        handled = true;
+    }
+    return handled;
+}
 
-void set_led_by_pattern(uint32_t pattern)
+/*
+ * Exibe as estatísticas do tratamento de eventos no Serial Monitor
+ */
+void print_stats()
 {
-    uint lvl = LED_MTX_LEVEL;
-    for (uint i = 0; i < LED_MTX_COUNT; i++)
+    printf("Eventos: %lu tratados, %lu descartados\n", (unsigned long)events_handled, (unsigned long)input_events.dropped);
+    printf("Interrupcao: max %lu us\n", (unsigned long)isr_max_us);
+    printf("Latencia evento->tratamento: max %lu us, media %lu us\n",
+           (unsigned long)event_latency_max_us,
+           (unsigned long)(events_handled ? event_latency_total_us / events_handled : 0));
+    printf("Serial: %lu caracteres em %lu lotes (max %lu por leitura)\n",
+           (unsigned long)serial_chars, (unsigned long)serial_batches, (unsigned long)serial_batch_max);
+    printf("Latencia entrada->display: max %lu us, media %lu us\n",
+           (unsigned long)render_stats.latency_max_us,
+           (unsigned long)(render_stats.latency_count ? render_stats.latency_total_us / render_stats.latency_count : 0));
+    printf("Renderizacao (nucleo 1): %lu comandos enviados, %lu executados, %lu esperas por fila cheia, %lu envios\n",
+           (unsigned long)render_stats.sent, (unsigned long)render_stats.executed,
+           (unsigned long)render_stats.stalls, (unsigned long)render_stats.flushes);
+    printf("Widgets: %lu atualizacoes, %lu com alteracao, %lu pixels redesenhados\n",
+           (unsigned long)render_stats.ui_updates, (unsigned long)render_stats.ui_damaged,
+           (unsigned long)render_stats.ui_damage_px);
+    printf("Escalonador: %lu ticks, %lu perdidos, %lu pausas, jitter max %lu us, atendimento max %lu us\n",
+           (unsigned long)render_frames.ticks, (unsigned long)render_frames.missed, (unsigned long)render_frames.pauses,
+           (unsigned long)render_frames.jitter_max_us, (unsigned long)render_frames.service_max_us);
+    printf("I2C: %lu kHz, %lu falhas, %lu recusadas, %lu destravamentos, %lu recuos de frequencia\n",
+           (unsigned long)(i2c_bus.baudrate / 1000), (unsigned long)i2c_bus.failed, (unsigned long)i2c_bus.rejected,
+           (unsigned long)i2c_bus.recoveries, (unsigned long)i2c_bus.fallbacks);
+    for (uint p = 0; p < I2C_PRIO_COUNT; ++p)
     {
-        // Verifica se o bit é 1. Em casos positivos, acende o LED na cor branca com a intensidade setada
-        if ((pattern >> i) & 1)
-            set_led(i, lvl * (!blue_led_on && !green_led_on), lvl * green_led_on, lvl * blue_led_on);
-        else
-            set_led(i, 0, 0, 0); // Caso contrário, deixa o LED apagado
+        if (!i2c_bus.completed[p])
+            continue;
+        printf("  %s: %lu transacoes, latencia max %lu us; histograma (<2^n us):", i2c_bus_priority_name(p),
+               (unsigned long)i2c_bus.completed[p], (unsigned long)i2c_bus.latency_max_us[p]);
+        for (uint b = 0; b < I2C_BUS_HIST_BINS; ++b)
+            if (i2c_bus.latency_hist[p][b])
+                printf(" %u:%lu", b + 1, (unsigned long)i2c_bus.latency_hist[p][b]);
+        printf("\n");
     }
+    printf("USB: %lu quadros aplicados, %lu com CRC invalido, %lu recusados, %lu interrompidos, %lu bytes\n",
+           (unsigned long)link.frames[PROTO_OK], (unsigned long)link.frames[PROTO_ERR_CRC],
+           (unsigned long)link.frames[PROTO_ERR_REJECTED], (unsigned long)link.frames[PROTO_ERR_TIMEOUT],
+           (unsigned long)link.bytes);
+    for (uint i = 0; i < render_frames.count; ++i)
+    {
+        frame_device_t *dev = &render_frames.devices[i];
+        printf("  %s: %lu quadros, %lu pulados, %lu adiados, duracao max %lu us, media %lu us\n", dev->name,
+               (unsigned long)dev->frames, (unsigned long)dev->skipped, (unsigned long)dev->deferred,
+               (unsigned long)dev->frame_time_max_us,
+               (unsigned long)(dev->frames_done ? dev->frame_time_total_us / dev->frames_done : 0));
+    }
+
+    // Taxas desde o '?' anterior: repita após um minuto ocioso para medir a economia
+    power_report_t report;
+    power_report(&power, i2c_bus.bytes + render_stats.led_bytes, &report);
+    printf("Energia: estagio %s, %lu despertares, %lu trocas de estagio\n", power_state_name(power.state),
+           (unsigned long)power.wakeups, (unsigned long)power.transitions);
+    printf("  ultimos %lu ms: %lu despertares/min, %lu.%lu%% acordado, %lu bytes/min (I2C + matriz)\n",
+           (unsigned long)report.window_ms, (unsigned long)report.wakeups_per_min,
+           (unsigned long)(report.active_permille / 10), (unsigned long)(report.active_permille % 10),
+           (unsigned long)report.bytes_per_min);
+    printf("  despertares/min por origem:");
+    for (uint i = 0; i < POWER_WAKE_SOURCES; ++i)
+        printf(" %s %lu", power_wake_name((power_wake_t)i), (unsigned long)report.sources_per_min[i]);
+    printf("\n");
 }
 
 /*
- * Limpa uma linha
+ * Aplica o estágio de economia ao display e à matriz
  */
-void clear_line(uint y)
+void apply_power_state()
 {
-    for (int x = 8; x <= 112; x += 8)
+    uint8_t cmd[3];
+    switch (power.state)
     {
-        ssd1306_draw_char(&ssd, ' ', x, y);
+    case POWER_ACTIVE:
+        cmd[0] = SET_DISP | 0x01; // Liga o display com o contraste normal
+        cmd[1] = SET_CONTRAST;
+        cmd[2] = 0xFF;
+        render_display_command(cmd, 3);
+        if (number_id >= 0 && number_id <= 9)
+            set_led_by_number(number_id); // Restaura o número na matriz
+        else
+            render_led_frame(led_off);
+        break;
+    case POWER_DIM:
+        cmd[0] = SET_CONTRAST;
+        cmd[1] = POWER_DIM_CONTRAST;
+        render_display_command(cmd, 2);
+        break;
+    case POWER_OFF:
+        cmd[0] = SET_DISP | 0x00; // O conteúdo continua na memória do display
+        render_display_command(cmd, 1);
+        render_led_frame(led_off);
+        break;
     }
 }
 
-void button_callback(uint gpio, uint32_t events)
+/*
+ * Indica se o laço principal tem trabalho pendente (consultada com as interrupções mascaradas)
+ */
+bool main_has_work()
 {
-    uint32_t now = to_ms_since_boot(get_absolute_time()); // Obtém o tempo atual em ms
+    return serial_pending || !event_queue_empty(&input_events);
+}
 
-    if (now - last_interrupt_time > DEBOUNCE_DELAY_MS)
-    {                              // Verifica se o botão foi pressionado após o tempo de debounce
-        last_interrupt_time = now; // Atualiza o tempo da última interrupção
+/*
+ * Interrupção do stdio: há caracteres disponíveis para leitura
+ */
+void serial_chars_available(void *param)
+{
+    if (!serial_pending)
+        serial_arrival_us = time_us_32();
+    serial_pending = true;
+}
 
-        // Alterna o estado do LED verde se o botão A for pressionado
-        if (gpio == BTN_A_PIN)
+#ifdef SERIAL_CONSOLE
+/*
+ * Acumula um caractere na linha em digitação; no fim da linha (ou com ela cheia) a envia ao console
+ * Retorna true se uma linha foi enviada
+ */
+bool console_input_char(int c)
+{
+    if (c >= ' ' && c < 0x7F)
+        console_input[console_input_len++] = c;
+    else if (c != '\r' && c != '\n')
+        return false; // Demais caracteres de controle são ignorados
+
+    bool line_end = c == '\r' || c == '\n';
+    if (console_input_len == 0 || (!line_end && console_input_len < CONSOLE_COLS))
+        return false;
+
+    console_input[console_input_len] = '\0';
+    console_input_len = 0;
+    render_console_line(&console, console_input);
+    return true;
+}
+#endif
+
+/*
+ * Início de um quadro recebido pela USB: valida o comprimento e espera o buffer inativo ficar livre
+ * Enquanto o núcleo 0 espera, a USB segura os próximos bytes no computador (controle de fluxo)
+ */
+bool link_begin(uint8_t type, uint16_t length, void *ctx)
+{
+    link_length = length;
+    switch (type)
+    {
+    case PROTO_OLED_FRAME:
+        if (length != WIDTH * (HEIGHT / 8))
+            return false;
+        while (!render_drained())
+            tight_loop_contents(); // A troca ou cópia anterior precisa ter sido executada pelo núcleo 1
+        return true;
+    case PROTO_OLED_PATCH:
+        link_window_ok = false; // Validada quando a janela chegar
+        while (!render_drained())
+            tight_loop_contents();
+        return length > sizeof(link_window);
+    case PROTO_LED_FRAME:
+        // Matrizes maiores cabem ajustando LED_MTX_SIZE; LEDs não enviados ficam apagados
+        if (length == 0 || length % 3 || length / 3 > led_matrix.count)
+            return false;
+        while (!render_led_released(led_back))
+            tight_loop_contents(); // O DMA pode ainda estar lendo este buffer
+        for (uint i = length / 3; i < led_matrix.count; ++i)
+            led_back[i] = 0;
+        return true;
+    case PROTO_CONTROL:
+        return length == sizeof(link_control);
+    }
+    return false;
+}
+
+/*
+ * Byte de dados de um quadro aceito, gravado direto na posição final
+ */
+void link_byte(uint8_t type, uint16_t pos, uint8_t value, void *ctx)
+{
+    switch (type)
+    {
+    case PROTO_OLED_FRAME:
+        oled_back[1 + pos] = value; // Mesmo layout do ram_buffer: nenhuma conversão
+        break;
+    case PROTO_OLED_PATCH:
+        if (pos < sizeof(link_window))
         {
-            green_led_on = !green_led_on;
-            gpio_put(LED_G_PIN, green_led_on);
-            ssd1306_draw_string(&ssd, green_led_on ? "G ON " : "G OFF", 8, 48); // Atualiza o display
-            printf(green_led_on ? "LED Verde ON\n" : "LED Verde OFF\n");
+            link_window[pos] = value;
+            if (pos == sizeof(link_window) - 1)
+            {
+                uint8_t x0 = link_window[0], p0 = link_window[1], x1 = link_window[2], p1 = link_window[3];
+                link_window_ok = x0 <= x1 && x1 < WIDTH && p0 <= p1 && p1 < HEIGHT / 8 &&
+                                 link_length - sizeof(link_window) == (uint)(x1 - x0 + 1) * (p1 - p0 + 1);
+                link_x = x0;
+                link_page = p0;
+            }
         }
-        // Alterna o estado do LED azul se o botão B for pressionado
-        else if (gpio == BTN_B_PIN)
+        else if (link_window_ok)
         {
-            blue_led_on = !blue_led_on;
-            gpio_put(LED_B_PIN, blue_led_on);
-            ssd1306_draw_string(&ssd, blue_led_on ? "B ON " : "B OFF", 80, 48); // Atualiza o display
-            printf(blue_led_on ? "LED Azul ON\n" : "LED Azul OFF\n");
+            // Coluna a coluna, como no ram_buffer: as páginas de uma coluna são contíguas
+            oled_back[1 + link_x * (HEIGHT / 8) + link_page] = value;
+            if (link_page++ == link_window[3])
+            {
+                link_page = link_window[1];
+                link_x++;
+            }
         }
+        break;
+    case PROTO_LED_FRAME:
+    {
+        // G, R e B ocupam os bytes 3, 2 e 1 da palavra da FIFO (led_color)
+        uint8_t lane = pos % 3;
+        uint32_t *word = &led_back[pos / 3];
+        *word = lane ? *word | (uint32_t)value << (24 - 8 * lane) : (uint32_t)value << 24;
+        break;
+    }
+    case PROTO_CONTROL:
+        link_control[pos] = value;
+        break;
+    }
+}
 
-        // Atualiza o ícone no display de acordo com os LEDs ligados/desligados
-        if (green_led_on && blue_led_on)
-            ssd1306_draw_icon(&ssd, 0, 58, 48); // Ambos ligados
-        else if (green_led_on || blue_led_on)
-            ssd1306_draw_icon(&ssd, 1, 58, 48); // Apenas um ligado
-        else
-            ssd1306_draw_icon(&ssd, 2, 58, 48); // Ambos desligados
+/*
+ * Executa um comando de controle recebido pela USB
+ */
+proto_status_t link_control_apply()
+{
+    uint8_t arg = link_control[1];
+    uint8_t cmd[2];
+    switch (link_control[0])
+    {
+    case PROTO_CTRL_PING:
+        return PROTO_OK;
+    case PROTO_CTRL_CONTRAST:
+        cmd[0] = SET_CONTRAST;
+        cmd[1] = arg;
+        render_display_command(cmd, 2);
+        return PROTO_OK;
+    case PROTO_CTRL_INVERT:
+        cmd[0] = SET_NORM_INV | (arg != 0);
+        render_display_command(cmd, 1);
+        return PROTO_OK;
+    case PROTO_CTRL_POWER:
+        cmd[0] = SET_DISP | (arg != 0);
+        render_display_command(cmd, 1);
+        return PROTO_OK;
+    }
+    return PROTO_ERR_REJECTED;
+}
 
-        // Atualiza os LEDs da matriz se um número válido estiver selecionado
-        if (number_id >= 0 && number_id <= 9)
+/*
+ * Fim de um quadro recebido pela USB: com o CRC correto, entrega o buffer ao núcleo 1 e troca de metade
+ */
+proto_status_t link_end(uint8_t type, uint8_t seq, proto_status_t status, void *ctx)
+{
+    if (status == PROTO_OK)
+    {
+        switch (type)
         {
-            set_led_by_pattern(led_number_pattern[number_id]); // Define o padrão dos LEDs
-            write_leds();                                      // Envia os dados para a matriz de LEDs
+        case PROTO_OLED_FRAME:
+            render_oled_swap(oled_back);
+            oled_back = oled_back == ssd_remote ? ssd_ram : ssd_remote; // O buffer exibido até aqui passa a ser o inativo
+            link_applied = true;
+            break;
+        case PROTO_OLED_PATCH:
+            if (!link_window_ok)
+            {
+                status = PROTO_ERR_REJECTED;
+                break;
+            }
+            render_oled_patch(oled_back, link_window[0], link_window[1], link_window[2], link_window[3]);
+            link_applied = true;
+            break;
+        case PROTO_LED_FRAME:
+            render_led_frame(led_back);
+            led_back = led_back == led_remote ? led_matrix.pixels : led_remote;
+            break;
+        case PROTO_CONTROL:
+            status = link_control_apply();
+            break;
         }
+    }
 
-        ssd1306_send_data(&ssd); // Envia os dados atualizados para o display
+    printf("#ack %u %u\n", seq, status); // Confirmação lida por tools/frame_sender.py
+    return status;
+}
+
+const proto_handler_t link_handler = {link_begin, link_byte, link_end};
+
+/*
+ * Lê todos os caracteres pendentes sem bloquear, aplicando apenas o efeito final do lote
+ * Retorna o instante de chegada do lote, ou 0 se nada relevante foi recebido
+ */
+uint32_t read_serial_input()
+{
+    if (!serial_pending)
+        return 0;
+    serial_pending = false;
+    uint32_t arrival = serial_arrival_us;
+
+    int c, digit = -1;
+    uint32_t count = 0;
+    bool stats = false, dump = false, logged = false;
+    uint32_t start = time_us_32();
+    link_applied = false;
+    while (true)
+    {
+        // No meio de um quadro binário, espera os próximos bytes em vez de voltar ao laço com o quadro pela metade
+        c = getchar_timeout_us(proto_busy(&link) ? PROTO_BYTE_TIMEOUT_US : 0);
+        if (c == PICO_ERROR_TIMEOUT)
+        {
+            if (proto_busy(&link))
+                proto_timeout(&link); // O remetente parou no meio do quadro
+            break;
+        }
+        count++;
+        if (proto_feed(&link, c))
+        {
+            // Um fluxo contínuo de quadros não pode prender o laço: o restante fica para a próxima leitura
+            if (!proto_busy(&link) && time_us_32() - start > SERIAL_BUDGET_US)
+            {
+                serial_pending = true;
+                break;
+            }
+            continue;
+        }
+#ifdef SERIAL_CONSOLE
+        logged |= console_input_char(c); // Todas as linhas aparecem no log
+#endif
+        if (c >= '0' && c <= '9')
+            digit = c - '0'; // Em uma rajada, apenas o último dígito importa
+        else if (c == '?')
+            stats = true;
+        else if (c == '#')
+            dump = true;
     }
+    serial_chars += count;
+    serial_batches++;
+    if (count > serial_batch_max)
+        serial_batch_max = count;
+
+    if (stats)
+        print_stats(); // Exibe as estatísticas de desempenho
+    if (dump)
+        trace_dump(); // Envia os eventos rastreados para tools/trace_decode.py
+    if (digit < 0)
+        return logged || link_applied ? arrival : 0;
+
+#ifndef SERIAL_CONSOLE
+    // Exibe o novo número na posição fixa (nada é redesenhado se for o mesmo número)
+    render_ui_number(&number_field, digit);
+#endif
+
+    // Atualiza o LED
+    number_id = digit;
+    set_led_by_number(number_id);
+    return arrival;
 }
 
 int main()
@@ -236,37 +742,45 @@ int main()
     init_pio(LED_MTX_PIN); // Configura o PIO para controlar a matriz de LEDs
     clear_leds();
     write_leds();
-    i2c_init(I2C_PORT, 400 * 1000); // Inicializa o barramento I2C com frequência de 400 kHz
     init_gpio();
+    i2c_bus_init(&i2c_bus, I2C_PORT, I2C_SDA, I2C_SCL, I2C_BUS_FAST_PLUS); // 1 MHz, recuando para 400 kHz se houver falhas
     init_display();
 
-    // Configurando as interrupções para o pressionamento dos botões
-    gpio_set_irq_enabled_with_callback(BTN_A_PIN, GPIO_IRQ_EDGE_FALL, true, &button_callback);
-    gpio_set_irq_enabled_with_callback(BTN_B_PIN, GPIO_IRQ_EDGE_FALL, true, &button_callback);
+    // Configurando as interrupções para o pressionamento dos botões: as duas bordas iniciam a amostragem
+    event_queue_init(&input_events);
+    for (uint i = 0; i < BUTTON_COUNT; ++i)
+    {
+        debounce_init(&buttons[i], DEBOUNCE_PRESS_SAMPLES, DEBOUNCE_RELEASE_SAMPLES, DEBOUNCE_LONG_PRESS_US);
+        gpio_set_irq_enabled_with_callback(button_pins[i], GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &button_callback);
+    }
+
+    // Entrada serial sinalizada por interrupção e lida sem bloquear; quadros binários são separados do texto
+    proto_init(&link, &link_handler, NULL);
+    stdio_set_chars_available_callback(serial_chars_available, NULL);
 
-    char c;
-    int number_x = 64, number_y = 23; // Posição fixa para exibir números
+    // O display e a matriz de LEDs passam a ser controlados exclusivamente pelo núcleo 1
+    render_start(&ssd, &strip);
+
+    power_init(&power, POWER_DIM_MS, POWER_OFF_MS);
 
     while (true)
     {
-        sleep_ms(100);
-        scanf("%c", &c);
+        trace_begin(TRACE_MAIN_LOOP);
+        bool changed = dispatch_events();
+        uint32_t arrival = read_serial_input();
 
-        if (c >= '0' && c <= '9')
+        // Confirma as alterações acumuladas; o escalonador do núcleo 1 as envia no próximo quadro
+        if (changed || arrival)
         {
-            // Limpa a área onde o número será exibido (desenha um espaço)
-            ssd1306_draw_char(&ssd, ' ', number_x, number_y); // Apaga o número anterior
-            ssd1306_send_data(&ssd);                          // Atualiza o display para refletir a limpeza
-
-            // Exibe o novo número na posição fixa
-            ssd1306_draw_char(&ssd, c, number_x, number_y);
-
-            // Atualiza o LED
-            number_id = c - '0';
-            set_led_by_pattern(led_number_pattern[number_id]);
-            write_leds();
+            render_flush(arrival);
+            if (power_input(&power) != POWER_ACTIVE)
+                apply_power_state(); // A entrada também acorda o display e a matriz
         }
+        if (power_update(&power))
+            apply_power_state();
+        trace_end(TRACE_MAIN_LOOP);
 
-        ssd1306_send_data(&ssd); // Atualiza o display
+        // Sem trabalho pendente, dorme até a próxima interrupção: botões, USB, debounce ou o próximo estágio
+        power_sleep(&power, main_has_work);
     }
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+// Benchmark no computador: o mesmo benchmark_run do firmware (compilado com -DBENCHMARK=1), com o
+// display em um barramento I2C substituto que registra cada transação. Os tempos das primitivas são
+// da CPU do computador; bytes, transações e o tempo modelado a 400 kHz e 1 MHz são os do firmware.
+//
+// Uso: ./benchmark_host
+
+#include <stdio.h>
+#include "host_sdk.h"
+#include "ssd1306.h"
+#include "i2c_bus.h"
+#include "benchmark.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+#define ADDRESS 0x3C
+
+static uint8_t ssd_ram[SSD1306_BUFFER_SIZE(WIDTH, HEIGHT)];
+static uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(WIDTH, HEIGHT)];
+static uint16_t ssd_dma[SSD1306_DMA_BUFFER_WORDS(WIDTH, HEIGHT)];
+
+int main(void)
+{
+    ssd1306_t ssd;
+    i2c_bus_t bus;
+
+    // Mesma sequência do firmware (tarefa_U4C6012T.c)
+    i2c_bus_init(&bus, i2c1, 14, 15, I2C_BUS_FAST_PLUS);
+    ssd1306_init_with_buffers(&ssd, WIDTH, HEIGHT, false, ADDRESS, i2c1, ssd_ram, ssd_tx, ssd_dma);
+    ssd1306_attach_bus(&ssd, &bus, I2C_PRIO_BULK);
+    ssd1306_config(&ssd);
+
+    host_i2c_reset();
+    benchmark_run(&ssd);
+    printf("\nbarramento substituto: %lu transacoes, %lu bytes registrados no total\n",
+           (unsigned long)host_i2c.transactions, (unsigned long)host_i2c.bytes);
+    return 0;
+}
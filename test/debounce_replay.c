@@ -0,0 +1,184 @@
+// Reprodução de traços de botões pelo debounce (user-023): cada traço é a sequência de bordas de um
+// botão, e a reprodução faz o que o firmware faz com elas (button_callback e button_sample): cada borda
+// chama debounce_edge e, se a amostragem estiver parada, inicia o timer de DEBOUNCE_SAMPLE_US, que lê
+// o nível e chama debounce_sample até o botão voltar ao repouso. Os eventos emitidos são comparados,
+// tipo e instante, com as linhas "expect" do traço; sem elas, são apenas impressos (traços recém-exportados).
+//
+// Formato do traço (test/traces): linhas "<tempo_us> <nível>" a cada borda, com o nível da GPIO
+// (0 pressionado, 1 solto; começa solto), e "expect <press|release|long> <tempo_us>" ou "expect none"; '#' inicia um
+// comentário. Os traços de test/traces foram compostos a partir de medições publicadas de chaves
+// tácteis, e não capturados na placa; bordas reais podem ser gravadas com o comando '#' e exportadas
+// com tools/trace_decode.py --bounce.
+//
+// Uso: ./debounce_replay traço.txt [...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "debounce.h"
+
+#define TRACE_EDGES_MAX 4096
+#define TRACE_EVENTS_MAX 64
+#define SAMPLING_LIMIT_US 10000000 // A amostragem de um traço não pode durar mais que isso depois da última borda
+
+typedef struct
+{
+    uint32_t time_us;
+    uint8_t level;
+} edge_t;
+
+typedef struct
+{
+    debounce_event_t type;
+    uint32_t time_us;
+} replay_event_t;
+
+static edge_t edges[TRACE_EDGES_MAX];
+static replay_event_t expected[TRACE_EVENTS_MAX], emitted[TRACE_EVENTS_MAX];
+static unsigned edge_count, expected_count, emitted_count;
+static bool checked; // O traço tem linhas "expect"
+
+static const char *const event_names[] = {"none", "press", "release", "long"};
+
+// Lê o traço; retorna false se o arquivo não abrir ou tiver uma linha inválida
+static bool load(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        fprintf(stderr, "%s: não foi possível abrir\n", path);
+        return false;
+    }
+
+    char line[256];
+    unsigned number = 0;
+    bool ok = true;
+    edge_count = expected_count = 0;
+    checked = false;
+    while (ok && fgets(line, sizeof(line), f))
+    {
+        number++;
+        char *comment = strchr(line, '#');
+        if (comment)
+            *comment = '\0';
+
+        char name[16];
+        unsigned long time_us, level;
+        if (sscanf(line, " expect %15s", name) == 1 && strcmp(name, "none") == 0)
+            checked = true;
+        else if (sscanf(line, " expect %15s %lu", name, &time_us) == 2)
+        {
+            debounce_event_t type = DEBOUNCE_NONE;
+            for (unsigned i = 1; i < sizeof(event_names) / sizeof(event_names[0]); ++i)
+                if (strcmp(name, event_names[i]) == 0)
+                    type = (debounce_event_t)i;
+            ok = type != DEBOUNCE_NONE && expected_count < TRACE_EVENTS_MAX;
+            checked = true;
+            if (ok)
+                expected[expected_count++] = (replay_event_t){type, (uint32_t)time_us};
+        }
+        else if (sscanf(line, " %lu %lu", &time_us, &level) == 2)
+        {
+            ok = level <= 1 && edge_count < TRACE_EDGES_MAX &&
+                 (edge_count == 0 || time_us >= edges[edge_count - 1].time_us);
+            if (ok)
+                edges[edge_count++] = (edge_t){(uint32_t)time_us, (uint8_t)level};
+        }
+        else
+            ok = strspn(line, " \t\r\n") == strlen(line); // Linha vazia ou só comentário
+    }
+    fclose(f);
+    if (!ok)
+        fprintf(stderr, "%s:%u: linha inválida\n", path, number);
+    return ok;
+}
+
+// Amostra de button_sample: o nível lido é o da última borda até o instante da amostra
+static bool sample(debounce_t *db, uint8_t level, uint32_t now)
+{
+    uint32_t time_us;
+    debounce_event_t result = debounce_sample(db, level == 0, now, &time_us);
+    if (result != DEBOUNCE_NONE && emitted_count < TRACE_EVENTS_MAX)
+        emitted[emitted_count++] = (replay_event_t){result, time_us};
+    return !debounce_idle(db); // false para o timer, como em button_sample
+}
+
+static void replay(void)
+{
+    debounce_t db;
+    debounce_init(&db, DEBOUNCE_PRESS_SAMPLES, DEBOUNCE_RELEASE_SAMPLES, DEBOUNCE_LONG_PRESS_US);
+    emitted_count = 0;
+
+    uint8_t level = 1;
+    bool sampling = false;
+    uint32_t next_sample = 0;
+    for (unsigned i = 0; i < edge_count; ++i)
+    {
+        // Amostras anteriores à borda; uma amostra no mesmo instante já lê o nível novo
+        while (sampling && next_sample < edges[i].time_us)
+        {
+            sampling = sample(&db, level, next_sample);
+            next_sample += DEBOUNCE_SAMPLE_US;
+        }
+        if (edges[i].level == level)
+            continue; // Sem mudança de nível, a GPIO não interrompe
+        level = edges[i].level;
+
+        // button_callback: registra a borda e inicia a amostragem em uma grade a partir dela
+        debounce_edge(&db, edges[i].time_us);
+        if (!sampling)
+        {
+            sampling = true;
+            next_sample = edges[i].time_us + DEBOUNCE_SAMPLE_US;
+        }
+    }
+
+    uint32_t limit = (edge_count ? edges[edge_count - 1].time_us : 0) + SAMPLING_LIMIT_US;
+    while (sampling && next_sample < limit)
+    {
+        sampling = sample(&db, level, next_sample);
+        next_sample += DEBOUNCE_SAMPLE_US;
+    }
+    CHECK(!sampling); // O botão sempre volta ao repouso e a amostragem para
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "uso: %s traço.txt [...]\n", argv[0]);
+        return 2;
+    }
+
+    for (int a = 1; a < argc; ++a)
+    {
+        const char *name = strrchr(argv[a], '/') ? strrchr(argv[a], '/') + 1 : argv[a];
+        if (!load(argv[a]))
+        {
+            test_failures++;
+            continue;
+        }
+        replay();
+
+        printf("%-22s %3u bordas:", name, edge_count);
+        for (unsigned i = 0; i < emitted_count; ++i)
+            printf(" %s@%lu", event_names[emitted[i].type], (unsigned long)emitted[i].time_us);
+        printf("%s\n", emitted_count ? "" : " nenhum evento");
+
+        if (!checked)
+            continue;
+        bool match = emitted_count == expected_count;
+        for (unsigned i = 0; match && i < emitted_count; ++i)
+            match = emitted[i].type == expected[i].type && emitted[i].time_us == expected[i].time_us;
+        if (!match)
+        {
+            fprintf(stderr, "%s: eventos diferentes do esperado:", name);
+            for (unsigned i = 0; i < expected_count; ++i)
+                fprintf(stderr, " %s@%lu", event_names[expected[i].type], (unsigned long)expected[i].time_us);
+            fprintf(stderr, "\n");
+            test_failures++;
+        }
+    }
+    return TEST_RESULT("debounce_replay");
+}
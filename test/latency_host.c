@@ -0,0 +1,741 @@
+// Latência da entrada até o último byte do display e o último bit da matriz no fio (user-009,
+// user-021), com o código real do firmware compilado no computador: debounce, fila de eventos,
+// widgets, serviço de renderização (núcleo 1), escalonador de quadros, barramento I2C compartilhado
+// e matriz WS2812. O DMA substituto leva o tempo do fio: 9 us por byte a 1 MHz (8 bits + ACK) e
+// 30 us por LED (24 bits a 800 kHz).
+//
+// O tempo é virtual e o núcleo 1 roda em passo travado com o núcleo 0 (host_core1_lockstep): a cada
+// instante rodam as interrupções do núcleo 0 (alarmes, DMA, bordas dos botões e bytes da serial), o
+// laço principal e então o núcleo 1, e o tempo salta direto ao próximo evento. Com a mesma semente,
+// o resultado é sempre o mesmo, e não depende da carga do computador.
+//
+// O laço principal repete o do firmware (tarefa_U4C6012T.c): button_callback e button_sample
+// alimentam o debounce, dispatch_events trata os pressionamentos confirmados, read_serial_input lê
+// os bytes em lote (apenas o último dígito importa) e render_flush confirma as alterações. Os bytes
+// do teclado chegam pela USB (no próximo quadro de 1 ms) ou pela UART (10 bits a 115200, um por vez).
+// Cenários:
+// - teclas: dígitos isolados em intervalos aleatórios (média de 250 ms);
+// - rajadas: 8 caracteres colados no Serial Monitor, alguns sem efeito (a, b, c);
+// - digitacao: uma tecla a cada 8 ms, mais rápida que os 50 quadros/s do display;
+// - trepidacao: botões com trepidação ao pressionar e ao soltar;
+// - a+b: A e B pressionados quase ao mesmo tempo.
+//
+// A latência de uma entrada vai da tecla (ou da primeira borda do botão) ao fim do quadro do display
+// e, se ela mudou a matriz, do quadro da matriz que a exibem. Pressionamentos não confirmados pelo
+// debounce (ignorados), os confirmados sem pressionamento real (espúrios) e os bytes que não alteram
+// nada (sem efeito) são contados à parte. --json guarda as métricas e --baseline falha se algum p99
+// piorar além da tolerância.
+//
+// Uso: ./latency_host [--seconds 60] [--seed 1] [--link usb|uart] [--json saida.json]
+//                     [--baseline referencia.json] [--tolerance 0.1]
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "ssd1306_model.h"
+#include "i2c_bus.h"
+#include "ws2812.h"
+#include "render.h"
+#include "debounce.h"
+#include "event_queue.h"
+#include "led_frames.h"
+
+// Mesmos pinos e posições do firmware
+#define WIDTH 128
+#define HEIGHT 64
+#define ADDRESS 0x3C
+#define BTN_A_PIN 5
+#define BTN_B_PIN 6
+#define BUTTON_COUNT 2
+#define NUMBER_X 64
+#define NUMBER_Y 23
+
+#define I2C_WORD_NS 9000   // 1 MHz: 8 bits de dados + ACK
+#define PIO_WORD_NS 30000  // 24 bits a 1,25 us
+#define UART_BYTE_US 87    // Start, 8 bits e stop a 115200
+#define USB_FRAME_US 1000
+#define USB_DELIVERY_US 50 // Do início do quadro USB à interrupção do stdio
+
+#define ENTRIES_MAX 16384
+#define STIMULI_MAX 32768
+#define RX_MAX 256
+
+#define OUT_OLED 1 // Saídas aguardadas por uma entrada
+#define OUT_LED 2
+
+static uint8_t ssd_ram[SSD1306_BUFFER_SIZE(WIDTH, HEIGHT)];
+static uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(WIDTH, HEIGHT)];
+static uint16_t ssd_dma[SSD1306_DMA_BUFFER_WORDS(WIDTH, HEIGHT)];
+static const uint32_t led_off[LED_MTX_COUNT];
+
+static ssd1306_t ssd;
+static i2c_bus_t bus;
+static ws2812_t strip;
+static ssd1306_model_t model;
+
+// Estado do núcleo 0, como no firmware
+static const uint button_pins[BUTTON_COUNT] = {BTN_A_PIN, BTN_B_PIN};
+static debounce_t buttons[BUTTON_COUNT];
+static event_queue_t input_events;
+static repeating_timer_t button_timer;
+static bool button_sampling;
+static ui_widget_t green_label, blue_label, status_icon, number_field;
+static bool green_led_on, blue_led_on;
+static int number_id = -1;
+static const uint32_t *led_sent; // Último quadro pedido à matriz
+
+// Entrada acompanhada até ser exibida
+typedef enum
+{
+    ENTRY_PENDING, // Aguardando o debounce ou o laço principal
+    ENTRY_WAITING, // Confirmada por render_flush, aguardando os quadros
+    ENTRY_DONE,
+    ENTRY_IGNORED, // Pressionamento que o debounce não confirmou
+    ENTRY_NO_EFFECT,
+} entry_state_t;
+
+typedef struct
+{
+    uint64_t time_us;   // Tecla ou primeira borda do botão
+    uint64_t queued_us; // Laço principal que a confirmou
+    uint32_t frame[2];  // Quadro do display e da matriz que a exibe (0: ainda não iniciado)
+    uint64_t done_us;
+    uint8_t need;       // Saídas aguardadas (OUT_OLED, OUT_LED)
+    uint8_t state;      // entry_state_t
+} entry_t;
+
+static entry_t entries[ENTRIES_MAX];
+static uint entry_count, entry_first; // Entradas anteriores a entry_first já terminaram
+static int pending_press[BUTTON_COUNT];
+static uint32_t spurious;
+
+// Estímulos do cenário, em ordem de tempo
+typedef enum
+{
+    STIM_BYTE, // Byte disponível na serial
+    STIM_EDGE, // Borda de um botão
+} stim_kind_t;
+
+typedef struct
+{
+    uint64_t at;
+    uint32_t seq;  // Ordem de criação, para desempatar
+    uint8_t kind;  // stim_kind_t
+    uint8_t value; // Caractere ou botão
+    bool pressed;  // STIM_EDGE: nível depois da borda
+    int entry;     // Entrada iniciada pelo estímulo (-1 se nenhuma)
+} stimulus_t;
+
+static stimulus_t stimuli[STIMULI_MAX];
+static uint stim_count, stim_next;
+
+// Bytes recebidos e ainda não lidos pelo laço principal
+static uint8_t rx_chars[RX_MAX];
+static int rx_entries[RX_MAX];
+static uint rx_count;
+static bool serial_pending;
+static uint32_t serial_arrival_us;
+
+// Quadros observados de cada saída (índices do escalonador: display e depois matriz)
+static uint32_t seen_started[2], seen_done[2];
+
+// Latências concluídas no cenário atual
+static uint32_t samples[ENTRIES_MAX];
+static uint sample_count;
+
+// Gerador próprio (xorshift32): a mesma semente dá a mesma sequência em qualquer libc
+static uint32_t rng_state;
+
+static double uniform(double a, double b)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return a + (b - a) * (rng_state / 4294967296.0);
+}
+
+static uint choice(uint n)
+{
+    return (uint)uniform(0, n);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Núcleo 0: o mesmo tratamento do firmware
+
+static bool button_sample(repeating_timer_t *timer)
+{
+    uint32_t now = time_us_32();
+    bool idle = true;
+    for (uint i = 0; i < BUTTON_COUNT; ++i)
+    {
+        uint32_t time_us;
+        debounce_event_t result = debounce_sample(&buttons[i], !gpio_get(button_pins[i]), now, &time_us);
+        if (result != DEBOUNCE_NONE)
+        {
+            event_t event = {.time_us = time_us, .type = EVENT_BUTTON_PRESS + result - DEBOUNCE_PRESS, .data = button_pins[i]};
+            event_queue_push(&input_events, &event);
+        }
+        idle &= debounce_idle(&buttons[i]);
+    }
+    if (idle)
+        button_sampling = false;
+    return !idle;
+}
+
+static void button_callback(uint gpio, uint32_t events)
+{
+    for (uint i = 0; i < BUTTON_COUNT; ++i)
+        if (button_pins[i] == gpio)
+            debounce_edge(&buttons[i], time_us_32());
+    if (!button_sampling)
+    {
+        button_sampling = true;
+        add_repeating_timer_us(-DEBOUNCE_SAMPLE_US, button_sample, NULL, &button_timer);
+    }
+}
+
+// Entradas tratadas na passagem atual do laço principal e se ela mudou a matriz
+static uint pass_entries[ENTRIES_MAX];
+static uint pass_count;
+static bool pass_led;
+
+static void set_led_frame(const uint32_t *frame)
+{
+    if (frame != led_sent)
+        pass_led = true; // O serviço não reenvia quadros repetidos
+    led_sent = frame;
+    render_led_frame(frame);
+}
+
+static void handle_button(uint gpio)
+{
+    if (gpio == BTN_A_PIN)
+    {
+        green_led_on = !green_led_on;
+        render_ui_label(&green_label, green_led_on ? "G ON" : "G OFF");
+    }
+    else
+    {
+        blue_led_on = !blue_led_on;
+        render_ui_label(&blue_label, blue_led_on ? "B ON" : "B OFF");
+    }
+    render_ui_icon(&status_icon, green_led_on && blue_led_on ? 0 : green_led_on || blue_led_on ? 1 : 2);
+    if (number_id >= 0 && number_id <= 9)
+        set_led_frame(led_frame(number_id, led_frame_mode(green_led_on, blue_led_on)));
+}
+
+static bool dispatch_events(void)
+{
+    event_t event;
+    bool handled = false;
+    while (event_queue_pop(&input_events, &event))
+    {
+        uint b = event.data == BTN_A_PIN ? 0 : 1;
+        if (event.type == EVENT_BUTTON_PRESS)
+        {
+            if (pending_press[b] >= 0)
+                pass_entries[pass_count++] = pending_press[b];
+            else
+                spurious++; // Trepidação confirmada como um novo pressionamento
+            pending_press[b] = -1;
+            handle_button(event.data);
+        }
+        else if (event.type == EVENT_BUTTON_LONG_PRESS)
+        {
+            number_id = -1;
+            set_led_frame(led_off);
+            render_ui_number(&number_field, -1);
+        }
+        handled = true;
+    }
+    return handled;
+}
+
+static uint32_t read_serial_input(void)
+{
+    if (!serial_pending)
+        return 0;
+    serial_pending = false;
+
+    int digit = -1;
+    for (uint i = 0; i < rx_count; ++i)
+    {
+        pass_entries[pass_count++] = rx_entries[i];
+        if (rx_chars[i] >= '0' && rx_chars[i] <= '9')
+            digit = rx_chars[i] - '0';
+    }
+    rx_count = 0;
+    if (digit < 0)
+        return 0;
+
+    render_ui_number(&number_field, digit);
+    number_id = digit;
+    set_led_frame(led_frame(number_id, led_frame_mode(green_led_on, blue_led_on)));
+    return serial_arrival_us;
+}
+
+static bool main_has_work(void)
+{
+    return serial_pending || !event_queue_empty(&input_events);
+}
+
+// Uma passagem do laço principal; as entradas tratadas passam a aguardar os quadros
+static void main_loop(void)
+{
+    pass_count = 0;
+    pass_led = false;
+    bool changed = dispatch_events();
+    uint32_t arrival = read_serial_input();
+    if (changed || arrival)
+        render_flush(arrival);
+
+    for (uint i = 0; i < pass_count; ++i)
+    {
+        entry_t *e = &entries[pass_entries[i]];
+        if (!changed && !arrival)
+        {
+            e->state = ENTRY_NO_EFFECT;
+            continue;
+        }
+        e->state = ENTRY_WAITING;
+        e->queued_us = time_us_64();
+        e->need = OUT_OLED | (pass_led ? OUT_LED : 0);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// Estímulos
+
+static void apply_stimulus(const stimulus_t *s)
+{
+    if (s->kind == STIM_BYTE)
+    {
+        if (rx_count < RX_MAX)
+        {
+            rx_chars[rx_count] = s->value;
+            rx_entries[rx_count++] = s->entry;
+        }
+        if (!serial_pending)
+            serial_arrival_us = time_us_32(); // serial_chars_available
+        serial_pending = true;
+        return;
+    }
+
+    if (s->entry >= 0)
+    {
+        if (pending_press[s->value] >= 0)
+            entries[pending_press[s->value]].state = ENTRY_IGNORED; // O anterior nunca foi confirmado
+        pending_press[s->value] = s->entry;
+    }
+    host_gpio_set(button_pins[s->value], !s->pressed); // Botões com pull-up: pressionado é nível baixo
+    host_gpio_irq(button_pins[s->value], s->pressed ? GPIO_IRQ_EDGE_FALL : GPIO_IRQ_EDGE_RISE);
+}
+
+static stimulus_t *add_stimulus(uint64_t at, stim_kind_t kind, uint8_t value, bool pressed, int entry)
+{
+    CHECK(stim_count < STIMULI_MAX);
+    stimulus_t *s = &stimuli[stim_count < STIMULI_MAX ? stim_count : STIMULI_MAX - 1];
+    *s = (stimulus_t){at, stim_count, kind, value, pressed, entry};
+    stim_count += stim_count < STIMULI_MAX;
+    return s;
+}
+
+static int new_entry(uint64_t time_us)
+{
+    CHECK(entry_count < ENTRIES_MAX);
+    if (entry_count == ENTRIES_MAX)
+        return -1;
+    entries[entry_count] = (entry_t){.time_us = time_us, .state = ENTRY_PENDING};
+    return entry_count++;
+}
+
+// Tecla: o byte chega pela USB no próximo quadro, ou pela UART depois dos bytes anteriores
+static bool link_uart;
+static uint64_t uart_free_us;
+
+static void key(uint64_t t, char c)
+{
+    uint64_t arrival;
+    if (link_uart)
+    {
+        arrival = (t > uart_free_us ? t : uart_free_us) + UART_BYTE_US;
+        uart_free_us = arrival;
+    }
+    else
+        arrival = (t / USB_FRAME_US + 1) * USB_FRAME_US + USB_DELIVERY_US;
+    add_stimulus(arrival, STIM_BYTE, (uint8_t)c, false, new_entry(t));
+}
+
+// Pressionamento com trepidação: o contato abre e fecha algumas vezes ao pressionar e ao soltar
+static void press(uint64_t t, uint button, uint bounces, uint64_t hold_us)
+{
+    int entry = new_entry(t);
+    uint64_t at = t;
+    for (uint i = 0; i < 2 * bounces - 1; ++i) // Termina pressionado
+    {
+        add_stimulus(at, STIM_EDGE, button, i % 2 == 0, i == 0 ? entry : -1);
+        at += (uint64_t)uniform(200, 800);
+    }
+    at = t + hold_us;
+    uint releases = 2 * choice(bounces + 1) + 1;
+    for (uint i = 0; i < releases; ++i) // Termina solto
+    {
+        add_stimulus(at, STIM_EDGE, button, i % 2 == 1, -1);
+        at += (uint64_t)uniform(200, 800);
+    }
+}
+
+static void scenario_keys(uint64_t start, uint64_t end)
+{
+    for (uint64_t t = start; (t += (uint64_t)(-250000 * log(1 - uniform(0, 1)))) < end;)
+        key(t, '0' + choice(10));
+}
+
+static void scenario_bursts(uint64_t start, uint64_t end)
+{
+    static const char chars[] = "0123456789abc";
+    for (uint64_t t = start; (t += (uint64_t)uniform(300000, 700000)) < end;)
+        for (uint i = 0; i < 8; ++i)
+            key(t + i * 20, chars[choice(sizeof(chars) - 1)]);
+}
+
+static void scenario_typing(uint64_t start, uint64_t end)
+{
+    for (uint64_t t = start + 8000; t < end; t += 8000)
+        key(t, '0' + choice(10));
+}
+
+static void scenario_chatter(uint64_t start, uint64_t end)
+{
+    for (uint64_t t = start; (t += (uint64_t)uniform(300000, 900000)) < end;)
+        press(t, choice(2), 2 + choice(5), (uint64_t)uniform(50000, 400000));
+}
+
+static void scenario_ab(uint64_t start, uint64_t end)
+{
+    for (uint64_t t = start; (t += (uint64_t)uniform(800000, 1200000)) < end;)
+    {
+        uint first = choice(2);
+        press(t, first, 1, 100000);
+        press(t + (uint64_t)uniform(0, 30000), 1 - first, 1, 100000);
+    }
+}
+
+static int compare_stimuli(const void *a, const void *b)
+{
+    const stimulus_t *x = a, *y = b;
+    if (x->at != y->at)
+        return x->at < y->at ? -1 : 1;
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Tempo virtual
+
+// Acompanha os quadros iniciados e terminados desde a última chamada e conclui as entradas exibidas
+static void observe(void)
+{
+    uint64_t now = time_us_64();
+    for (uint out = 0; out < 2; ++out)
+    {
+        frame_device_t *dev = &render_frames.devices[out];
+
+        // Um quadro iniciado agora inclui tudo o que o laço principal confirmou até este instante
+        while (seen_started[out] != dev->frames)
+        {
+            seen_started[out]++;
+            for (uint i = entry_first; i < entry_count; ++i)
+                if (entries[i].state == ENTRY_WAITING && (entries[i].need & (1u << out)) && !entries[i].frame[out] &&
+                    entries[i].queued_us <= now)
+                    entries[i].frame[out] = seen_started[out];
+        }
+
+        while (seen_done[out] != dev->frames_done)
+        {
+            seen_done[out]++;
+            for (uint i = entry_first; i < entry_count; ++i)
+            {
+                entry_t *e = &entries[i];
+                if (e->state != ENTRY_WAITING || e->frame[out] != seen_done[out])
+                    continue;
+                e->need &= ~(1u << out);
+                e->done_us = now;
+                if (!e->need)
+                {
+                    e->state = ENTRY_DONE;
+                    samples[sample_count++] = (uint32_t)(e->done_us - e->time_us);
+                }
+            }
+        }
+    }
+    while (entry_first < entry_count && entries[entry_first].state > ENTRY_WAITING)
+        entry_first++;
+
+    // O registro do barramento é limitado: o que já chegou ao display vai para o modelo
+    if (host_i2c.logged > HOST_I2C_LOG_XFERS / 2)
+    {
+        ssd1306_model_replay(&model, 0, ADDRESS);
+        host_i2c_reset();
+    }
+}
+
+// Trabalho do instante atual: o laço principal (se acordou) e o núcleo 1, até nada mais mudar
+static void run_instant(void)
+{
+    do
+    {
+        if (main_has_work())
+            main_loop();
+        host_core1_run();
+        observe();
+    } while (main_has_work());
+}
+
+// Avança o tempo virtual de evento em evento até until
+static void run_until(uint64_t until)
+{
+    while (true)
+    {
+        uint64_t next = host_next_event_us();
+        if (stim_next < stim_count && stimuli[stim_next].at < next)
+            next = stimuli[stim_next].at;
+        if (next > until)
+            break;
+
+        host_time_advance(next > time_us_64() ? next - time_us_64() : 0); // Dispara os alarmes vencidos
+        host_dma_run();
+        while (stim_next < stim_count && stimuli[stim_next].at <= time_us_64())
+            apply_stimulus(&stimuli[stim_next++]);
+        observe();
+        run_instant();
+    }
+    if (until > time_us_64())
+        host_time_advance(until - time_us_64());
+    run_instant();
+}
+
+// ---------------------------------------------------------------------------------------------
+// Cenários e métricas
+
+typedef struct
+{
+    const char *name;
+    void (*generate)(uint64_t start, uint64_t end);
+} scenario_t;
+
+static const scenario_t scenarios[] = {
+    {"teclas", scenario_keys},
+    {"rajadas", scenario_bursts},
+    {"digitacao", scenario_typing},
+    {"trepidacao", scenario_chatter},
+    {"a+b", scenario_ab},
+};
+#define SCENARIOS (sizeof(scenarios) / sizeof(scenarios[0]))
+
+typedef struct
+{
+    uint32_t inputs, ignored, spurious, no_effect;
+    uint32_t p50_us, p90_us, p99_us, max_us;
+} metrics_t;
+
+static metrics_t metrics[SCENARIOS];
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint32_t percentile(double p)
+{
+    if (!sample_count)
+        return 0;
+    uint i = (uint)(sample_count * p);
+    return samples[i < sample_count ? i : sample_count - 1];
+}
+
+static void run_scenario(uint index, uint64_t seconds, uint32_t seed)
+{
+    const scenario_t *sc = &scenarios[index];
+    rng_state = seed ? seed : 1;
+    entry_count = entry_first = stim_count = stim_next = sample_count = 0;
+    spurious = 0;
+    uart_free_us = 0;
+
+    uint64_t start = time_us_64(), end = start + seconds * 1000000;
+    sc->generate(start, end);
+    qsort(stimuli, stim_count, sizeof(stimuli[0]), compare_stimuli);
+    run_until(end + 1000000); // Tempo extra para os últimos quadros
+
+    metrics_t *m = &metrics[index];
+    memset(m, 0, sizeof(*m));
+    m->inputs = entry_count;
+    m->spurious = spurious;
+    for (uint i = 0; i < entry_count; ++i)
+    {
+        m->ignored += entries[i].state == ENTRY_IGNORED;
+        m->no_effect += entries[i].state == ENTRY_NO_EFFECT;
+        CHECK(entries[i].state != ENTRY_WAITING); // Nenhuma entrada fica sem exibição
+    }
+    qsort(samples, sample_count, sizeof(samples[0]), compare_u32);
+    m->p50_us = percentile(0.5);
+    m->p90_us = percentile(0.9);
+    m->p99_us = percentile(0.99);
+    m->max_us = sample_count ? samples[sample_count - 1] : 0;
+    CHECK(sample_count > 0);
+    CHECK_EQ(sample_count + m->ignored + m->no_effect, entry_count);
+
+    printf("%-11s %8lu %9lu %8lu %10lu %7.2f %7.2f %7.2f %7.2f\n", sc->name, (unsigned long)m->inputs,
+           (unsigned long)m->ignored, (unsigned long)m->spurious, (unsigned long)m->no_effect, m->p50_us / 1000.0,
+           m->p90_us / 1000.0, m->p99_us / 1000.0, m->max_us / 1000.0);
+
+    // O display terminou com o que o driver desenhou, e a fila foi executada
+    CHECK(render_drained());
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    host_i2c_reset();
+    CHECK(ssd1306_model_matches(&model, &ssd));
+}
+
+static bool write_json(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return false;
+    fprintf(f, "{\n");
+    for (uint i = 0; i < SCENARIOS; ++i)
+    {
+        const metrics_t *m = &metrics[i];
+        fprintf(f,
+                "  \"%s\": {\"entradas\": %lu, \"ignoradas\": %lu, \"espurias\": %lu, \"sem_efeito\": %lu, "
+                "\"p50_us\": %lu, \"p90_us\": %lu, \"p99_us\": %lu, \"max_us\": %lu}%s\n",
+                scenarios[i].name, (unsigned long)m->inputs, (unsigned long)m->ignored, (unsigned long)m->spurious,
+                (unsigned long)m->no_effect, (unsigned long)m->p50_us, (unsigned long)m->p90_us,
+                (unsigned long)m->p99_us, (unsigned long)m->max_us, i + 1 < SCENARIOS ? "," : "");
+    }
+    fprintf(f, "}\n");
+    return fclose(f) == 0;
+}
+
+// Compara os p99 com a referência gravada por --json; retorna quantos pioraram além da tolerância
+static int check_baseline(const char *path, double tolerance)
+{
+    static char text[16384];
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        fprintf(stderr, "referencia %s nao encontrada\n", path);
+        return -1;
+    }
+    size_t length = fread(text, 1, sizeof(text) - 1, f);
+    fclose(f);
+    text[length] = '\0';
+
+    int worse = 0;
+    for (uint i = 0; i < SCENARIOS; ++i)
+    {
+        char key[32];
+        snprintf(key, sizeof(key), "\"%s\"", scenarios[i].name);
+        const char *entry = strstr(text, key);
+        const char *p99 = entry ? strstr(entry, "\"p99_us\":") : NULL;
+        if (!p99)
+            continue; // Cenário novo, sem referência
+        unsigned long reference = strtoul(p99 + 9, NULL, 10);
+        if (metrics[i].p99_us > reference * (1 + tolerance))
+        {
+            fprintf(stderr, "regressao do p99 em %s: %.2f ms (referencia %.2f ms)\n", scenarios[i].name,
+                    metrics[i].p99_us / 1000.0, reference / 1000.0);
+            worse++;
+        }
+    }
+    return worse;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t seconds = 60;
+    uint32_t seed = 1;
+    const char *json = NULL, *baseline = NULL;
+    double tolerance = 0.1;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!strcmp(argv[i], "--seconds") && value)
+            seconds = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--seed") && value)
+            seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--link") && value && (!strcmp(value, "usb") || !strcmp(value, "uart")))
+            link_uart = !strcmp(argv[++i], "uart");
+        else if (!strcmp(argv[i], "--json") && value)
+            json = argv[++i];
+        else if (!strcmp(argv[i], "--baseline") && value)
+            baseline = argv[++i];
+        else if (!strcmp(argv[i], "--tolerance") && value)
+            tolerance = strtod(argv[++i], NULL);
+        else
+        {
+            fprintf(stderr, "uso: %s [--seconds 60] [--seed 1] [--link usb|uart] [--json saida.json] "
+                            "[--baseline referencia.json] [--tolerance 0.1]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Mesma sequência do firmware (tarefa_U4C6012T.c), já em tempo virtual
+    host_time_set(1000);
+    i2c_bus_init(&bus, i2c1, 14, 15, I2C_BUS_FAST_PLUS);
+    ssd1306_init_with_buffers(&ssd, WIDTH, HEIGHT, false, ADDRESS, i2c1, ssd_ram, ssd_tx, ssd_dma);
+    ssd1306_attach_bus(&ssd, &bus, I2C_PRIO_BULK);
+    ssd1306_config(&ssd);
+    ssd1306_fill(&ssd, false);
+    ssd1306_draw_text(&ssd, "Digite o que deseja!", 8, 10);
+    ui_label_init(&green_label, 8, 48, 5);
+    ui_icon_init(&status_icon, 58, 48);
+    ui_label_init(&blue_label, 80, 48, 5);
+    ui_number_init(&number_field, NUMBER_X, NUMBER_Y, 1);
+    ui_label_set(&ssd, &green_label, "G OFF");
+    ui_icon_set(&ssd, &status_icon, 2);
+    ui_label_set(&ssd, &blue_label, "B OFF");
+    ui_number_set(&ssd, &number_field, -1);
+    ssd1306_send_data(&ssd);
+    ws2812_init(&strip, pio0, 0, LED_MTX_COUNT);
+    ssd1306_model_init(&model);
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    host_i2c_reset();
+
+    event_queue_init(&input_events);
+    for (uint i = 0; i < BUTTON_COUNT; ++i)
+    {
+        debounce_init(&buttons[i], DEBOUNCE_PRESS_SAMPLES, DEBOUNCE_RELEASE_SAMPLES, DEBOUNCE_LONG_PRESS_US);
+        gpio_set_irq_enabled_with_callback(button_pins[i], GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &button_callback);
+        pending_press[i] = -1;
+    }
+
+    host_dma_pace(I2C_WORD_NS, PIO_WORD_NS);
+    host_core1_lockstep(true);
+    render_start(&ssd, &strip);
+
+    printf("latencia da entrada ao fim dos quadros (tempo virtual, %lu s por cenario, semente %lu, %s)\n",
+           (unsigned long)seconds, (unsigned long)seed, link_uart ? "uart" : "usb");
+    printf("%-11s %8s %9s %8s %10s %7s %7s %7s %7s\n", "cenario", "entradas", "ignoradas", "espurias", "sem efeito",
+           "p50 ms", "p90 ms", "p99 ms", "max ms");
+    for (uint i = 0; i < SCENARIOS; ++i)
+        run_scenario(i, seconds, seed);
+    printf("comandos %lu, envios ao display %lu, quadros da matriz %lu, fila cheia %lu vezes\n",
+           (unsigned long)render_stats.executed, (unsigned long)render_stats.flushes,
+           (unsigned long)(render_stats.led_bytes / (LED_MTX_COUNT * 3)), (unsigned long)render_stats.stalls);
+
+    if (json && !write_json(json))
+    {
+        fprintf(stderr, "nao foi possivel gravar %s\n", json);
+        test_failures++;
+    }
+    if (baseline)
+    {
+        int worse = check_baseline(baseline, tolerance);
+        if (worse)
+            test_failures++;
+        else
+            printf("p99 dentro da tolerancia da referencia\n");
+    }
+    return TEST_RESULT("latency_host");
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// Substituto do hardware/clocks.h: clk_sys a 125 MHz, como no RP2040
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum clock_index
+{
+    clk_sys = 5,
+};
+
+static inline uint32_t clock_get_hz(enum clock_index clk_index)
+{
+    return 125000000;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+
+// Substituto do hardware/pio.h: a configuração das máquinas de estados é ignorada e cada palavra
+// colocada na FIFO de transmissão (pio_sm_put ou DMA para txf) é gravada no registro de host_sdk.h
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NUM_PIO_STATE_MACHINES 4
+
+typedef struct
+{
+    volatile uint32_t txf[NUM_PIO_STATE_MACHINES];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t pio0_hw, pio1_hw;
+#define pio0 (&pio0_hw)
+#define pio1 (&pio1_hw)
+
+typedef struct pio_program
+{
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+    uint8_t pio_version;
+} pio_program_t;
+
+typedef struct
+{
+    uint32_t clkdiv, execctrl, shiftctrl, pinctrl;
+} pio_sm_config;
+
+enum pio_fifo_join
+{
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2,
+};
+
+bool pio_can_add_program(PIO pio, const pio_program_t *program);
+uint pio_add_program(PIO pio, const pio_program_t *program);
+int pio_claim_unused_sm(PIO pio, bool required);
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx);
+void pio_gpio_init(PIO pio, uint pin);
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out);
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+void pio_sm_put(PIO pio, uint sm, uint32_t data);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+
+static inline pio_sm_config pio_get_default_sm_config(void)
+{
+    pio_sm_config c = {0, 0, 0, 0};
+    return c;
+}
+
+static inline void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap) {}
+static inline void sm_config_set_set_pins(pio_sm_config *c, uint set_base, uint set_count) {}
+static inline void sm_config_set_out_pins(pio_sm_config *c, uint out_base, uint out_count) {}
+static inline void sm_config_set_clkdiv(pio_sm_config *c, float div) {}
+static inline void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join) {}
+static inline void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold) {}
+static inline void sm_config_set_out_special(pio_sm_config *c, bool sticky, bool has_enable_pin, uint enable_pin_index) {}
+
+#ifdef __cplusplus
+}
+#endif
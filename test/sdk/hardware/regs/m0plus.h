@@ -0,0 +1,20 @@
+#pragma once
+
+// Substituto do hardware/regs/m0plus.h: PPB_BASE (hardware/regs/addressmap.h no SDK) aponta para um
+// vetor do computador, em que o registrador de interrupções pendentes do NVIC acompanha as
+// interrupções levantadas por host_irq_raise e ainda não atendidas
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define M0PLUS_NVIC_ISPR_OFFSET 0x0000e280
+
+extern uint32_t host_ppb[0x10000 / 4];
+#define PPB_BASE ((uintptr_t)host_ppb)
+
+#ifdef __cplusplus
+}
+#endif
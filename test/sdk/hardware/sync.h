@@ -0,0 +1,35 @@
+#pragma once
+
+// Substituto do hardware/sync.h: as barreiras viram barreiras do compilador e da CPU do computador,
+// e as spin locks, travas atômicas (o núcleo 1 é uma thread; veja pico/multicore.h)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __dmb() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __sev() ((void)0)
+#define __wfe() host_wfe()
+#define __wfi() host_wfe()
+
+// Espera por evento: cede a CPU à outra thread ou, em passo travado, devolve a vez (veja host_sdk.h)
+void host_wfe(void);
+
+// Não há interrupções no computador: os tratadores rodam quando o teste os chama
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+typedef volatile uint32_t spin_lock_t;
+
+int spin_lock_claim_unused(bool required);
+spin_lock_t *spin_lock_instance(unsigned int lock_num);
+uint32_t spin_lock_blocking(spin_lock_t *lock);
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq);
+
+#ifdef __cplusplus
+}
+#endif
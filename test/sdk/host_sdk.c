@@ -0,0 +1,1044 @@
+#include "host_sdk.h"
+#include "hardware/sync.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "hardware/irq.h"
+#include "hardware/regs/m0plus.h"
+#include "pico/critical_section.h"
+#include "pico/multicore.h"
+#include <pthread.h>
+#include <time.h>
+
+// Registros e estado compartilhado entre as threads dos núcleos
+static pthread_mutex_t host_lock = PTHREAD_MUTEX_INITIALIZER;
+
+host_i2c_log_t host_i2c;
+static uint32_t i2c_fail_next;
+static host_pio_log_t pio_logs[2][NUM_PIO_STATE_MACHINES];
+
+static i2c_hw_t i2c0_hw_regs = {.status = I2C_IC_STATUS_TFE_BITS};
+static i2c_hw_t i2c1_hw_regs = {.status = I2C_IC_STATUS_TFE_BITS};
+i2c_inst_t i2c0_inst = {&i2c0_hw_regs, false};
+i2c_inst_t i2c1_inst = {&i2c1_hw_regs, false};
+pio_hw_t pio0_hw, pio1_hw;
+
+// ---------------------------------------------------------------------------------------------
+// Interrupções: cada thread (núcleo) guarda quantas vezes as mascarou; uma interrupção levantada
+// com a máscara ativa, ou de dentro de um tratador, roda quando a máscara sai
+
+#define HOST_IRQS 32
+#define HOST_IRQ_HANDLERS 4
+
+static irq_handler_t irq_handlers[HOST_IRQS][HOST_IRQ_HANDLERS];
+static bool irq_enabled[HOST_IRQS];
+
+static __thread uint irq_masked;
+static __thread bool irq_active;
+static __thread uint32_t irq_pending;
+static __thread uint core_num;
+
+// Periféricos do núcleo (PPB): só o registrador de pendentes do NVIC é usado
+uint32_t host_ppb[0x10000 / 4];
+#define HOST_NVIC_ISPR (&host_ppb[M0PLUS_NVIC_ISPR_OFFSET / 4])
+
+static void irq_dispatch(void)
+{
+    if (irq_masked || irq_active)
+        return;
+
+    irq_active = true;
+    while (irq_pending)
+    {
+        uint num = __builtin_ctz(irq_pending);
+        irq_pending &= ~(1u << num);
+        __atomic_fetch_and(HOST_NVIC_ISPR, ~(1u << num), __ATOMIC_RELAXED);
+
+        irq_handler_t handlers[HOST_IRQ_HANDLERS];
+        pthread_mutex_lock(&host_lock);
+        bool enabled = irq_enabled[num];
+        memcpy(handlers, irq_handlers[num], sizeof(handlers));
+        pthread_mutex_unlock(&host_lock);
+
+        for (uint i = 0; enabled && i < HOST_IRQ_HANDLERS; ++i)
+            if (handlers[i])
+                handlers[i]();
+    }
+    irq_active = false;
+}
+
+static void irq_mask(void)
+{
+    irq_masked++;
+}
+
+static void irq_unmask(void)
+{
+    irq_masked--;
+    irq_dispatch();
+}
+
+void host_irq_raise(uint num)
+{
+    irq_pending |= 1u << num;
+    __atomic_fetch_or(HOST_NVIC_ISPR, 1u << num, __ATOMIC_RELAXED);
+    irq_dispatch();
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority)
+{
+    pthread_mutex_lock(&host_lock);
+    for (uint i = 0; i < HOST_IRQ_HANDLERS; ++i)
+        if (!irq_handlers[num][i])
+        {
+            irq_handlers[num][i] = handler;
+            break;
+        }
+    pthread_mutex_unlock(&host_lock);
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+    pthread_mutex_lock(&host_lock);
+    irq_enabled[num] = enabled;
+    pthread_mutex_unlock(&host_lock);
+}
+
+uint32_t save_and_disable_interrupts(void)
+{
+    irq_mask();
+    return 0;
+}
+
+void restore_interrupts(uint32_t status)
+{
+    irq_unmask();
+}
+
+// ---------------------------------------------------------------------------------------------
+// Spin locks e seções críticas
+
+#define HOST_SPIN_LOCKS 32
+
+static spin_lock_t spin_locks[HOST_SPIN_LOCKS];
+static int spin_locks_claimed;
+
+int spin_lock_claim_unused(bool required)
+{
+    pthread_mutex_lock(&host_lock);
+    int lock = spin_locks_claimed < HOST_SPIN_LOCKS ? spin_locks_claimed++ : -1;
+    pthread_mutex_unlock(&host_lock);
+    return lock;
+}
+
+spin_lock_t *spin_lock_instance(unsigned int lock_num)
+{
+    return &spin_locks[lock_num];
+}
+
+uint32_t spin_lock_blocking(spin_lock_t *lock)
+{
+    irq_mask();
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE))
+        sched_yield();
+    return 0;
+}
+
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq)
+{
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+    irq_unmask();
+}
+
+void critical_section_init(critical_section_t *crit_sec)
+{
+    pthread_mutex_init(&crit_sec->mutex, NULL);
+}
+
+void critical_section_enter_blocking(critical_section_t *crit_sec)
+{
+    irq_mask();
+    pthread_mutex_lock(&crit_sec->mutex);
+}
+
+static void core1_spin(void);
+
+void critical_section_exit(critical_section_t *crit_sec)
+{
+    pthread_mutex_unlock(&crit_sec->mutex);
+    irq_unmask();
+    core1_spin();
+}
+
+// ---------------------------------------------------------------------------------------------
+// Núcleos
+
+// Passo travado: o núcleo 1 só roda dentro de host_core1_run, e a vez passa de uma thread à outra
+// sob core1_mutex, de modo que apenas uma delas executa por vez
+static bool core1_lockstep;
+static bool core1_started;
+static bool core1_turn; // A vez é do núcleo 1
+static uint core1_spins;
+static pthread_mutex_t core1_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t core1_cond = PTHREAD_COND_INITIALIZER;
+
+// Passa a vez ao outro núcleo e aguarda que ela volte
+static void core1_handoff(bool to_core1)
+{
+    pthread_mutex_lock(&core1_mutex);
+    core1_turn = to_core1;
+    pthread_cond_broadcast(&core1_cond);
+    while (core1_turn == to_core1)
+        pthread_cond_wait(&core1_cond, &core1_mutex);
+    pthread_mutex_unlock(&core1_mutex);
+}
+
+// Ponto de espera do núcleo 1 fora das seções críticas: depois de HOST_CORE1_SPINS passagens sem
+// dormir, ele só pode estar aguardando o tempo (DMA, barramento) e devolve a vez
+static void core1_spin(void)
+{
+    if (core1_lockstep && core_num == 1 && !irq_masked && ++core1_spins >= HOST_CORE1_SPINS)
+        core1_handoff(false);
+}
+
+static void *core1_thread(void *arg)
+{
+    core_num = 1;
+    if (core1_lockstep)
+    {
+        pthread_mutex_lock(&core1_mutex);
+        while (!core1_turn)
+            pthread_cond_wait(&core1_cond, &core1_mutex);
+        pthread_mutex_unlock(&core1_mutex);
+    }
+    ((void (*)(void))arg)();
+    return NULL;
+}
+
+void multicore_launch_core1(void (*entry)(void))
+{
+    core1_started = true;
+    pthread_t thread;
+    pthread_create(&thread, NULL, core1_thread, (void *)entry);
+    pthread_detach(thread);
+}
+
+void host_core1_lockstep(bool lockstep)
+{
+    core1_lockstep = lockstep;
+}
+
+void host_core1_run(void)
+{
+    if (!core1_lockstep || !core1_started || core_num == 1)
+        return;
+    core1_spins = 0;
+    core1_handoff(true);
+}
+
+void host_wfe(void)
+{
+    if (core1_lockstep && core_num == 1)
+        core1_handoff(false); // Dormindo: nada a fazer até o núcleo 0 mudar algo
+    else
+        sched_yield();
+}
+
+void host_tight_loop(void)
+{
+    if (core1_lockstep && core_num == 0)
+        host_core1_run(); // O núcleo 0 espera pelo 1: é a vez dele
+    else if (core1_lockstep)
+        core1_spin();
+    else
+        sched_yield();
+}
+
+uint get_core_num(void)
+{
+    return core_num;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Tempo e alarmes
+
+static bool time_virtual;
+static uint64_t time_now;
+static uint64_t time_origin;
+
+static uint64_t time_monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+uint64_t time_us_64(void)
+{
+    if (__atomic_load_n(&time_virtual, __ATOMIC_ACQUIRE))
+        return __atomic_load_n(&time_now, __ATOMIC_ACQUIRE);
+    if (!time_origin)
+        time_origin = time_monotonic_us() - 1;
+    return time_monotonic_us() - time_origin;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)time_us_64();
+}
+
+absolute_time_t get_absolute_time(void)
+{
+    return time_us_64();
+}
+
+absolute_time_t make_timeout_time_us(uint64_t us)
+{
+    return time_us_64() + us;
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms)
+{
+    return time_us_64() + (uint64_t)ms * 1000;
+}
+
+bool time_reached(absolute_time_t t)
+{
+    return time_us_64() >= t;
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to)
+{
+    return (int64_t)(to - from);
+}
+
+void sleep_us(uint64_t us)
+{
+    if (time_virtual)
+    {
+        host_time_advance(us);
+        return;
+    }
+    struct timespec ts = {(time_t)(us / 1000000u), (long)(us % 1000000u) * 1000};
+    nanosleep(&ts, NULL);
+    host_alarms_run();
+}
+
+void sleep_ms(uint32_t ms)
+{
+    sleep_us((uint64_t)ms * 1000);
+}
+
+#define HOST_ALARMS 64
+
+typedef struct
+{
+    alarm_id_t id;
+    uint64_t at;
+    alarm_callback_t callback;
+    void *user_data;
+} host_alarm_t;
+
+static host_alarm_t alarms[HOST_ALARMS];
+static alarm_id_t alarm_next_id = 1;
+static alarm_id_t alarm_firing;
+static bool alarm_firing_cancelled;
+
+static alarm_id_t alarm_add_at(uint64_t at, alarm_callback_t callback, void *user_data, alarm_id_t id)
+{
+    pthread_mutex_lock(&host_lock);
+    alarm_id_t added = -1;
+    for (uint i = 0; i < HOST_ALARMS; ++i)
+        if (!alarms[i].id)
+        {
+            added = id ? id : alarm_next_id++;
+            alarms[i] = (host_alarm_t){added, at, callback, user_data};
+            break;
+        }
+    pthread_mutex_unlock(&host_lock);
+    return added;
+}
+
+// Como no SDK 2.x, um alarme com fire_if_past roda no contexto de interrupção do pool (aqui, no
+// próximo host_alarms_run), nunca dentro de quem o adicionou
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return alarm_add_at(time_us_64() + us, callback, user_data, 0);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return add_alarm_in_us((uint64_t)ms * 1000, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id)
+{
+    bool found = false;
+    pthread_mutex_lock(&host_lock);
+    for (uint i = 0; i < HOST_ALARMS; ++i)
+        if (alarm_id && alarms[i].id == alarm_id)
+        {
+            alarms[i].id = 0;
+            found = true;
+        }
+    if (alarm_id && alarm_id == alarm_firing)
+    {
+        alarm_firing_cancelled = true;
+        found = true;
+    }
+    pthread_mutex_unlock(&host_lock);
+    return found;
+}
+
+// Retira e dispara o alarme vencido mais antigo até limit; false se não houver
+static bool alarm_fire_next(uint64_t limit)
+{
+    pthread_mutex_lock(&host_lock);
+    host_alarm_t *next = NULL;
+    for (uint i = 0; i < HOST_ALARMS; ++i)
+        if (alarms[i].id && alarms[i].at <= limit && (!next || alarms[i].at < next->at))
+            next = &alarms[i];
+    if (!next)
+    {
+        pthread_mutex_unlock(&host_lock);
+        return false;
+    }
+    host_alarm_t alarm = *next;
+    next->id = 0;
+    alarm_firing = alarm.id;
+    alarm_firing_cancelled = false;
+    if (time_virtual && time_now < alarm.at)
+        __atomic_store_n(&time_now, alarm.at, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&host_lock);
+
+    // Roda como interrupção do temporizador neste núcleo
+    irq_mask();
+    int64_t delta = alarm.callback(alarm.id, alarm.user_data);
+    irq_masked--;
+
+    pthread_mutex_lock(&host_lock);
+    bool cancelled = alarm_firing_cancelled;
+    alarm_firing = 0;
+    pthread_mutex_unlock(&host_lock);
+
+    if (delta && !cancelled)
+        alarm_add_at(delta < 0 ? alarm.at + (uint64_t)-delta : time_us_64() + (uint64_t)delta,
+                     alarm.callback, alarm.user_data, alarm.id);
+    irq_dispatch();
+    return true;
+}
+
+uint host_alarms_run(void)
+{
+    uint fired = 0;
+    while (fired < 10000 && alarm_fire_next(time_us_64()))
+        fired++;
+    return fired;
+}
+
+uint host_alarms_pending(void)
+{
+    uint pending = 0;
+    pthread_mutex_lock(&host_lock);
+    for (uint i = 0; i < HOST_ALARMS; ++i)
+        pending += alarms[i].id != 0;
+    pthread_mutex_unlock(&host_lock);
+    return pending;
+}
+
+void host_time_set(uint64_t us)
+{
+    __atomic_store_n(&time_now, us, __ATOMIC_RELEASE);
+    __atomic_store_n(&time_virtual, true, __ATOMIC_RELEASE);
+}
+
+void host_time_advance(uint64_t us)
+{
+    uint64_t target = time_us_64() + us;
+    while (alarm_fire_next(target))
+        ;
+    __atomic_store_n(&time_now, target, __ATOMIC_RELEASE);
+}
+
+void host_time_real(void)
+{
+    __atomic_store_n(&time_virtual, false, __ATOMIC_RELEASE);
+}
+
+// Igual ao repeating_timer_callback do SDK: reagenda pelo retorno de delay_us ou zera alarm_id
+static int64_t repeating_timer_trampoline(alarm_id_t id, void *user_data)
+{
+    repeating_timer_t *rt = (repeating_timer_t *)user_data;
+    if (rt->callback(rt))
+        return rt->delay_us;
+    rt->alarm_id = 0;
+    return 0;
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out)
+{
+    out->callback = callback;
+    out->delay_us = delay_us;
+    out->user_data = user_data;
+    out->pool = NULL;
+    out->alarm_id = add_alarm_in_us((uint64_t)(delay_us < 0 ? -delay_us : delay_us),
+                                    repeating_timer_trampoline, out, true);
+    return out->alarm_id > 0;
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out)
+{
+    return add_repeating_timer_us((int64_t)delay_ms * 1000, callback, user_data, out);
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer)
+{
+    bool cancelled = false;
+    if (timer->alarm_id)
+        cancelled = cancel_alarm(timer->alarm_id);
+    timer->alarm_id = 0;
+    return cancelled;
+}
+
+// ---------------------------------------------------------------------------------------------
+// GPIO
+
+#define HOST_GPIOS 30
+
+static bool gpio_level[HOST_GPIOS];
+static bool gpio_levels_ready;
+static gpio_irq_callback_t gpio_callback;
+
+static void gpio_ready(void)
+{
+    if (gpio_levels_ready)
+        return;
+    for (uint i = 0; i < HOST_GPIOS; ++i)
+        gpio_level[i] = true; // Entradas com pull-up e botões soltos
+    gpio_levels_ready = true;
+}
+
+void gpio_init(uint gpio)
+{
+    gpio_ready();
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {}
+void gpio_set_dir(uint gpio, bool out) {}
+void gpio_pull_up(uint gpio) {}
+
+void gpio_put(uint gpio, bool value)
+{
+    gpio_ready();
+    gpio_level[gpio] = value;
+}
+
+bool gpio_get(uint gpio)
+{
+    gpio_ready();
+    return gpio_level[gpio];
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback)
+{
+    gpio_callback = callback;
+}
+
+void host_gpio_set(uint gpio, bool level)
+{
+    gpio_ready();
+    gpio_level[gpio] = level;
+}
+
+void host_gpio_irq(uint gpio, uint32_t event_mask)
+{
+    if (!gpio_callback)
+        return;
+    irq_mask();
+    gpio_callback(gpio, event_mask);
+    irq_unmask();
+}
+
+// ---------------------------------------------------------------------------------------------
+// I2C
+
+static void i2c_log_begin(uint8_t port, uint8_t address, bool dma)
+{
+    host_i2c.transactions++;
+    if (host_i2c.logged < HOST_I2C_LOG_XFERS)
+    {
+        uint32_t offset = host_i2c.logged ? host_i2c.xfers[host_i2c.logged - 1].offset + host_i2c.xfers[host_i2c.logged - 1].length : 0;
+        host_i2c.xfers[host_i2c.logged++] = (host_i2c_xfer_t){port, address, dma, offset, 0};
+    }
+}
+
+static void i2c_log_byte(uint8_t byte)
+{
+    host_i2c.bytes++;
+    if (host_i2c.logged == 0 || host_i2c.logged > HOST_I2C_LOG_XFERS)
+        return;
+    host_i2c_xfer_t *xfer = &host_i2c.xfers[host_i2c.logged - 1];
+    if (xfer->offset + xfer->length < HOST_I2C_LOG_BYTES)
+        host_i2c.data[xfer->offset + xfer->length++] = byte;
+}
+
+// Consome uma recusa pendente; o controlador aborta e descarta a FIFO
+static bool i2c_nack(void)
+{
+    if (!i2c_fail_next)
+        return false;
+    i2c_fail_next--;
+    return true;
+}
+
+void host_i2c_reset(void)
+{
+    pthread_mutex_lock(&host_lock);
+    host_i2c.transactions = host_i2c.bytes = host_i2c.logged = 0;
+    i2c_fail_next = 0;
+    pthread_mutex_unlock(&host_lock);
+}
+
+const uint8_t *host_i2c_bytes(uint32_t index)
+{
+    return host_i2c.data + host_i2c.xfers[index].offset;
+}
+
+void host_i2c_fail_next(uint32_t count)
+{
+    pthread_mutex_lock(&host_lock);
+    i2c_fail_next = count;
+    pthread_mutex_unlock(&host_lock);
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate)
+{
+    i2c->hw->raw_intr_stat = 0;
+    i2c->hw->status = I2C_IC_STATUS_TFE_BITS;
+    i2c->hw->enable = 1;
+    return baudrate;
+}
+
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate)
+{
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    pthread_mutex_lock(&host_lock);
+    if (i2c_nack())
+    {
+        pthread_mutex_unlock(&host_lock);
+        return PICO_ERROR_GENERIC;
+    }
+    i2c_log_begin(i2c == i2c1, addr, false);
+    for (size_t i = 0; i < len; ++i)
+        i2c_log_byte(src[i]);
+    pthread_mutex_unlock(&host_lock);
+    return (int)len;
+}
+
+uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx)
+{
+    return (i2c == i2c1 ? 34 : 32) + !is_tx;
+}
+
+// ---------------------------------------------------------------------------------------------
+// PIO
+
+static uint pio_index(PIO pio)
+{
+    return pio == pio1;
+}
+
+static void pio_log_word(PIO pio, uint sm, uint32_t word)
+{
+    host_pio_log_t *log = &pio_logs[pio_index(pio)][sm];
+    if (log->count < HOST_PIO_LOG_WORDS)
+        log->words[log->count] = word;
+    log->count++;
+    pio->txf[sm] = word;
+}
+
+host_pio_log_t *host_pio_log(PIO pio, uint sm)
+{
+    return &pio_logs[pio_index(pio)][sm];
+}
+
+void host_pio_reset(void)
+{
+    pthread_mutex_lock(&host_lock);
+    for (uint p = 0; p < 2; ++p)
+        for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; ++sm)
+            pio_logs[p][sm].count = 0;
+    pthread_mutex_unlock(&host_lock);
+}
+
+static uint pio_programs[2];
+static uint pio_sms_claimed[2];
+
+bool pio_can_add_program(PIO pio, const pio_program_t *program)
+{
+    return pio_programs[pio_index(pio)] + program->length <= 32;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program)
+{
+    uint offset = pio_programs[pio_index(pio)];
+    pio_programs[pio_index(pio)] += program->length;
+    return offset;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required)
+{
+    uint *claimed = &pio_sms_claimed[pio_index(pio)];
+    for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; ++sm)
+        if (!(*claimed & (1u << sm)))
+        {
+            *claimed |= 1u << sm;
+            return (int)sm;
+        }
+    return -1;
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx)
+{
+    return pio_index(pio) * 8 + sm + (is_tx ? 0 : 4);
+}
+
+void pio_gpio_init(PIO pio, uint pin) {}
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out) {}
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config) {}
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {}
+
+void pio_sm_put(PIO pio, uint sm, uint32_t data)
+{
+    pthread_mutex_lock(&host_lock);
+    pio_log_word(pio, sm, data);
+    pthread_mutex_unlock(&host_lock);
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data)
+{
+    pio_sm_put(pio, sm, data);
+}
+
+// ---------------------------------------------------------------------------------------------
+// DMA
+
+#define DMA_CTRL_SIZE_MASK 0x3u
+#define DMA_CTRL_READ_INCR 0x10u
+#define DMA_CTRL_WRITE_INCR 0x20u
+
+typedef struct
+{
+    bool claimed;
+    bool busy;
+    bool irq0_enabled;
+    bool irq0_status;
+    uint32_t ctrl;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint32_t count;
+    uint32_t transfers;
+    uint64_t due_us; // Com ritmo: instante em que a transferência termina (0 se não houver)
+} host_dma_channel_t;
+
+static host_dma_channel_t dma_channels[NUM_DMA_CHANNELS];
+static bool dma_hold;
+static uint32_t dma_pace_i2c_ns, dma_pace_pio_ns;
+
+int dma_claim_unused_channel(bool required)
+{
+    pthread_mutex_lock(&host_lock);
+    int channel = -1;
+    for (uint i = 0; i < NUM_DMA_CHANNELS; ++i)
+        if (!dma_channels[i].claimed)
+        {
+            dma_channels[i] = (host_dma_channel_t){.claimed = true};
+            channel = (int)i;
+            break;
+        }
+    pthread_mutex_unlock(&host_lock);
+    return channel;
+}
+
+void dma_channel_unclaim(uint channel)
+{
+    pthread_mutex_lock(&host_lock);
+    dma_channels[channel].claimed = false;
+    pthread_mutex_unlock(&host_lock);
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    dma_channel_config c = {DMA_SIZE_32 | DMA_CTRL_READ_INCR};
+    return c;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size)
+{
+    c->ctrl = (c->ctrl & ~DMA_CTRL_SIZE_MASK) | size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr)
+{
+    c->ctrl = incr ? c->ctrl | DMA_CTRL_READ_INCR : c->ctrl & ~DMA_CTRL_READ_INCR;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr)
+{
+    c->ctrl = incr ? c->ctrl | DMA_CTRL_WRITE_INCR : c->ctrl & ~DMA_CTRL_WRITE_INCR;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {}
+
+// Lê a palavra i da origem conforme o tamanho configurado
+static uint32_t dma_read(const host_dma_channel_t *ch, uint32_t i)
+{
+    uint32_t index = ch->ctrl & DMA_CTRL_READ_INCR ? i : 0;
+    switch (ch->ctrl & DMA_CTRL_SIZE_MASK)
+    {
+    case DMA_SIZE_8:
+        return ((const volatile uint8_t *)ch->read_addr)[index];
+    case DMA_SIZE_16:
+        return ((const volatile uint16_t *)ch->read_addr)[index];
+    default:
+        return ((const volatile uint32_t *)ch->read_addr)[index];
+    }
+}
+
+// Entrega as palavras ao destino: IC_DATA_CMD de um I2C (quebrando as transações no bit STOP) ou a
+// FIFO de uma máquina de estados
+static void dma_deliver(host_dma_channel_t *ch)
+{
+    for (uint port = 0; port < 2; ++port)
+    {
+        i2c_inst_t *i2c = port ? i2c1 : i2c0;
+        if (ch->write_addr != &i2c->hw->data_cmd)
+            continue;
+
+        if (i2c_nack())
+        {
+            i2c->hw->raw_intr_stat |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+            return;
+        }
+        bool open = false;
+        for (uint32_t i = 0; i < ch->count; ++i)
+        {
+            uint32_t word = dma_read(ch, i);
+            if (!open)
+                i2c_log_begin(port, (uint8_t)i2c->hw->tar, true);
+            open = !(word & I2C_IC_DATA_CMD_STOP_BITS);
+            if (!(word & I2C_IC_DATA_CMD_CMD_BITS))
+                i2c_log_byte((uint8_t)word);
+        }
+        return;
+    }
+
+    for (uint p = 0; p < 2; ++p)
+    {
+        PIO pio = p ? pio1 : pio0;
+        for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; ++sm)
+            if (ch->write_addr == &pio->txf[sm])
+            {
+                for (uint32_t i = 0; i < ch->count; ++i)
+                    pio_log_word(pio, sm, dma_read(ch, i));
+                return;
+            }
+    }
+}
+
+// Duração de uma palavra no destino do canal, conforme host_dma_pace (0 sem ritmo)
+static uint32_t dma_word_ns(const host_dma_channel_t *ch)
+{
+    if (ch->write_addr == &i2c0->hw->data_cmd || ch->write_addr == &i2c1->hw->data_cmd)
+        return dma_pace_i2c_ns;
+    return dma_pace_pio_ns;
+}
+
+static void dma_start(uint channel)
+{
+    pthread_mutex_lock(&host_lock);
+    host_dma_channel_t *ch = &dma_channels[channel];
+    ch->busy = true;
+    ch->transfers++;
+    for (uint port = 0; port < 2; ++port)
+    {
+        i2c_inst_t *i2c = port ? i2c1 : i2c0;
+        if (ch->write_addr == &i2c->hw->data_cmd)
+            i2c->hw->raw_intr_stat &= ~I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS; // Lido de clr_tx_abrt no firmware
+    }
+    uint32_t word_ns = dma_word_ns(ch);
+    ch->due_us = word_ns ? time_us_64() + ((uint64_t)ch->count * word_ns + 999) / 1000 : 0;
+    bool hold = dma_hold || word_ns;
+    pthread_mutex_unlock(&host_lock);
+
+    if (!hold)
+        host_dma_complete(channel);
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger)
+{
+    pthread_mutex_lock(&host_lock);
+    host_dma_channel_t *ch = &dma_channels[channel];
+    ch->ctrl = config->ctrl;
+    ch->write_addr = write_addr;
+    ch->read_addr = read_addr;
+    ch->count = transfer_count;
+    pthread_mutex_unlock(&host_lock);
+    if (trigger)
+        dma_start(channel);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count)
+{
+    pthread_mutex_lock(&host_lock);
+    dma_channels[channel].read_addr = read_addr;
+    dma_channels[channel].count = transfer_count;
+    pthread_mutex_unlock(&host_lock);
+    dma_start(channel);
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+    pthread_mutex_lock(&host_lock);
+    host_dma_channel_t *ch = &dma_channels[channel];
+    bool busy = ch->busy;
+    bool done = busy && ch->due_us && time_us_64() >= ch->due_us;
+    pthread_mutex_unlock(&host_lock);
+
+    // Com ritmo, quem consulta o canal vê o término no prazo, sem depender da thread que chama host_dma_run
+    if (done && host_dma_complete(channel))
+        busy = false;
+    return busy;
+}
+
+void dma_channel_abort(uint channel)
+{
+    pthread_mutex_lock(&host_lock);
+    dma_channels[channel].busy = false;
+    pthread_mutex_unlock(&host_lock);
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled)
+{
+    pthread_mutex_lock(&host_lock);
+    dma_channels[channel].irq0_enabled = enabled;
+    pthread_mutex_unlock(&host_lock);
+}
+
+bool dma_channel_get_irq0_status(uint channel)
+{
+    pthread_mutex_lock(&host_lock);
+    bool status = dma_channels[channel].irq0_status;
+    pthread_mutex_unlock(&host_lock);
+    return status;
+}
+
+void dma_channel_acknowledge_irq0(uint channel)
+{
+    pthread_mutex_lock(&host_lock);
+    dma_channels[channel].irq0_status = false;
+    pthread_mutex_unlock(&host_lock);
+}
+
+void host_dma_hold(bool hold)
+{
+    pthread_mutex_lock(&host_lock);
+    dma_hold = hold;
+    pthread_mutex_unlock(&host_lock);
+}
+
+bool host_dma_complete(uint channel)
+{
+    pthread_mutex_lock(&host_lock);
+    host_dma_channel_t *ch = &dma_channels[channel];
+    if (!ch->busy)
+    {
+        pthread_mutex_unlock(&host_lock);
+        return false;
+    }
+    dma_deliver(ch);
+    ch->busy = false;
+    ch->due_us = 0;
+    bool irq = ch->irq0_enabled;
+    if (irq)
+        ch->irq0_status = true;
+    pthread_mutex_unlock(&host_lock);
+
+    if (irq)
+        host_irq_raise(DMA_IRQ_0);
+    return true;
+}
+
+void host_dma_pace(uint32_t i2c_word_ns, uint32_t pio_word_ns)
+{
+    pthread_mutex_lock(&host_lock);
+    dma_pace_i2c_ns = i2c_word_ns;
+    dma_pace_pio_ns = pio_word_ns;
+    pthread_mutex_unlock(&host_lock);
+}
+
+uint host_dma_run(void)
+{
+    uint completed = 0;
+    for (uint channel = 0; channel < NUM_DMA_CHANNELS; ++channel)
+    {
+        pthread_mutex_lock(&host_lock);
+        uint64_t due = dma_channels[channel].busy ? dma_channels[channel].due_us : 0;
+        pthread_mutex_unlock(&host_lock);
+        if (due && time_us_64() >= due && host_dma_complete(channel))
+            completed++;
+    }
+    return completed;
+}
+
+uint32_t host_dma_transfers(uint channel)
+{
+    pthread_mutex_lock(&host_lock);
+    uint32_t transfers = dma_channels[channel].transfers;
+    pthread_mutex_unlock(&host_lock);
+    return transfers;
+}
+
+uint64_t host_next_event_us(void)
+{
+    uint64_t next = UINT64_MAX;
+    pthread_mutex_lock(&host_lock);
+    for (uint i = 0; i < HOST_ALARMS; ++i)
+        if (alarms[i].id && alarms[i].at < next)
+            next = alarms[i].at;
+    for (uint i = 0; i < NUM_DMA_CHANNELS; ++i)
+        if (dma_channels[i].busy && dma_channels[i].due_us && dma_channels[i].due_us < next)
+            next = dma_channels[i].due_us;
+    pthread_mutex_unlock(&host_lock);
+    return next;
+}
+
+// ---------------------------------------------------------------------------------------------
+
+void host_reset(void)
+{
+    host_time_real();
+    host_i2c_reset();
+    host_pio_reset();
+
+    pthread_mutex_lock(&host_lock);
+    memset(alarms, 0, sizeof(alarms));
+    memset(dma_channels, 0, sizeof(dma_channels));
+    memset(irq_handlers, 0, sizeof(irq_handlers));
+    memset(irq_enabled, 0, sizeof(irq_enabled));
+    memset(host_ppb, 0, sizeof(host_ppb));
+    dma_hold = false;
+    dma_pace_i2c_ns = dma_pace_pio_ns = 0;
+    spin_locks_claimed = 0;
+    pio_programs[0] = pio_programs[1] = 0;
+    pio_sms_claimed[0] = pio_sms_claimed[1] = 0;
+    gpio_levels_ready = false;
+    gpio_callback = NULL;
+    i2c0_hw_regs = i2c1_hw_regs = (i2c_hw_t){.status = I2C_IC_STATUS_TFE_BITS};
+    pthread_mutex_unlock(&host_lock);
+}
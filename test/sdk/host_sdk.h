@@ -0,0 +1,106 @@
+#pragma once
+
+// Controle e registro dos substitutos do Pico SDK usados pelos testes no computador.
+// O que o firmware escreve no barramento I2C e nas FIFOs do PIO fica gravado aqui, e o tempo, os
+// alarmes, o DMA e as interrupções avançam quando o teste pede.
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/pio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Registro do barramento I2C: uma entrada por transação (até o bit STOP ou o fim da escrita)
+#define HOST_I2C_LOG_XFERS 4096
+#define HOST_I2C_LOG_BYTES (1u << 20)
+
+typedef struct
+{
+    uint8_t port;     // 0 ou 1
+    uint8_t address;  // Endereço de 7 bits
+    bool dma;         // Veio de DMA para IC_DATA_CMD (e não de i2c_write_blocking)
+    uint32_t offset;  // Início dos dados em host_i2c.data
+    uint32_t length;  // Bytes escritos, sem o byte de endereço
+} host_i2c_xfer_t;
+
+typedef struct
+{
+    uint32_t transactions; // Total, mesmo além da capacidade do registro
+    uint32_t bytes;        // Bytes de dados, sem o byte de endereço
+    uint32_t logged;       // Transações guardadas em xfers
+    host_i2c_xfer_t xfers[HOST_I2C_LOG_XFERS];
+    uint8_t data[HOST_I2C_LOG_BYTES];
+} host_i2c_log_t;
+
+extern host_i2c_log_t host_i2c;
+
+void host_i2c_reset(void);
+const uint8_t *host_i2c_bytes(uint32_t index);
+
+// As próximas count transações são recusadas (NACK): i2c_write_blocking retorna erro e o DMA
+// liga TX_ABRT em raw_intr_stat sem gravar nada
+void host_i2c_fail_next(uint32_t count);
+
+// Registro das palavras colocadas na FIFO de transmissão de cada máquina de estados
+#define HOST_PIO_LOG_WORDS 65536
+
+typedef struct
+{
+    uint32_t count; // Total, mesmo além da capacidade do registro
+    uint32_t words[HOST_PIO_LOG_WORDS];
+} host_pio_log_t;
+
+host_pio_log_t *host_pio_log(PIO pio, uint sm);
+void host_pio_reset(void);
+
+// DMA: com hold, os canais ficam ocupados até host_dma_complete; as palavras são entregues ao
+// destino ao completar, lendo o buffer de origem naquele momento
+void host_dma_hold(bool hold);
+bool host_dma_complete(uint channel);
+uint32_t host_dma_transfers(uint channel);
+
+// Ritmo do barramento: com valores diferentes de zero, cada transferência para o I2C ou para o PIO
+// leva count palavras vezes a duração dada; host_dma_run (e dma_channel_is_busy, para o próprio
+// canal) completa as que já terminaram
+void host_dma_pace(uint32_t i2c_word_ns, uint32_t pio_word_ns);
+uint host_dma_run(void);
+
+// Tempo virtual: a partir de host_time_set o relógio só anda com host_time_advance, que dispara os
+// alarmes vencidos em ordem, cada um no seu instante
+void host_time_set(uint64_t us);
+void host_time_advance(uint64_t us);
+void host_time_real(void);
+
+// Próximo instante em que algo acontece sozinho: alarme pendente ou término de um DMA com ritmo
+// (UINT64_MAX se não houver); com o tempo virtual, o teste pode avançar direto até ele
+uint64_t host_next_event_us(void);
+
+// Dispara os alarmes já vencidos (com relógio real ou virtual); retorna quantos rodaram
+uint host_alarms_run(void);
+uint host_alarms_pending(void);
+
+// Chama os tratadores registrados para a interrupção, se estiver habilitada; com as interrupções
+// mascaradas, ela fica pendente (também no NVIC de hardware/regs/m0plus.h) até restore_interrupts
+void host_irq_raise(uint num);
+
+// Núcleo 1 em passo travado com o tempo virtual (antes de multicore_launch_core1): a thread do núcleo 1
+// só roda dentro de host_core1_run, que retorna quando ele dorme em __wfe ou passa HOST_CORE1_SPINS
+// vezes pelo fim de uma seção crítica sem dormir (aguardando o tempo andar). Apenas uma thread executa
+// por vez, e o resultado depende só das entradas
+#define HOST_CORE1_SPINS 256
+
+void host_core1_lockstep(bool lockstep);
+void host_core1_run(void);
+
+// Entradas e saídas digitais
+void host_gpio_set(uint gpio, bool level);
+void host_gpio_irq(uint gpio, uint32_t event_mask);
+
+// Volta todos os substitutos ao estado inicial (registros, canais, alarmes, tempo real)
+void host_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+// Substituto do pico/critical_section.h: uma seção crítica é um mutex entre as threads dos núcleos
+
+#include <pthread.h>
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+} critical_section_t;
+
+void critical_section_init(critical_section_t *crit_sec);
+void critical_section_enter_blocking(critical_section_t *crit_sec);
+void critical_section_exit(critical_section_t *crit_sec);
+
+#ifdef __cplusplus
+}
+#endif
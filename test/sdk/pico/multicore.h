@@ -0,0 +1,15 @@
+#pragma once
+
+// Substituto do pico/multicore.h: o núcleo 1 é uma thread que roda até o fim do processo
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void multicore_launch_core1(void (*entry)(void));
+
+#ifdef __cplusplus
+}
+#endif
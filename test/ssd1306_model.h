@@ -0,0 +1,153 @@
+#pragma once
+
+// Modelo do controlador SSD1306 para os testes: interpreta as transações I2C registradas pelos
+// substitutos do SDK (bytes de controle, comandos com parâmetros e dados) e mantém a GDDRAM, para
+// comparar o que chegou ao display com o ram_buffer do driver
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "host_sdk.h"
+#include "ssd1306.h"
+
+typedef struct
+{
+    uint8_t gddram[128][SSD1306_MAX_PAGES]; // [coluna][página]
+    uint8_t mode;                           // 0 horizontal, 1 vertical, 2 página
+    uint8_t col0, col1, page0, page1;       // Janela de escrita
+    uint8_t col, page;                      // Posição de escrita
+    uint8_t start_line;
+    bool on;
+    uint32_t commands;   // Comandos recebidos (sem contar parâmetros)
+    uint32_t data_bytes; // Bytes gravados na GDDRAM
+    uint8_t command;     // Comando aguardando parâmetros
+    uint8_t params[2];
+    uint8_t nparams, need;
+} ssd1306_model_t;
+
+static inline void ssd1306_model_init(ssd1306_model_t *m)
+{
+    memset(m, 0, sizeof(*m));
+    m->mode = 2;
+    m->col1 = 127;
+    m->page1 = SSD1306_MAX_PAGES - 1;
+}
+
+static inline uint8_t ssd1306_model_params(uint8_t command)
+{
+    switch (command)
+    {
+    case SET_COL_ADDR:
+    case SET_PAGE_ADDR:
+        return 2;
+    case SET_MEM_ADDR:
+    case SET_MUX_RATIO:
+    case SET_DISP_OFFSET:
+    case SET_COM_PIN_CFG:
+    case SET_DISP_CLK_DIV:
+    case SET_PRECHARGE:
+    case SET_VCOM_DESEL:
+    case SET_CONTRAST:
+    case SET_CHARGE_PUMP:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static inline void ssd1306_model_execute(ssd1306_model_t *m)
+{
+    switch (m->command)
+    {
+    case SET_MEM_ADDR:
+        m->mode = m->params[0] & 3;
+        break;
+    case SET_COL_ADDR:
+        m->col = m->col0 = m->params[0];
+        m->col1 = m->params[1];
+        break;
+    case SET_PAGE_ADDR:
+        m->page = m->page0 = m->params[0];
+        m->page1 = m->params[1];
+        break;
+    case SET_DISP:
+    case SET_DISP | 1:
+        m->on = m->command & 1;
+        break;
+    default:
+        if ((m->command & 0xC0) == SET_DISP_START_LINE)
+            m->start_line = m->command & 0x3F;
+        break;
+    }
+}
+
+static inline void ssd1306_model_command(ssd1306_model_t *m, uint8_t byte)
+{
+    if (m->need)
+    {
+        m->params[m->nparams++] = byte;
+        if (m->nparams == m->need)
+        {
+            m->need = 0;
+            ssd1306_model_execute(m);
+        }
+        return;
+    }
+    m->commands++;
+    m->command = byte;
+    m->nparams = 0;
+    m->need = ssd1306_model_params(byte);
+    if (!m->need)
+        ssd1306_model_execute(m);
+}
+
+// Grava um byte de dados e avança a posição como no modo vertical (o único usado pelo driver)
+static inline void ssd1306_model_data(ssd1306_model_t *m, uint8_t byte)
+{
+    m->gddram[m->col & 127][m->page & (SSD1306_MAX_PAGES - 1)] = byte;
+    m->data_bytes++;
+    if (m->page++ >= m->page1)
+    {
+        m->page = m->page0;
+        if (m->col++ >= m->col1)
+            m->col = m->col0;
+    }
+}
+
+// Interpreta uma transação: Co = 1 vale só para o byte seguinte; Co = 0 vale até o fim
+static inline void ssd1306_model_apply(ssd1306_model_t *m, const uint8_t *bytes, uint32_t length)
+{
+    uint32_t i = 0;
+    while (i < length)
+    {
+        uint8_t control = bytes[i++];
+        bool data = control & 0x40;
+        if (control & 0x80)
+        {
+            if (i < length)
+                data ? ssd1306_model_data(m, bytes[i]) : ssd1306_model_command(m, bytes[i]);
+            ++i;
+            continue;
+        }
+        for (; i < length; ++i)
+            data ? ssd1306_model_data(m, bytes[i]) : ssd1306_model_command(m, bytes[i]);
+    }
+}
+
+// Aplica as transações do registro a partir de first (todas ao endereço address)
+static inline void ssd1306_model_replay(ssd1306_model_t *m, uint32_t first, uint8_t address)
+{
+    for (uint32_t i = first; i < host_i2c.logged; ++i)
+        if (host_i2c.xfers[i].address == address)
+            ssd1306_model_apply(m, host_i2c_bytes(i), host_i2c.xfers[i].length);
+}
+
+// Verdadeiro se a GDDRAM do modelo é igual ao quadro do driver
+static inline bool ssd1306_model_matches(const ssd1306_model_t *m, const ssd1306_t *ssd)
+{
+    for (uint8_t x = 0; x < ssd->width; ++x)
+        for (uint8_t page = 0; page < ssd->pages; ++page)
+            if (m->gddram[x][page] != ssd->ram_buffer[1 + x * ssd->pages + page])
+                return false;
+    return true;
+}
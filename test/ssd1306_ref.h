@@ -0,0 +1,70 @@
+#pragma once
+
+// Referência pixel a pixel para os testes de desenho: opera sobre uma cópia do quadro no mesmo layout
+// do ram_buffer (0x40 seguido das colunas, página a página), sem nenhum dos atalhos do driver
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1306.h"
+
+static inline bool ref_get(const ssd1306_t *ssd, const uint8_t *buffer, int x, int y)
+{
+    return (buffer[1 + x * ssd->pages + y / 8] >> (y % 8)) & 1;
+}
+
+// Altera um pixel; fora do display não faz nada
+static inline void ref_put(const ssd1306_t *ssd, uint8_t *buffer, int x, int y, bool value)
+{
+    if (x < 0 || y < 0 || x >= ssd->width || y >= ssd->height)
+        return;
+    uint8_t *byte = &buffer[1 + x * ssd->pages + y / 8];
+    *byte = value ? *byte | (1u << (y % 8)) : *byte & ~(1u << (y % 8));
+}
+
+// Aplica o modo de desenho a um pixel em que a imagem (ou a área) vale on
+static inline void ref_apply(const ssd1306_t *ssd, uint8_t *buffer, int x, int y, bool on, ssd1306_mode_t mode)
+{
+    if (x < 0 || y < 0 || x >= ssd->width || y >= ssd->height)
+        return;
+    bool old = ref_get(ssd, buffer, x, y);
+    switch (mode)
+    {
+    case SSD1306_SET:
+        ref_put(ssd, buffer, x, y, old || on);
+        break;
+    case SSD1306_CLEAR:
+        ref_put(ssd, buffer, x, y, old && !on);
+        break;
+    case SSD1306_XOR:
+        ref_put(ssd, buffer, x, y, old != on);
+        break;
+    case SSD1306_COPY:
+        ref_put(ssd, buffer, x, y, on);
+        break;
+    }
+}
+
+// Preenche o quadro e a referência com o mesmo ruído e limpa as regiões alteradas
+static inline void ref_noise(ssd1306_t *ssd, uint8_t *reference)
+{
+    for (size_t i = 1; i < ssd->bufsize; ++i)
+        ssd->ram_buffer[i] = (uint8_t)rand();
+    memcpy(reference, ssd->ram_buffer, ssd->bufsize);
+    memset(ssd->dirty_x0, 0xFF, sizeof(ssd->dirty_x0));
+    memset(ssd->dirty_x1, 0, sizeof(ssd->dirty_x1));
+}
+
+// Verdadeiro se toda coluna alterada em relação a before está dentro da região marcada da sua página
+static inline bool ref_dirty_covers(const ssd1306_t *ssd, const uint8_t *before)
+{
+    for (int x = 0; x < ssd->width; ++x)
+        for (int page = 0; page < ssd->pages; ++page)
+        {
+            size_t i = 1 + x * ssd->pages + page;
+            if (ssd->ram_buffer[i] != before[i] && (x < ssd->dirty_x0[page] || x > ssd->dirty_x1[page]))
+                return false;
+        }
+    return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// Verificações dos testes no computador: cada falha imprime o local e os valores, e o teste
+// termina com código de erro (veja TEST_RESULT)
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int test_failures;
+
+#define CHECK(cond)                                                               \
+    do                                                                            \
+    {                                                                             \
+        if (!(cond))                                                              \
+        {                                                                         \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond);    \
+            test_failures++;                                                      \
+        }                                                                         \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                                   \
+    do                                                                                               \
+    {                                                                                                \
+        long long a_ = (long long)(actual), e_ = (long long)(expected);                              \
+        if (a_ != e_)                                                                                \
+        {                                                                                            \
+            fprintf(stderr, "%s:%d: %s = %lld, esperado %lld\n", __FILE__, __LINE__, #actual, a_, e_); \
+            test_failures++;                                                                         \
+        }                                                                                            \
+    } while (0)
+
+// Resultado do main: imprime o resumo e retorna 0 apenas sem falhas
+#define TEST_RESULT(name) \
+    (printf("%s: %s\n", name, test_failures ? "FALHOU" : "ok"), test_failures ? 1 : 0)
@@ -0,0 +1,80 @@
+// Console rolante (user-018): depois de cada linha, a tela vista pelo display (GDDRAM do modelo lida
+// a partir da linha inicial) mostra as últimas linhas em ordem, e cada linha custa uma página no I2C
+
+#include "test.h"
+#include "ssd1306_model.h"
+#include "console.h"
+
+#define ADDRESS 0x3C
+#define LINES 40
+
+static uint8_t ssd_ram[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(128, 64)];
+static uint8_t ref_ram[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t ref_tx[SSD1306_TX_BUFFER_SIZE(128, 64)];
+
+static ssd1306_t ssd, ref;
+static ssd1306_model_t model;
+static char texts[LINES][24];
+
+// Confere a linha visível row com o texto desenhado sozinho em outro buffer (NULL: linha em branco)
+static bool row_shows(uint8_t row, const char *text)
+{
+    ssd1306_fill(&ref, false);
+    char line[CONSOLE_COLS + 1];
+    snprintf(line, sizeof(line), "%-*.*s", CONSOLE_COLS, CONSOLE_COLS, text ? text : "");
+    for (uint8_t i = 0; i < CONSOLE_COLS; ++i)
+        ssd1306_draw_char(&ref, line[i], i * 8, 0);
+
+    // O display mostra no topo a linha da GDDRAM indicada pela linha inicial
+    uint8_t page = (model.start_line / 8 + row) % 8;
+    for (uint8_t x = 0; x < 128; ++x)
+        if (model.gddram[x][page] != ref_ram[1 + x * 8])
+            return false;
+    return true;
+}
+
+int main(void)
+{
+    srand(18);
+    host_reset();
+    ssd1306_model_init(&model);
+    ssd1306_init_with_buffers(&ssd, 128, 64, false, ADDRESS, i2c1, ssd_ram, ssd_tx, NULL);
+    ssd1306_init_with_buffers(&ref, 128, 64, false, ADDRESS, i2c0, ref_ram, ref_tx, NULL);
+    ssd1306_config(&ssd);
+
+    console_t con;
+    console_init(&con, &ssd);
+    ssd1306_send_data(&ssd);
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    for (uint8_t row = 0; row < 8; ++row)
+        CHECK(row_shows(row, NULL));
+
+    for (uint n = 0; n < LINES; ++n)
+    {
+        // Linhas curtas, cheias e longas (truncadas em CONSOLE_COLS)
+        uint length = rand() % 22;
+        for (uint i = 0; i < length; ++i)
+            texts[n][i] = (char)('A' + (n + i) % 26);
+        texts[n][length] = '\0';
+
+        host_i2c_reset();
+        console_write_line(&con, texts[n]);
+        ssd1306_send_dirty(&ssd);
+
+        // Só a página da nova linha e, com a tela cheia, a nova linha inicial
+        bool scrolled = n >= 8;
+        CHECK_EQ(host_i2c.transactions, scrolled ? 2 : 1);
+        CHECK_EQ(host_i2c.bytes, SSD1306_WINDOW_HEADER + 128 + (scrolled ? 2 : 0));
+        ssd1306_model_replay(&model, 0, ADDRESS);
+        CHECK(ssd1306_model_matches(&model, &ssd));
+
+        // Tela: as últimas min(n + 1, 8) linhas, da mais antiga à mais nova, e o restante em branco
+        uint shown = n + 1 < 8 ? n + 1 : 8;
+        for (uint8_t row = 0; row < 8; ++row)
+            CHECK(row_shows(row, row < shown ? texts[n + 1 - shown + row] : NULL));
+        CHECK_EQ(model.start_line, scrolled ? ((n - 7) % 8) * 8 : 0);
+        CHECK_EQ(con.lines, n + 1);
+    }
+    return TEST_RESULT("test_console");
+}
@@ -0,0 +1,109 @@
+// Fila de eventos da interrupção para o laço principal (user-008): rajadas maiores que a fila,
+// índices que dão a volta em 32 bits e um produtor em outra thread contra o consumidor
+
+#include <pthread.h>
+#include "test.h"
+#include "event_queue.h"
+
+#define BURSTS 20000
+#define BURST 48 // Mais que EVENT_QUEUE_SIZE: parte de cada rajada é descartada se o consumidor atrasar
+
+static event_queue_t queue;
+
+static event_t make_event(uint32_t seq)
+{
+    event_t event = {seq, (uint8_t)(seq % 3), (uint8_t)(seq * 7)};
+    return event;
+}
+
+// Rajada com o consumidor parado: entram EVENT_QUEUE_SIZE eventos, em ordem, e o resto é contado
+static void test_burst(uint32_t start_index)
+{
+    event_queue_init(&queue);
+    queue.head = queue.tail = start_index;
+
+    for (uint32_t seq = 0; seq < 40; ++seq)
+    {
+        event_t event = make_event(seq);
+        CHECK_EQ(event_queue_push(&queue, &event), seq < EVENT_QUEUE_SIZE);
+    }
+    CHECK_EQ(queue.dropped, 40 - EVENT_QUEUE_SIZE);
+
+    event_t event;
+    for (uint32_t seq = 0; seq < EVENT_QUEUE_SIZE; ++seq)
+    {
+        CHECK(event_queue_pop(&queue, &event));
+        CHECK_EQ(event.time_us, seq);
+        CHECK_EQ(event.type, seq % 3);
+        CHECK_EQ(event.data, (uint8_t)(seq * 7));
+    }
+    CHECK(!event_queue_pop(&queue, &event));
+    CHECK(event_queue_empty(&queue));
+
+    // Depois de esvaziar, cabe uma rajada inteira de novo
+    for (uint32_t seq = 0; seq < EVENT_QUEUE_SIZE; ++seq)
+    {
+        event = make_event(seq);
+        CHECK(event_queue_push(&queue, &event));
+    }
+    CHECK_EQ(queue.dropped, 40 - EVENT_QUEUE_SIZE);
+}
+
+static volatile bool producer_done;
+static uint32_t accepted;
+
+// Produtor em rajadas, como as bordas de vários botões em sequência
+static void *producer(void *arg)
+{
+    uint32_t seq = 0;
+    for (int burst = 0; burst < BURSTS; ++burst)
+    {
+        for (int i = 0; i < BURST; ++i, ++seq)
+        {
+            event_t event = make_event(seq);
+            accepted += event_queue_push(&queue, &event);
+        }
+        sched_yield();
+    }
+    __atomic_store_n(&producer_done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// Consumidor em outra thread: nunca vê um evento fora de ordem, repetido ou incompleto
+static void test_concurrent(void)
+{
+    event_queue_init(&queue);
+    queue.head = queue.tail = 0xFFFFF000u;
+    pthread_t thread;
+    pthread_create(&thread, NULL, producer, NULL);
+
+    uint32_t popped = 0, last = 0;
+    bool first = true, ordered = true, intact = true;
+    event_t event;
+    while (!__atomic_load_n(&producer_done, __ATOMIC_ACQUIRE) || !event_queue_empty(&queue))
+    {
+        if (!event_queue_pop(&queue, &event))
+            continue;
+        ordered &= first || event.time_us > last;
+        intact &= event.type == event.time_us % 3 && event.data == (uint8_t)(event.time_us * 7);
+        last = event.time_us;
+        first = false;
+        popped++;
+    }
+    pthread_join(thread, NULL);
+
+    CHECK(ordered);
+    CHECK(intact);
+    CHECK_EQ(popped, accepted);
+    CHECK_EQ(popped + queue.dropped, BURSTS * BURST);
+    printf("rajadas de %d: %lu eventos entregues, %lu descartados\n", BURST, (unsigned long)popped,
+           (unsigned long)queue.dropped);
+}
+
+int main(void)
+{
+    test_burst(0);
+    test_burst(0xFFFFFFF0u); // Os índices dão a volta durante a rajada
+    test_concurrent();
+    return TEST_RESULT("test_event_queue");
+}
@@ -0,0 +1,75 @@
+// Fonte gerada (user-015): os glifos de fonts/font8x8.bdf convertidos por tools/bdf2font.py são
+// conferidos byte a byte com a tabela antiga de inc/font_legacy.h, na tabela e no desenho de
+// ssd1306_draw_char, para que uma tabela regenerada não altere o display sem ser notada
+
+#include "test.h"
+#include "host_sdk.h"
+#include "ssd1306.h"
+#include "font_table.h"
+#include "font_legacy.h"
+
+static uint8_t ssd_ram[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(128, 64)];
+
+// Caracteres da tabela antiga, na ordem dos seus glifos (o glifo 0 é o vazio)
+static const char legacy_chars[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+// Célula de 8 colunas do glifo gerado: colunas vazias à esquerda, as do glifo e vazias à direita
+static void generated_cell(char c, uint8_t cell[8])
+{
+    memset(cell, 0, 8);
+    const font_glyph_t *glyph = font_glyph(&font8x8, c);
+    CHECK(glyph != NULL);
+    if (!glyph || !glyph->width)
+        return;
+    CHECK(glyph->left + glyph->width <= 8);
+    memcpy(&cell[glyph->left], font_glyph_columns(&font8x8, glyph, 0), glyph->width);
+}
+
+static void test_table(void)
+{
+    CHECK_EQ(font8x8.height, 8);
+    CHECK_EQ(font8x8.pages, 1);
+    CHECK_EQ(font8x8.cell, 8);
+    CHECK_EQ(sizeof(legacy_chars) - 1, LEGACY_FONT_GLYPHS - 1);
+
+    for (uint i = 0; legacy_chars[i]; ++i)
+    {
+        uint8_t cell[8];
+        generated_cell(legacy_chars[i], cell);
+        if (memcmp(cell, &legacy_font[(i + 1) * 8], 8) != 0)
+        {
+            fprintf(stderr, "glifo '%c' difere da tabela antiga\n", legacy_chars[i]);
+            CHECK(false);
+        }
+    }
+}
+
+// ssd1306_draw_char em cada posição de página de um quadro apagado: a coluna x + i recebe o byte i
+static void test_draw_char(void)
+{
+    ssd1306_t ssd;
+    host_reset();
+    ssd1306_init_with_buffers(&ssd, 128, 64, false, 0x3C, i2c1, ssd_ram, ssd_tx, NULL);
+
+    for (uint i = 0; legacy_chars[i]; ++i)
+    {
+        uint8_t x = (i * 8) % 120, page = (i / 15) % 8;
+        ssd1306_fill(&ssd, false);
+        ssd1306_draw_char(&ssd, legacy_chars[i], x, page * 8);
+        for (uint col = 0; col < 8; ++col)
+            if (ssd.ram_buffer[1 + (x + col) * ssd.pages + page] != legacy_font[(i + 1) * 8 + col])
+            {
+                fprintf(stderr, "ssd1306_draw_char('%c') difere da tabela antiga na coluna %u\n", legacy_chars[i], col);
+                CHECK(false);
+                break;
+            }
+    }
+}
+
+int main(void)
+{
+    test_table();
+    test_draw_char();
+    return TEST_RESULT("test_font_table");
+}
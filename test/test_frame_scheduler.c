@@ -0,0 +1,146 @@
+// Escalonador de quadros (user-012): o timer para sem trabalho e a próxima alteração gera um tick
+// imediato; o reinício do timer acontece só na interrupção do pool de alarmes (núcleo 0), nunca no
+// núcleo que chama frame_scheduler_invalidate. Com o núcleo 1 em uma thread, alterações e paradas
+// concorrentes não perdem quadros nem deixam alarmes órfãos.
+
+#include <sched.h>
+#include "test.h"
+#include "host_sdk.h"
+#include "pico/multicore.h"
+#include "frame_scheduler.h"
+
+#define TICK_US 5000
+#define STRESS_ROUNDS 20000
+
+static frame_scheduler_t sched;
+static uint32_t presents;
+
+static bool present(void *ctx)
+{
+    presents++;
+    return true;
+}
+
+static void test_pause_resume(void)
+{
+    host_reset();
+    host_time_set(1000000);
+    presents = 0;
+    CHECK(frame_scheduler_init(&sched, TICK_US));
+    int oled = frame_scheduler_add(&sched, "OLED", 50, present, NULL);
+    CHECK_EQ(sched.devices[oled].period_ticks, 4);
+
+    // Sem alterações: o primeiro tick para o timer, sem sinalizar
+    host_time_advance(TICK_US);
+    CHECK(!sched.running);
+    CHECK_EQ(sched.pauses, 1);
+    CHECK_EQ(sched.ticks, 0);
+    CHECK_EQ(sched.timer.alarm_id, 0);
+    CHECK_EQ(host_alarms_pending(), 0);
+
+    // Alteração: tick imediato, e o timer só é recriado pelo alarme de reinício
+    host_time_advance(123456);
+    frame_scheduler_invalidate(&sched, oled);
+    CHECK(sched.running);
+    CHECK(frame_scheduler_pending(&sched));
+    CHECK_EQ(sched.timer.alarm_id, 0);
+    CHECK_EQ(host_alarms_pending(), 1);
+    CHECK(frame_scheduler_run(&sched));
+    CHECK_EQ(presents, 1);
+    CHECK_EQ(sched.missed, 0); // Os ticks do tempo parado não contam como perdidos
+
+    CHECK_EQ(host_alarms_run(), 1);
+    CHECK(sched.timer.alarm_id > 0);
+    CHECK_EQ(host_alarms_pending(), 1);
+
+    // Quadro em andamento: o timer continua até o término; depois para de novo
+    host_time_advance(TICK_US);
+    CHECK(sched.running);
+    CHECK(frame_scheduler_run(&sched));
+    frame_scheduler_done(&sched, oled);
+    CHECK_EQ(sched.devices[oled].frames_done, 1);
+    host_time_advance(TICK_US);
+    CHECK(!sched.running);
+    CHECK_EQ(sched.pauses, 2);
+    CHECK_EQ(sched.timer.alarm_id, 0);
+    CHECK_EQ(host_alarms_pending(), 0);
+
+    // Duas alterações antes do reinício: um único alarme de reinício e um único timer
+    host_time_advance(4 * TICK_US);
+    frame_scheduler_invalidate(&sched, oled);
+    frame_scheduler_invalidate(&sched, oled);
+    CHECK_EQ(host_alarms_pending(), 1);
+    host_alarms_run();
+    CHECK_EQ(host_alarms_pending(), 1);
+    CHECK(frame_scheduler_run(&sched));
+    CHECK_EQ(presents, 2);
+}
+
+// Núcleo 1: cada rodada altera o dispositivo e aguarda o quadro, enquanto o núcleo 0 (o teste)
+// avança o tempo e roda o timer; uma parada que perdesse a alteração prenderia esta espera
+static volatile bool stress_done;
+static int stress_device;
+
+static void stress_core1(void)
+{
+    for (uint32_t round = 0; round < STRESS_ROUNDS; ++round)
+    {
+        frame_scheduler_invalidate(&sched, stress_device);
+        while (sched.devices[stress_device].invalid)
+        {
+            frame_scheduler_run(&sched);
+            sched_yield();
+        }
+        if (round & 1)
+            sched_yield(); // Às vezes o término chega depois de um tick
+        frame_scheduler_done(&sched, stress_device);
+        frame_scheduler_run(&sched);
+
+        // Parte das rodadas espera o timer parar, para que a alteração seguinte o reinicie
+        while (round % 3 == 0 && sched.running)
+        {
+            frame_scheduler_run(&sched);
+            sched_yield();
+        }
+    }
+    stress_done = true;
+    while (true)
+        sched_yield();
+}
+
+static void test_concurrent(void)
+{
+    host_reset();
+    host_time_set(1000000);
+    presents = 0;
+    CHECK(frame_scheduler_init(&sched, TICK_US));
+    stress_device = frame_scheduler_add(&sched, "Matriz", 1000000 / TICK_US, present, NULL);
+
+    multicore_launch_core1(stress_core1);
+    uint64_t limit = time_us_64() + (uint64_t)STRESS_ROUNDS * TICK_US * 20;
+    while (!stress_done && time_us_64() < limit)
+    {
+        host_time_advance(rand() % (2 * TICK_US));
+        sched_yield();
+    }
+    CHECK(stress_done);
+    CHECK_EQ(presents, STRESS_ROUNDS);
+    CHECK_EQ(sched.devices[stress_device].frames_done, STRESS_ROUNDS);
+
+    // Sem trabalho, o timer para e nenhum alarme fica para trás
+    host_time_advance(3 * TICK_US);
+    CHECK(!sched.running);
+    CHECK_EQ(sched.timer.alarm_id, 0);
+    CHECK_EQ(host_alarms_pending(), 0);
+    CHECK(sched.ticks == sched.served);
+    printf("%lu rodadas: %lu ticks, %lu paradas, %lu perdidos\n", (unsigned long)STRESS_ROUNDS,
+           (unsigned long)sched.ticks, (unsigned long)sched.pauses, (unsigned long)sched.missed);
+}
+
+int main(void)
+{
+    srand(12);
+    test_pause_resume();
+    test_concurrent();
+    return TEST_RESULT("test_frame_scheduler");
+}
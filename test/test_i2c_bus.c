@@ -0,0 +1,289 @@
+// Barramento I2C compartilhado (user-019): ordem entre as classes de prioridade, fila cheia, recusa
+// do dispositivo com recuo de frequência, barramento travado destravado fora da seção crítica e
+// latência por classe, com o código de i2c_bus.c sobre os substitutos do SDK
+
+#include <pthread.h>
+#include <string.h>
+#include "test.h"
+#include "host_sdk.h"
+#include "i2c_bus.h"
+
+#define SDA 14
+#define SCL 15
+
+static const uint16_t words[4] = {0x00, 0xAE, 0xD5, 0x80 | I2C_IC_DATA_CMD_STOP_BITS};
+
+// Ordem em que as transações terminaram (endereços), anotada por i2c_xfer_t.done
+static uint8_t finished[32];
+static uint finished_count;
+
+static void on_done(i2c_xfer_t *xfer, void *ctx)
+{
+    if (finished_count < sizeof(finished))
+        finished[finished_count++] = xfer->address;
+}
+
+static void xfer_init(i2c_xfer_t *xfer, uint8_t address, i2c_priority_t priority)
+{
+    i2c_xfer_init(xfer, address, priority, words, 4);
+    xfer->done = on_done;
+}
+
+static void bus_init(i2c_bus_t *bus)
+{
+    host_reset();
+    finished_count = 0;
+    CHECK(i2c_bus_init(bus, i2c1, SDA, SCL, I2C_BUS_FAST_PLUS));
+}
+
+// Com a transação de lote ativa, a próxima vem sempre da classe mais urgente com pendências
+static void test_order(void)
+{
+    i2c_bus_t bus;
+    bus_init(&bus);
+    host_dma_hold(true);
+
+    i2c_xfer_t first, bulk, normal, urgent;
+    xfer_init(&first, 0x30, I2C_PRIO_BULK);
+    xfer_init(&bulk, 0x31, I2C_PRIO_BULK);
+    xfer_init(&normal, 0x20, I2C_PRIO_NORMAL);
+    xfer_init(&urgent, 0x10, I2C_PRIO_URGENT);
+
+    CHECK(i2c_bus_submit(&bus, &first));
+    CHECK(!i2c_bus_poll(&bus));
+    CHECK_EQ(first.state, I2C_XFER_ACTIVE);
+    CHECK(i2c_bus_submit(&bus, &bulk));
+    CHECK(i2c_bus_submit(&bus, &normal));
+    CHECK(i2c_bus_submit(&bus, &urgent));
+    CHECK(!i2c_bus_poll(&bus)); // Sem término, nada muda
+    CHECK_EQ(first.state, I2C_XFER_ACTIVE);
+    CHECK_EQ(urgent.state, I2C_XFER_QUEUED);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        CHECK(host_dma_complete(bus.dma_channel));
+        i2c_bus_poll(&bus);
+    }
+    CHECK(i2c_bus_poll(&bus));
+
+    static const uint8_t expected[] = {0x30, 0x10, 0x20, 0x31};
+    CHECK_EQ(finished_count, 4);
+    CHECK(memcmp(finished, expected, sizeof(expected)) == 0);
+    CHECK_EQ(host_i2c.logged, 4);
+    for (uint i = 0; i < host_i2c.logged; ++i)
+    {
+        CHECK_EQ(host_i2c.xfers[i].address, expected[i]);
+        CHECK_EQ(host_i2c.xfers[i].length, 4);
+    }
+    CHECK_EQ(bus.completed[I2C_PRIO_URGENT], 1);
+    CHECK_EQ(bus.completed[I2C_PRIO_NORMAL], 1);
+    CHECK_EQ(bus.completed[I2C_PRIO_BULK], 2);
+    CHECK_EQ(bus.bytes, 4 * 5);
+}
+
+// A fila de cada classe guarda I2C_BUS_QUEUE_SIZE transações; a seguinte é recusada e contada
+static void test_queue_full(void)
+{
+    i2c_bus_t bus;
+    bus_init(&bus);
+    host_dma_hold(true);
+
+    static i2c_xfer_t xfers[I2C_BUS_QUEUE_SIZE + 2];
+    for (uint i = 0; i < I2C_BUS_QUEUE_SIZE + 2; ++i)
+        xfer_init(&xfers[i], (uint8_t)(0x40 + i), I2C_PRIO_NORMAL);
+
+    CHECK(i2c_bus_submit(&bus, &xfers[0]));
+    i2c_bus_poll(&bus); // A primeira sai da fila e ocupa o barramento
+    for (uint i = 1; i <= I2C_BUS_QUEUE_SIZE; ++i)
+        CHECK(i2c_bus_submit(&bus, &xfers[i]));
+    CHECK(!i2c_bus_submit(&bus, &xfers[I2C_BUS_QUEUE_SIZE + 1]));
+    CHECK_EQ(bus.rejected, 1);
+    CHECK_EQ(xfers[I2C_BUS_QUEUE_SIZE + 1].state, I2C_XFER_IDLE);
+
+    // As outras classes têm filas próprias
+    i2c_xfer_t urgent;
+    xfer_init(&urgent, 0x10, I2C_PRIO_URGENT);
+    CHECK(i2c_bus_submit(&bus, &urgent));
+
+    // A urgente passa à frente; só quando uma normal sai da fila ela volta a aceitar
+    CHECK(host_dma_complete(bus.dma_channel));
+    i2c_bus_poll(&bus);
+    CHECK_EQ(urgent.state, I2C_XFER_ACTIVE);
+    CHECK(!i2c_bus_submit(&bus, &xfers[I2C_BUS_QUEUE_SIZE + 1]));
+    CHECK(host_dma_complete(bus.dma_channel));
+    i2c_bus_poll(&bus);
+    CHECK_EQ(xfers[1].state, I2C_XFER_ACTIVE);
+    CHECK(i2c_bus_submit(&bus, &xfers[I2C_BUS_QUEUE_SIZE + 1]));
+
+    host_dma_hold(false);
+    while (!i2c_bus_poll(&bus))
+        host_dma_complete(bus.dma_channel);
+    CHECK_EQ(bus.completed[I2C_PRIO_NORMAL], I2C_BUS_QUEUE_SIZE + 2);
+    CHECK_EQ(bus.rejected, 2);
+    CHECK_EQ(finished_count, I2C_BUS_QUEUE_SIZE + 3);
+}
+
+// Recusa do dispositivo (TX_ABRT): falha sem destravar o barramento; três seguidas recuam para Fast-mode
+static void test_nack(void)
+{
+    i2c_bus_t bus;
+    bus_init(&bus);
+
+    i2c_xfer_t xfer;
+    xfer_init(&xfer, 0x3C, I2C_PRIO_NORMAL);
+    host_i2c_fail_next(1);
+    CHECK(!i2c_bus_transfer(&bus, &xfer));
+    CHECK_EQ(xfer.state, I2C_XFER_FAILED);
+    CHECK_EQ(bus.failed, 1);
+    CHECK_EQ(bus.recoveries, 0);
+    CHECK_EQ(finished_count, 1); // A falha também é notificada
+
+    CHECK(i2c_bus_transfer(&bus, &xfer)); // Um sucesso zera a contagem de falhas seguidas
+    host_i2c_fail_next(2);
+    CHECK(!i2c_bus_transfer(&bus, &xfer));
+    CHECK(!i2c_bus_transfer(&bus, &xfer));
+    CHECK_EQ(bus.fallbacks, 0);
+    CHECK_EQ(bus.baudrate, I2C_BUS_FAST_PLUS);
+
+    host_i2c_fail_next(3);
+    for (int i = 0; i < 3; ++i)
+        CHECK(!i2c_bus_transfer(&bus, &xfer));
+    CHECK_EQ(bus.fallbacks, 1);
+    CHECK_EQ(bus.baudrate, I2C_BUS_FAST);
+    CHECK_EQ(bus.failed, 6);
+    CHECK(i2c_bus_transfer(&bus, &xfer));
+    CHECK_EQ(bus.completed[I2C_PRIO_NORMAL], 2);
+}
+
+// Alarme que dispara no meio do destravamento, como uma interrupção: confere que a seção crítica
+// está livre, solta SDA (o dispositivo terminou o byte) e enfileira uma leitura urgente
+static i2c_bus_t *stalled_bus;
+static i2c_xfer_t irq_xfer;
+static bool irq_fired, irq_lock_free;
+
+static int64_t recovery_irq(alarm_id_t id, void *user_data)
+{
+    irq_fired = true;
+    irq_lock_free = pthread_mutex_trylock(&stalled_bus->lock.mutex) == 0;
+    if (irq_lock_free)
+        pthread_mutex_unlock(&stalled_bus->lock.mutex);
+    CHECK_EQ(stalled_bus->active->state, I2C_XFER_ACTIVE); // Ainda ocupando o barramento
+    host_gpio_set(SDA, 1);
+    if (irq_lock_free)
+        CHECK(i2c_bus_submit(stalled_bus, &irq_xfer));
+    return 0;
+}
+
+// Barramento travado: sem progresso até o prazo, a transação falha, o barramento é destravado fora
+// da seção crítica e a próxima começa
+static void test_timeout(void)
+{
+    i2c_bus_t bus;
+    bus_init(&bus);
+    host_time_set(1000);
+    host_dma_hold(true);
+
+    i2c_xfer_t stuck, next;
+    xfer_init(&stuck, 0x3C, I2C_PRIO_BULK);
+    xfer_init(&next, 0x31, I2C_PRIO_BULK);
+    xfer_init(&irq_xfer, 0x10, I2C_PRIO_URGENT);
+    CHECK(i2c_bus_submit(&bus, &stuck));
+    CHECK(i2c_bus_submit(&bus, &next));
+    i2c_bus_poll(&bus);
+    CHECK_EQ(stuck.state, I2C_XFER_ACTIVE);
+
+    // Dentro do prazo, a transação só aguarda
+    uint32_t deadline = bus.deadline_us;
+    host_time_advance(deadline - time_us_32() - 1);
+    CHECK(!i2c_bus_poll(&bus));
+    CHECK_EQ(stuck.state, I2C_XFER_ACTIVE);
+    CHECK_EQ(bus.recoveries, 0);
+
+    // O dispositivo segura SDA até o terceiro pulso de SCL (10 µs cada)
+    host_time_advance(1);
+    host_gpio_set(SDA, 0);
+    stalled_bus = &bus;
+    irq_fired = irq_lock_free = false;
+    add_alarm_in_us(25, recovery_irq, NULL, false);
+    uint32_t start = time_us_32();
+    CHECK(!i2c_bus_poll(&bus));
+
+    CHECK(irq_fired);
+    CHECK(irq_lock_free);
+    CHECK_EQ(time_us_32() - start, 3 * 10 + 15); // Três pulsos e o STOP
+    CHECK_EQ(stuck.state, I2C_XFER_FAILED);
+    CHECK_EQ(bus.failed, 1);
+    CHECK_EQ(bus.recoveries, 1);
+    CHECK_EQ(finished_count, 1);
+    CHECK_EQ(finished[0], 0x3C);
+
+    // A leitura enfileirada durante o destravamento passa à frente da que já aguardava
+    CHECK_EQ(irq_xfer.state, I2C_XFER_ACTIVE);
+    CHECK_EQ(next.state, I2C_XFER_QUEUED);
+    CHECK(host_dma_complete(bus.dma_channel));
+    i2c_bus_poll(&bus);
+    CHECK_EQ(irq_xfer.state, I2C_XFER_DONE);
+    CHECK_EQ(next.state, I2C_XFER_ACTIVE);
+    CHECK(host_dma_complete(bus.dma_channel));
+    CHECK(i2c_bus_poll(&bus));
+    CHECK_EQ(next.state, I2C_XFER_DONE);
+    CHECK_EQ(host_i2c.logged, 2); // A transação travada não chegou ao barramento
+}
+
+// Latência entre a submissão e o término, por classe: maior valor e faixa do histograma
+static void test_latency(void)
+{
+    i2c_bus_t bus;
+    bus_init(&bus);
+    host_time_set(1000);
+    host_dma_hold(true);
+
+    i2c_xfer_t bulk, normal, urgent;
+    xfer_init(&bulk, 0x3C, I2C_PRIO_BULK);
+    xfer_init(&normal, 0x20, I2C_PRIO_NORMAL);
+    xfer_init(&urgent, 0x10, I2C_PRIO_URGENT);
+
+    CHECK(i2c_bus_submit(&bus, &bulk));
+    i2c_bus_poll(&bus);
+    host_time_advance(100);
+    CHECK(i2c_bus_submit(&bus, &normal));
+    CHECK(i2c_bus_submit(&bus, &urgent));
+
+    host_time_advance(50); // O lote termina aos 150 µs; a urgente começa
+    host_dma_complete(bus.dma_channel);
+    i2c_bus_poll(&bus);
+    host_time_advance(20); // A urgente termina 70 µs após a submissão
+    host_dma_complete(bus.dma_channel);
+    i2c_bus_poll(&bus);
+    host_time_advance(30); // A normal espera pelas duas: 100 µs
+    host_dma_complete(bus.dma_channel);
+    CHECK(i2c_bus_poll(&bus));
+
+    CHECK_EQ(bus.latency_max_us[I2C_PRIO_BULK], 150);
+    CHECK_EQ(bus.latency_max_us[I2C_PRIO_URGENT], 70);
+    CHECK_EQ(bus.latency_max_us[I2C_PRIO_NORMAL], 100);
+    CHECK_EQ(bus.latency_hist[I2C_PRIO_BULK][7], 1);   // [128, 256) µs
+    CHECK_EQ(bus.latency_hist[I2C_PRIO_URGENT][6], 1); // [64, 128) µs
+    CHECK_EQ(bus.latency_hist[I2C_PRIO_NORMAL][6], 1);
+
+    // Uma segunda urgente, sem espera, não altera o maior valor e cai numa faixa menor
+    host_time_advance(1000);
+    CHECK(i2c_bus_submit(&bus, &urgent));
+    i2c_bus_poll(&bus);
+    host_time_advance(10);
+    host_dma_complete(bus.dma_channel);
+    CHECK(i2c_bus_poll(&bus));
+    CHECK_EQ(bus.latency_max_us[I2C_PRIO_URGENT], 70);
+    CHECK_EQ(bus.latency_hist[I2C_PRIO_URGENT][3], 1); // [8, 16) µs
+    CHECK_EQ(bus.completed[I2C_PRIO_URGENT], 2);
+}
+
+int main(void)
+{
+    test_order();
+    test_queue_full();
+    test_nack();
+    test_timeout();
+    test_latency();
+    return TEST_RESULT("test_i2c_bus");
+}
@@ -0,0 +1,102 @@
+// Política de economia (user-024): estágios com o tempo de 64 bits, sem voltar ao estágio ativo quando
+// o tempo de 32 bits dá a volta (~71,6 minutos), e origem dos despertares lida no NVIC
+
+#include "test.h"
+#include "host_sdk.h"
+#include "power.h"
+#include "hardware/irq.h"
+#include "hardware/regs/m0plus.h"
+
+#define MINUTE_US 60000000ull
+
+// Três horas sem entradas, acordando a cada minuto: desligado desde os 2 minutos até o fim
+static void test_wrap(void)
+{
+    power_t pw;
+    host_reset();
+    host_time_set(1000);
+    power_init(&pw, POWER_DIM_MS, POWER_OFF_MS);
+    CHECK(!power_update(&pw));
+    CHECK_EQ(pw.state, POWER_ACTIVE);
+
+    uint32_t wrong = 0;
+    for (uint minute = 1; minute <= 180; ++minute)
+    {
+        host_time_advance(MINUTE_US); // O alarme do próximo estágio dispara no seu instante
+        power_update(&pw);
+        if (minute >= 2 && pw.state != POWER_OFF)
+            wrong++;
+    }
+    CHECK_EQ(wrong, 0);
+    CHECK_EQ(pw.transitions, 2); // Ativo -> reduzido -> desligado
+    CHECK(time_us_64() > (1ull << 32));
+
+    // Uma entrada volta ao estágio ativo e agenda o reduzido a partir dela
+    CHECK_EQ(power_input(&pw), POWER_OFF);
+    CHECK_EQ(pw.state, POWER_ACTIVE);
+    CHECK(!power_update(&pw));
+    host_time_advance(POWER_DIM_MS * 1000ull);
+    CHECK(power_update(&pw));
+    CHECK_EQ(pw.state, POWER_DIM);
+
+    power_report_t report;
+    power_report(&pw, 0, &report);
+    CHECK_EQ(report.window_ms, 180 * 60000 + POWER_DIM_MS);
+}
+
+static void test_wake_sources(void)
+{
+    power_t pw;
+    host_reset();
+    host_time_set(1000);
+    power_init(&pw, POWER_DIM_MS, POWER_OFF_MS);
+    volatile uint32_t *ispr = (volatile uint32_t *)(PPB_BASE + M0PLUS_NVIC_ISPR_OFFSET);
+
+    // Cada interrupção chega com as interrupções mascaradas: acorda o __wfi e continua pendente no NVIC.
+    // Um minuto em repouso com o stdio USB: a tarefa do SDK em um alarme a cada 1 ms e uma interrupção
+    // do controlador a cada 10 ms, mais um botão
+    for (uint ms = 1; ms <= 60000; ++ms)
+    {
+        uint32_t status = save_and_disable_interrupts();
+        host_irq_raise(TIMER_IRQ_3);
+        if (ms % 10 == 0)
+            host_irq_raise(USBCTRL_IRQ);
+        if (ms == 30000)
+            host_irq_raise(IO_IRQ_BANK0);
+        power_sleep(&pw, NULL);
+        restore_interrupts(status);
+        CHECK_EQ(*ispr, 0); // Atendidas ao restaurar as interrupções
+        host_time_advance(1000);
+    }
+
+    // Sem nenhuma interrupção pendente (evento, por exemplo)
+    power_sleep(&pw, NULL);
+
+    CHECK_EQ(pw.wakeups, 60001);
+    CHECK_EQ(pw.wake_sources[POWER_WAKE_TIMER], 60000);
+    CHECK_EQ(pw.wake_sources[POWER_WAKE_USB], 6000);
+    CHECK_EQ(pw.wake_sources[POWER_WAKE_GPIO], 1);
+    CHECK_EQ(pw.wake_sources[POWER_WAKE_DMA], 0);
+    CHECK_EQ(pw.wake_sources[POWER_WAKE_OTHER], 1);
+
+    power_report_t report;
+    power_report(&pw, 0, &report);
+    CHECK_EQ(report.window_ms, 60000);
+    CHECK_EQ(report.wakeups_per_min, 60001);
+    CHECK_EQ(report.sources_per_min[POWER_WAKE_TIMER], 60000);
+    CHECK_EQ(report.sources_per_min[POWER_WAKE_USB], 6000);
+
+    // A janela seguinte começa do zero
+    host_time_advance(MINUTE_US);
+    power_report(&pw, 0, &report);
+    CHECK_EQ(report.wakeups_per_min, 0);
+    CHECK_EQ(report.sources_per_min[POWER_WAKE_USB], 0);
+    CHECK(strcmp(power_wake_name(POWER_WAKE_USB), "usb") == 0);
+}
+
+int main(void)
+{
+    test_wrap();
+    test_wake_sources();
+    return TEST_RESULT("test_power");
+}
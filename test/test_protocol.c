@@ -0,0 +1,260 @@
+// Receptor do protocolo binário (user-022): quadros íntegros, corrompidos, truncados, grandes demais
+// e de tipo desconhecido passam por proto_feed, com texto comum entre eles, e cada um termina com a
+// confirmação esperada; depois de qualquer erro o receptor volta a encontrar o próximo quadro
+
+#include <string.h>
+#include "test.h"
+#include "protocol.h"
+
+#define PAYLOAD_MAX 64
+
+// Destino de teste: aceita os tipos conhecidos com o comprimento certo e guarda o que recebe
+typedef struct
+{
+    uint8_t data[PAYLOAD_MAX];
+    uint16_t length;
+    uint32_t begins, ends;
+    uint8_t seq;
+    proto_status_t status; // Resultado da última confirmação
+    proto_status_t first;  // Resultado da primeira confirmação
+    char text[64];         // Bytes devolvidos como texto comum
+    uint8_t text_len;
+} sink_t;
+
+static sink_t sink;
+static proto_parser_t parser;
+
+static bool sink_begin(uint8_t type, uint16_t length, void *ctx)
+{
+    sink.begins++;
+    sink.length = length;
+    if (type == PROTO_CONTROL)
+        return length == 2;
+    return type == PROTO_LED_FRAME && length <= PAYLOAD_MAX;
+}
+
+static void sink_byte(uint8_t type, uint16_t pos, uint8_t value, void *ctx)
+{
+    CHECK(pos < sink.length);
+    if (pos < PAYLOAD_MAX)
+        sink.data[pos] = value;
+}
+
+static proto_status_t sink_end(uint8_t type, uint8_t seq, proto_status_t status, void *ctx)
+{
+    if (sink.ends++ == 0)
+        sink.first = status;
+    sink.seq = seq;
+    sink.status = status;
+    return status;
+}
+
+static const proto_handler_t handler = {sink_begin, sink_byte, sink_end};
+
+// Monta um quadro completo; retorna o tamanho
+static size_t frame(uint8_t *out, uint8_t type, uint8_t seq, const uint8_t *data, uint16_t length)
+{
+    size_t n = 0;
+    out[n++] = PROTO_SYNC0;
+    out[n++] = PROTO_SYNC1;
+    out[n++] = type;
+    out[n++] = seq;
+    out[n++] = (uint8_t)length;
+    out[n++] = (uint8_t)(length >> 8);
+    if (length)
+        memcpy(out + n, data, length);
+    n += length;
+
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 2; i < n; ++i)
+        crc = proto_crc16(crc, out[i]);
+    out[n++] = (uint8_t)crc;
+    out[n++] = (uint8_t)(crc >> 8);
+    return n;
+}
+
+// Alimenta o receptor como o laço de entrada do firmware: o que não pertence a um quadro é texto
+static void feed(const uint8_t *bytes, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        if (!proto_feed(&parser, bytes[i]) && sink.text_len < sizeof(sink.text) - 1)
+            sink.text[sink.text_len++] = (char)bytes[i];
+}
+
+static void reset(void)
+{
+    memset(&sink, 0, sizeof(sink));
+    proto_init(&parser, &handler, NULL);
+}
+
+// Verifica a última confirmação e que o receptor voltou a procurar o sincronismo
+static void check_end(uint32_t ends, uint8_t seq, proto_status_t status)
+{
+    CHECK_EQ(sink.ends, ends);
+    CHECK_EQ(sink.seq, seq);
+    CHECK_EQ(sink.status, status);
+    CHECK(!proto_busy(&parser));
+}
+
+// CRC-16/CCITT-FALSE de "123456789"
+static void test_crc(void)
+{
+    uint16_t crc = 0xFFFF;
+    for (const char *c = "123456789"; *c; ++c)
+        crc = proto_crc16(crc, (uint8_t)*c);
+    CHECK_EQ(crc, 0x29B1);
+}
+
+static void test_good(void)
+{
+    reset();
+    uint8_t data[PAYLOAD_MAX], buf[PAYLOAD_MAX + 8];
+    for (int i = 0; i < PAYLOAD_MAX; ++i)
+        data[i] = (uint8_t)(i * 37 + 1);
+
+    size_t n = frame(buf, PROTO_LED_FRAME, 7, data, PAYLOAD_MAX);
+    feed(buf, n);
+    check_end(1, 7, PROTO_OK);
+    CHECK(memcmp(sink.data, data, PAYLOAD_MAX) == 0);
+
+    uint8_t ctrl[2] = {PROTO_CTRL_PING, 0};
+    n = frame(buf, PROTO_CONTROL, 8, ctrl, 2);
+    feed(buf, n);
+    check_end(2, 8, PROTO_OK);
+
+    // Quadro sem dados vai direto ao CRC
+    n = frame(buf, PROTO_LED_FRAME, 9, NULL, 0);
+    CHECK_EQ(n, 8);
+    feed(buf, n);
+    check_end(3, 9, PROTO_OK);
+    CHECK_EQ(parser.frames[PROTO_OK], 3);
+    CHECK_EQ(parser.bytes, (6 + PAYLOAD_MAX + 2) + (6 + 2 + 2) + 8);
+    CHECK_EQ(sink.text_len, 0);
+}
+
+// Qualquer bit alterado depois do sincronismo faz o quadro terminar com erro, e o receptor se recupera
+static void test_corrupted(void)
+{
+    uint8_t data[16], buf[32];
+    for (int i = 0; i < 16; ++i)
+        data[i] = (uint8_t)(0xC0 + i);
+    size_t n = frame(buf, PROTO_LED_FRAME, 3, data, 16);
+
+    for (size_t at = 2; at < n; ++at)
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+            reset();
+            uint8_t bad[32];
+            memcpy(bad, buf, n);
+            bad[at] ^= 1u << bit;
+            feed(bad, n);
+
+            if (at == 4 || at == 5)
+            {
+                // Outro comprimento desalinha o resto: o quadro termina antes (CRC), aguarda bytes que
+                // não virão (tempo esgotado) ou passa do limite (recusado)
+                if (proto_busy(&parser))
+                    proto_timeout(&parser);
+                CHECK(!proto_busy(&parser));
+                CHECK(sink.ends >= 1);
+                CHECK(sink.first != PROTO_OK);
+                continue;
+            }
+            check_end(1, bad[3], PROTO_ERR_CRC); // No tipo, o CRC prevalece sobre a recusa do destino
+        }
+
+    // Tipo desconhecido com CRC correto: recusado, e os dados não chegam ao destino
+    reset();
+    n = frame(buf, 0x7E, 4, data, 16);
+    feed(buf, n);
+    check_end(1, 4, PROTO_ERR_REJECTED);
+    CHECK_EQ(sink.data[0], 0);
+
+    // Comprimento inválido para o tipo
+    reset();
+    n = frame(buf, PROTO_CONTROL, 5, data, 3);
+    feed(buf, n);
+    check_end(1, 5, PROTO_ERR_REJECTED);
+}
+
+// Quadro interrompido em cada posição: o tempo esgotado o encerra e o próximo é recebido inteiro
+static void test_truncated(void)
+{
+    uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, 8}, buf[32], next[32];
+    size_t n = frame(buf, PROTO_LED_FRAME, 9, data, 8);
+    size_t m = frame(next, PROTO_LED_FRAME, 10, data, 8);
+
+    for (size_t cut = 1; cut < n; ++cut)
+    {
+        reset();
+        feed(buf, cut);
+        CHECK(proto_busy(&parser));
+        proto_timeout(&parser);
+        CHECK(!proto_busy(&parser));
+        CHECK_EQ(parser.frames[PROTO_ERR_TIMEOUT], 1);
+        // Com a sequência já recebida, o remetente é avisado; antes disso, não há a quem responder
+        CHECK_EQ(sink.ends, cut > 3 ? 1 : 0);
+        if (cut > 3)
+            CHECK_EQ(sink.status, PROTO_ERR_TIMEOUT);
+
+        feed(next, m);
+        CHECK_EQ(sink.seq, 10);
+        CHECK_EQ(sink.status, PROTO_OK);
+        CHECK_EQ(parser.frames[PROTO_OK], 1);
+    }
+}
+
+// Comprimento acima de PROTO_PAYLOAD_MAX: tratado como ruído, sem consultar o destino
+static void test_oversize(void)
+{
+    reset();
+    uint8_t header[] = {PROTO_SYNC0, PROTO_SYNC1, PROTO_LED_FRAME, 11,
+                        (PROTO_PAYLOAD_MAX + 1) & 0xFF, (PROTO_PAYLOAD_MAX + 1) >> 8};
+    feed(header, sizeof(header));
+    check_end(1, 11, PROTO_ERR_REJECTED);
+    CHECK_EQ(sink.begins, 0);
+
+    // Os bytes que seriam os dados voltam a ser texto, e o próximo quadro é reconhecido
+    uint8_t buf[32], data[2] = {PROTO_CTRL_PING, 0};
+    feed((const uint8_t *)"ok", 2);
+    size_t n = frame(buf, PROTO_CONTROL, 12, data, 2);
+    feed(buf, n);
+    check_end(2, 12, PROTO_OK);
+    CHECK_EQ(sink.text_len, 2);
+    CHECK(memcmp(sink.text, "ok", 2) == 0);
+}
+
+// Texto e sincronismos falsos entre quadros: o texto é devolvido intacto e os quadros são recebidos
+static void test_resync(void)
+{
+    reset();
+    uint8_t stream[128], data[4] = {0xA5, 0x5A, 0xA5, 0x5A}; // Sincronismo dentro dos dados não atrapalha
+    size_t n = 0;
+    memcpy(stream + n, "led 1\n", 6);
+    n += 6;
+    stream[n++] = PROTO_SYNC0; // 0xA5 seguido de texto: não era um quadro
+    stream[n++] = 'x';
+    stream[n++] = PROTO_SYNC0; // Sincronismo repetido antes do quadro
+    n += frame(stream + n, PROTO_LED_FRAME, 13, data, 4);
+    memcpy(stream + n, "?\n", 2);
+    n += 2;
+    n += frame(stream + n, PROTO_LED_FRAME, 14, data, 4);
+    feed(stream, n);
+
+    check_end(2, 14, PROTO_OK);
+    CHECK_EQ(parser.frames[PROTO_OK], 2);
+    CHECK(memcmp(sink.data, data, 4) == 0);
+    CHECK_EQ(sink.text_len, 9);
+    CHECK(memcmp(sink.text, "led 1\nx?\n", 9) == 0);
+}
+
+int main(void)
+{
+    test_crc();
+    test_good();
+    test_corrupted();
+    test_truncated();
+    test_oversize();
+    test_resync();
+    return TEST_RESULT("test_protocol");
+}
@@ -0,0 +1,131 @@
+// Fila de comandos entre os núcleos (user-010), com o núcleo 1 em uma thread do computador: a ordem
+// e o conteúdo dos comandos chegam intactos com a fila cheia, e a vazão em comandos por segundo.
+// A vazão impressa é a do computador (duas threads, possivelmente na mesma CPU), não a do RP2040.
+// Quadros recebidos pela USB (troca de buffer e janela) invalidam o cache dos widgets (user-022).
+
+#include "test.h"
+#include "host_sdk.h"
+#include "ssd1306.h"
+#include "ws2812.h"
+#include "render.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+#define ADDRESS 0x3C
+#define LED_COUNT 25
+#define COMMANDS 200000
+
+static uint8_t ssd_ram[SSD1306_BUFFER_SIZE(WIDTH, HEIGHT)];
+static uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(WIDTH, HEIGHT)];
+static uint16_t ssd_dma[SSD1306_DMA_BUFFER_WORDS(WIDTH, HEIGHT)];
+static uint8_t ref_ram[SSD1306_BUFFER_SIZE(WIDTH, HEIGHT)];
+static uint8_t ref_tx[SSD1306_TX_BUFFER_SIZE(WIDTH, HEIGHT)];
+static uint16_t ref_dma[SSD1306_DMA_BUFFER_WORDS(WIDTH, HEIGHT)];
+static uint8_t remote[SSD1306_BUFFER_SIZE(WIDTH, HEIGHT)];
+
+static ssd1306_t ssd, ref;
+static ws2812_t strip;
+static ui_widget_t number_field;
+
+// Aguarda o núcleo 1 executar tudo o que foi enviado
+static void drain(void)
+{
+    while (!render_drained())
+        sched_yield();
+}
+
+// Imprime a vazão de count comandos enviados em elapsed_us
+static void report(const char *name, uint32_t count, uint64_t elapsed_us, uint32_t stalls)
+{
+    printf("%-26s %7lu comandos  %9.0f comandos/s  fila cheia %lu vezes\n", name, (unsigned long)count,
+           count * 1e6 / (elapsed_us ? elapsed_us : 1), (unsigned long)stalls);
+}
+
+// Caracteres sobrepostos em poucas posições: o resultado só coincide com a referência se todos os
+// comandos forem executados na ordem de envio
+static void test_order(void)
+{
+    uint32_t sent = render_stats.sent, stalls = render_stats.stalls;
+    uint64_t start = time_us_64();
+    for (uint32_t i = 0; i < COMMANDS; ++i)
+    {
+        char c = (char)('!' + (i * 7919u) % 90);
+        uint8_t x = (uint8_t)((i % 5) * 24 + (i % 3));
+        uint8_t y = (uint8_t)((i % 7) * 8 + (i % 2) * 3);
+        render_draw_char(c, x, y);
+        ssd1306_draw_char(&ref, c, x, y);
+    }
+    drain();
+    uint64_t elapsed = time_us_64() - start;
+
+    CHECK_EQ(render_stats.sent - sent, COMMANDS);
+    CHECK_EQ(render_stats.executed, render_stats.sent);
+    CHECK(memcmp(ssd.ram_buffer + 1, ref.ram_buffer + 1, WIDTH * HEIGHT / 8) == 0);
+    report("caracteres (com desenho)", COMMANDS, elapsed, render_stats.stalls - stalls);
+}
+
+// Comandos que quase não trabalham no núcleo 1: mede o custo da própria fila
+static void test_throughput(void)
+{
+    ui_number_init(&number_field, 64, 23, 1);
+    render_ui_number(&number_field, 0);
+    drain();
+
+    uint32_t updates = render_stats.ui_updates, stalls = render_stats.stalls;
+    uint64_t start = time_us_64();
+    for (uint32_t i = 0; i < COMMANDS; ++i)
+        render_ui_number(&number_field, 0); // Mesmo valor: nenhuma célula é redesenhada
+    render_ui_number(&number_field, 7);
+    drain();
+    uint64_t elapsed = time_us_64() - start;
+
+    CHECK_EQ(render_stats.ui_updates - updates, COMMANDS + 1);
+    CHECK_EQ(number_field.value, 7);
+    CHECK_EQ(render_stats.executed, render_stats.sent);
+    report("campo sem alteracao (fila)", COMMANDS + 1, elapsed, render_stats.stalls - stalls);
+}
+
+// Quadro e janela vindos da USB substituem o display sob os widgets: a atualização seguinte, mesmo com
+// o valor que o cache já tinha, redesenha o widget inteiro sobre o conteúdo recebido
+static void test_swap(void)
+{
+    render_ui_number(&number_field, 7);
+    drain();
+    uint32_t drawn = number_field.cells_drawn;
+
+    memset(remote, 0xFF, sizeof(remote));
+    render_oled_swap(remote);
+    render_ui_number(&number_field, 7);
+    drain();
+    CHECK_EQ(number_field.cells_drawn, drawn + 1);
+    ssd1306_fill(&ref, true);
+    ssd1306_draw_char(&ref, '7', 64, 23);
+    CHECK(memcmp(ssd.ram_buffer + 1, ref.ram_buffer + 1, WIDTH * HEIGHT / 8) == 0);
+
+    // Sem nova troca, o cache volta a valer
+    render_ui_number(&number_field, 7);
+    drain();
+    CHECK_EQ(number_field.cells_drawn, drawn + 1);
+
+    // Uma janela copiada sobre o campo também o invalida
+    memset(ref_ram + 1, 0x00, WIDTH * HEIGHT / 8);
+    render_oled_patch(ref_ram, 0, 0, WIDTH - 1, HEIGHT / 8 - 1);
+    render_ui_number(&number_field, 7);
+    drain();
+    CHECK_EQ(number_field.cells_drawn, drawn + 2);
+    ssd1306_draw_char(&ref, '7', 64, 23);
+    CHECK(memcmp(ssd.ram_buffer + 1, ref.ram_buffer + 1, WIDTH * HEIGHT / 8) == 0);
+}
+
+int main(void)
+{
+    ssd1306_init_with_buffers(&ssd, WIDTH, HEIGHT, false, ADDRESS, i2c1, ssd_ram, ssd_tx, ssd_dma);
+    ssd1306_init_with_buffers(&ref, WIDTH, HEIGHT, false, ADDRESS, i2c1, ref_ram, ref_tx, ref_dma);
+    ws2812_init(&strip, pio0, 0, LED_COUNT);
+    render_start(&ssd, &strip);
+
+    test_order();
+    test_throughput();
+    test_swap();
+    return TEST_RESULT("test_render_queue");
+}
@@ -0,0 +1,169 @@
+// Envio assíncrono por DMA (user-002): estados de ssd1306_flush_start/ssd1306_flush_poll com o DMA
+// retido pelo teste, cópia do quadro no início do envio, recusa do display e totais exatos
+
+#include "test.h"
+#include "ssd1306_model.h"
+
+#define ADDRESS 0x3C
+
+static uint8_t ssd_ram[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(128, 64)];
+static uint16_t ssd_dma[SSD1306_DMA_BUFFER_WORDS(128, 64)];
+static uint8_t snapshot[SSD1306_BUFFER_SIZE(128, 64)];
+
+static ssd1306_t ssd;
+static ssd1306_model_t model;
+static int flushes;
+
+static void flush_done(ssd1306_t *s)
+{
+    flushes++;
+}
+
+static void draw_noise(void)
+{
+    for (int i = 0; i < 2000; ++i)
+        ssd1306_pixel(&ssd, rand() % 128, rand() % 64, rand() & 1);
+}
+
+// Compara o modelo com uma cópia do quadro
+static bool model_matches_snapshot(void)
+{
+    for (uint8_t x = 0; x < 128; ++x)
+        for (uint8_t page = 0; page < 8; ++page)
+            if (model.gddram[x][page] != snapshot[1 + x * 8 + page])
+                return false;
+    return true;
+}
+
+static void setup(void)
+{
+    host_reset();
+    ssd1306_model_init(&model);
+    ssd1306_init_with_buffers(&ssd, 128, 64, false, ADDRESS, i2c1, ssd_ram, ssd_tx, ssd_dma);
+    ssd1306_config(&ssd);
+    CHECK(ssd1306_async_init(&ssd));
+    ssd1306_set_flush_callback(&ssd, flush_done);
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    host_i2c_reset();
+    host_dma_hold(true);
+    flushes = 0;
+}
+
+static void test_states(void)
+{
+    setup();
+    i2c_hw_t *hw = i2c_get_hw(i2c1);
+
+    // Ocioso: poll retorna true sem chamar o callback
+    CHECK(ssd1306_flush_poll(&ssd));
+    CHECK_EQ(flushes, 0);
+
+    draw_noise();
+    memcpy(snapshot, ssd_ram, sizeof(snapshot));
+    ssd1306_reset_stats(&ssd);
+    CHECK(ssd1306_flush_start(&ssd, true));
+    CHECK_EQ(ssd.dma_len, SSD1306_WINDOW_HEADER + 1024);
+    CHECK_EQ(ssd.tx_transactions, 1);
+    CHECK_EQ(ssd.tx_bytes, SSD1306_WINDOW_HEADER + 1024 + 1);
+
+    // Em andamento: um segundo envio é recusado e o quadro pode ser alterado livremente
+    CHECK(!ssd1306_flush_poll(&ssd));
+    CHECK(!ssd1306_flush_start(&ssd, false));
+    draw_noise();
+    CHECK_EQ(host_i2c.transactions, 0);
+
+    // DMA terminou, mas a FIFO ainda não esvaziou ou o controlador ainda está ativo
+    CHECK(host_dma_complete(ssd.dma_channel));
+    hw->status = 0;
+    CHECK(!ssd1306_flush_poll(&ssd));
+    hw->status = I2C_IC_STATUS_TFE_BITS | I2C_IC_STATUS_MST_ACTIVITY_BITS;
+    CHECK(!ssd1306_flush_poll(&ssd));
+    hw->status = I2C_IC_STATUS_TFE_BITS;
+    CHECK(ssd1306_flush_poll(&ssd));
+    CHECK_EQ(flushes, 1);
+
+    // Chegou o quadro do início do envio, em uma transação, com STOP apenas no fim
+    CHECK_EQ(host_i2c.transactions, 1);
+    CHECK_EQ(host_i2c.bytes, SSD1306_WINDOW_HEADER + 1024);
+    CHECK(host_i2c.xfers[0].dma);
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    CHECK(model_matches_snapshot());
+    CHECK(!ssd1306_model_matches(&model, &ssd));
+
+    // O envio seguinte leva as alterações feitas durante o anterior
+    host_i2c_reset();
+    CHECK(ssd1306_flush_start(&ssd, false));
+    CHECK(host_dma_complete(ssd.dma_channel));
+    ssd1306_flush_wait(&ssd);
+    CHECK_EQ(flushes, 2);
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    CHECK(ssd1306_model_matches(&model, &ssd));
+
+    // Sem alterações: termina na hora, sem DMA, mas ainda chama o callback
+    uint32_t transfers = host_dma_transfers(ssd.dma_channel);
+    CHECK(ssd1306_flush_start(&ssd, false));
+    CHECK(ssd1306_flush_poll(&ssd));
+    CHECK_EQ(host_dma_transfers(ssd.dma_channel), transfers);
+    CHECK_EQ(flushes, 3);
+}
+
+// "G ON " e '5': duas janelas no mesmo quadro de DMA, cada uma terminada em STOP, e a linha inicial
+static void test_dirty_totals(void)
+{
+    setup();
+    CHECK(ssd1306_flush_start(&ssd, true));
+    CHECK(host_dma_complete(ssd.dma_channel));
+    ssd1306_flush_wait(&ssd);
+    ssd1306_model_replay(&model, 0, ADDRESS);
+
+    host_i2c_reset();
+    ssd1306_reset_stats(&ssd);
+    ssd1306_draw_string(&ssd, "G ON ", 8, 48);
+    ssd1306_draw_char(&ssd, '5', 64, 23);
+    ssd1306_set_start_line(&ssd, 8);
+    CHECK(ssd1306_flush_start(&ssd, false));
+    CHECK(host_dma_complete(ssd.dma_channel));
+    ssd1306_flush_wait(&ssd);
+
+    CHECK_EQ(host_i2c.transactions, 3);
+    CHECK_EQ(host_i2c.xfers[0].length, SSD1306_WINDOW_HEADER + 16);
+    CHECK_EQ(host_i2c.xfers[1].length, SSD1306_WINDOW_HEADER + 40);
+    CHECK_EQ(host_i2c.xfers[2].length, 2);
+    CHECK_EQ(ssd.tx_transactions, 3);
+    CHECK_EQ(ssd.tx_bytes, 2 * SSD1306_WINDOW_HEADER + 16 + 40 + 2 + 3);
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    CHECK(ssd1306_model_matches(&model, &ssd));
+    CHECK_EQ(model.start_line, 8);
+}
+
+// Display não responde: o DMA é abortado e o quadro inteiro fica pendente para o próximo envio
+static void test_abort(void)
+{
+    setup();
+    draw_noise();
+    host_i2c_fail_next(1);
+    CHECK(ssd1306_flush_start(&ssd, true));
+    CHECK(host_dma_complete(ssd.dma_channel));
+    CHECK(i2c_get_hw(i2c1)->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS);
+    CHECK(ssd1306_flush_poll(&ssd));
+    CHECK_EQ(flushes, 1);
+    CHECK_EQ(host_i2c.transactions, 0);
+
+    host_dma_hold(false);
+    CHECK(ssd1306_flush_start(&ssd, false));
+    ssd1306_flush_wait(&ssd);
+    CHECK_EQ(host_i2c.transactions, 2); // Quadro e linha inicial
+    CHECK_EQ(host_i2c.bytes, SSD1306_WINDOW_HEADER + 1024 + 2);
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    CHECK(ssd1306_model_matches(&model, &ssd));
+}
+
+int main(void)
+{
+    srand(2);
+    test_states();
+    test_dirty_totals();
+    test_abort();
+    return TEST_RESULT("test_ssd1306_async");
+}
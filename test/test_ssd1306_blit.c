@@ -0,0 +1,197 @@
+// Blit de bitmaps (user-025): imagens aleatórias em RLE e sem compressão, nos quatro modos, em
+// posições aleatórias parcialmente fora da tela, comparadas entre si e com a referência pixel a pixel;
+// o mesmo para o logo gerado de images/logo.pbm
+
+#include "test.h"
+#include "host_sdk.h"
+#include "ssd1306_ref.h"
+
+#define IMAGE_MAX_WIDTH 160
+#define IMAGE_MAX_HEIGHT 80
+#define IMAGE_MAX_PAGES ((IMAGE_MAX_HEIGHT + 7) / 8)
+#define IMAGE_MAX_BYTES (IMAGE_MAX_WIDTH * IMAGE_MAX_PAGES)
+
+static uint8_t ssd_ram[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(128, 64)];
+static uint8_t reference[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t before[SSD1306_BUFFER_SIZE(128, 64)];
+
+static bool pixels[IMAGE_MAX_WIDTH][IMAGE_MAX_HEIGHT];
+static uint8_t raw_data[IMAGE_MAX_BYTES];
+static uint8_t rle_data[IMAGE_MAX_BYTES + IMAGE_MAX_BYTES / 64 + 2];
+
+static const char *mode_names[] = {"SET", "CLEAR", "XOR", "COPY"};
+
+// Imagem aleatória: fundo apagado ou aceso com retângulos (sequências longas) e às vezes ruído
+// (sequências literais), para que as sequências do RLE atravessem as bordas do recorte
+static void random_image(uint8_t width, uint8_t height)
+{
+    bool background = rand() % 4 == 0;
+    for (int x = 0; x < width; ++x)
+        for (int y = 0; y < height; ++y)
+            pixels[x][y] = background;
+
+    for (int r = rand() % 6; r > 0; --r)
+    {
+        int x0 = rand() % width, y0 = rand() % height;
+        int x1 = x0 + rand() % (width - x0), y1 = y0 + rand() % (height - y0);
+        bool on = rand() & 1;
+        for (int x = x0; x <= x1; ++x)
+            for (int y = y0; y <= y1; ++y)
+                pixels[x][y] = on;
+    }
+    if (rand() % 3 == 0)
+    {
+        int x0 = rand() % width, x1 = x0 + rand() % (width - x0);
+        for (int x = x0; x <= x1; ++x)
+            for (int y = 0; y < height; ++y)
+                pixels[x][y] = rand() & 1;
+    }
+}
+
+// Bytes sem compressão no layout de bitmap.h: página a página, uma coluna de 8 linhas por byte
+static size_t pack(uint8_t width, uint8_t height)
+{
+    uint8_t pages = (height + 7) / 8;
+    size_t n = 0;
+    for (int page = 0; page < pages; ++page)
+        for (int x = 0; x < width; ++x)
+        {
+            uint8_t byte = 0;
+            for (int bit = 0; bit < 8 && page * 8 + bit < height; ++bit)
+                byte |= pixels[x][page * 8 + bit] << bit;
+            raw_data[n++] = byte;
+        }
+    return n;
+}
+
+// Mesmo RLE de tools/img2bitmap.py (repetições de 2 a 129 bytes, literais de 1 a 128), mas com as
+// repetições às vezes cortadas antes do fim, para variar onde as sequências começam e terminam
+static size_t rle_encode(size_t size)
+{
+    size_t out = 0, literal = 0, literal_at = 0;
+    for (size_t i = 0; i < size;)
+    {
+        size_t run = 1;
+        while (i + run < size && run < 129 && raw_data[i + run] == raw_data[i])
+            run++;
+        if (run > 2 && rand() % 8 == 0)
+            run = 2 + rand() % (run - 1);
+
+        if (run >= 3 || (run == 2 && !literal))
+        {
+            if (literal)
+            {
+                rle_data[literal_at] = (uint8_t)(literal - 1);
+                literal = 0;
+            }
+            rle_data[out++] = (uint8_t)(0x80 | (run - 2));
+            rle_data[out++] = raw_data[i];
+            i += run;
+            continue;
+        }
+        if (!literal)
+            literal_at = out++;
+        rle_data[out++] = raw_data[i++];
+        if (++literal == 128)
+        {
+            rle_data[literal_at] = 127;
+            literal = 0;
+        }
+    }
+    if (literal)
+        rle_data[literal_at] = (uint8_t)(literal - 1);
+    return out;
+}
+
+// Referência: aplica o modo a cada pixel da imagem; no modo cópia, os apagados também substituem o quadro
+static void ref_blit(const ssd1306_t *ssd, const bitmap_t *bitmap, int x, int y, ssd1306_mode_t mode)
+{
+    for (int i = 0; i < bitmap->width; ++i)
+        for (int j = 0; j < bitmap->height; ++j)
+        {
+            bool on = (raw_data[(j / 8) * bitmap->width + i] >> (j % 8)) & 1;
+            if (on || mode == SSD1306_COPY)
+                ref_apply(ssd, reference, x + i, y + j, on, mode);
+        }
+}
+
+static int position(int size, int limit)
+{
+    int p = rand() % (size + limit + 16) - size - 8;
+    return rand() % 4 ? p : p & ~7; // Às vezes alinhada a uma página
+}
+
+// Desenha o mesmo bitmap em RLE e sem compressão sobre o mesmo quadro e compara com a referência
+static bool check_blit(ssd1306_t *ssd, const bitmap_t *rle, const bitmap_t *raw, int x, int y, ssd1306_mode_t mode)
+{
+    ref_noise(ssd, reference);
+    memcpy(before, ssd->ram_buffer, ssd->bufsize);
+    ref_blit(ssd, raw, x, y, mode);
+
+    ssd1306_blit(ssd, rle, x, y, mode);
+    bool rle_ok = memcmp(ssd->ram_buffer, reference, ssd->bufsize) == 0 && ref_dirty_covers(ssd, before);
+
+    memcpy(ssd->ram_buffer, before, ssd->bufsize);
+    memset(ssd->dirty_x0, 0xFF, sizeof(ssd->dirty_x0));
+    memset(ssd->dirty_x1, 0, sizeof(ssd->dirty_x1));
+    ssd1306_blit(ssd, raw, x, y, mode);
+    bool raw_ok = memcmp(ssd->ram_buffer, reference, ssd->bufsize) == 0 && ref_dirty_covers(ssd, before);
+
+    if (rle_ok && raw_ok)
+        return true;
+    fprintf(stderr, "blit %ux%u em (%d, %d), %s: %s difere da referência\n", rle->width, rle->height, x, y,
+            mode_names[mode], rle_ok ? "sem compressão" : raw_ok ? "RLE" : "RLE e sem compressão");
+    CHECK(false);
+    return false;
+}
+
+static void test_random(ssd1306_t *ssd)
+{
+    for (int round = 0; round < 20000; ++round)
+    {
+        uint8_t width = 1 + rand() % (rand() % 4 ? 40 : IMAGE_MAX_WIDTH);
+        uint8_t height = 1 + rand() % (rand() % 4 ? 24 : IMAGE_MAX_HEIGHT);
+        random_image(width, height);
+        size_t raw_size = pack(width, height);
+        size_t rle_size = rle_encode(raw_size);
+
+        uint8_t pages = (height + 7) / 8;
+        bitmap_t raw = {width, height, pages, BITMAP_RAW, (uint16_t)raw_size, raw_data};
+        bitmap_t rle = {width, height, pages, BITMAP_RLE, (uint16_t)rle_size, rle_data};
+        int x = position(width, ssd->width), y = position(height, ssd->height);
+        if (!check_blit(ssd, &rle, &raw, x, y, rand() % 4))
+            return;
+    }
+}
+
+// Logo gerado na compilação: as duas versões de tools/img2bitmap.py em todas as alturas
+static void test_logo(ssd1306_t *ssd)
+{
+    CHECK_EQ(bitmap_logo.format, BITMAP_RLE);
+    CHECK_EQ(bitmap_logo_raw.size, bitmap_raw_size(&bitmap_logo_raw));
+    memcpy(raw_data, bitmap_logo_raw.data, bitmap_logo_raw.size);
+
+    for (int y = -bitmap_logo.height - 1; y <= ssd->height; ++y)
+        for (int mode = 0; mode < 4; ++mode)
+        {
+            int x = position(bitmap_logo.width, ssd->width);
+            if (!check_blit(ssd, &bitmap_logo, &bitmap_logo_raw, x, y, mode))
+                return;
+        }
+}
+
+int main(void)
+{
+    srand(25);
+    ssd1306_t ssd;
+    host_reset();
+    ssd1306_init_with_buffers(&ssd, 128, 64, false, 0x3C, i2c1, ssd_ram, ssd_tx, NULL);
+    test_random(&ssd);
+    test_logo(&ssd);
+
+    ssd1306_init_with_buffers(&ssd, 128, 32, false, 0x3C, i2c1, ssd_ram, ssd_tx, NULL);
+    test_random(&ssd);
+    test_logo(&ssd);
+    return TEST_RESULT("test_ssd1306_blit");
+}
@@ -0,0 +1,84 @@
+// Listas de comandos (user-003): ssd1306_config em uma única transação, divisão de listas longas e
+// o custo de ssd1306_command isolado, com os comandos conferidos pelo modelo do controlador
+
+#include "test.h"
+#include "ssd1306_model.h"
+
+#define ADDRESS 0x3C
+#define NOP 0xE3
+
+static uint8_t ssd_ram[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(128, 64)];
+
+static void test_config(uint8_t height)
+{
+    ssd1306_t ssd;
+    ssd1306_model_t model;
+    host_reset();
+    ssd1306_model_init(&model);
+    ssd1306_init_with_buffers(&ssd, 128, height, false, ADDRESS, i2c1, ssd_ram, ssd_tx, NULL);
+
+    // 16 comandos e 9 parâmetros após o byte de controle 0x00, em uma transação
+    ssd1306_config(&ssd);
+    CHECK_EQ(host_i2c.transactions, 1);
+    CHECK_EQ(host_i2c.bytes, 1 + 25);
+    CHECK_EQ(host_i2c_bytes(0)[0], 0x00);
+    CHECK_EQ(ssd.tx_transactions, 1);
+    CHECK_EQ(ssd.tx_bytes, 1 + 25 + 1);
+
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    CHECK_EQ(model.commands, 16);
+    CHECK_EQ(model.mode, 1);
+    CHECK(model.on);
+
+    // MUX e pinos COM dependem da altura
+    const uint8_t *bytes = host_i2c_bytes(0);
+    CHECK_EQ(bytes[6], SET_MUX_RATIO);
+    CHECK_EQ(bytes[7], height - 1);
+    CHECK_EQ(bytes[11], SET_COM_PIN_CFG);
+    CHECK_EQ(bytes[12], height == 32 ? 0x02 : 0x12);
+}
+
+static void test_split(void)
+{
+    ssd1306_t ssd;
+    host_reset();
+    ssd1306_init_with_buffers(&ssd, 128, 64, false, ADDRESS, i2c1, ssd_ram, ssd_tx, NULL);
+
+    // 40 comandos: uma lista cheia (controle + 31) e o restante (controle + 9)
+    ssd1306_cmdlist_t list;
+    ssd1306_cmdlist_begin(&list);
+    for (int i = 0; i < 40; ++i)
+        ssd1306_cmdlist_add(&ssd, &list, NOP);
+    CHECK_EQ(host_i2c.transactions, 1);
+    ssd1306_cmdlist_send(&ssd, &list);
+    CHECK_EQ(host_i2c.transactions, 2);
+    CHECK_EQ(host_i2c.xfers[0].length, SSD1306_CMDLIST_SIZE);
+    CHECK_EQ(host_i2c.xfers[1].length, 1 + 40 - (SSD1306_CMDLIST_SIZE - 1));
+    CHECK_EQ(host_i2c_bytes(1)[0], 0x00);
+
+    // Lista vazia não gera transação
+    host_i2c_reset();
+    ssd1306_cmdlist_begin(&list);
+    ssd1306_cmdlist_send(&ssd, &list);
+    CHECK_EQ(host_i2c.transactions, 0);
+
+    // ssd1306_command: uma transação de 2 bytes por comando
+    ssd1306_reset_stats(&ssd);
+    for (int i = 0; i < 25; ++i)
+        ssd1306_command(&ssd, NOP);
+    CHECK_EQ(host_i2c.transactions, 25);
+    CHECK_EQ(host_i2c.bytes, 25 * 2);
+    CHECK_EQ(ssd.tx_bytes, 25 * 3);
+
+    // Pelo modelo de barramento, os 25 bytes de configuração custam 1 transação em vez de 25
+    CHECK(ssd1306_bus_time_us(27, 1, 400000) < ssd1306_bus_time_us(75, 25, 400000));
+}
+
+int main(void)
+{
+    test_config(64);
+    test_config(32);
+    test_split();
+    return TEST_RESULT("test_ssd1306_cmdlist");
+}
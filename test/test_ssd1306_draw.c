@@ -0,0 +1,106 @@
+// Desenho por colunas (user-004): ssd1306_draw_columns, ssd1306_draw_char e ssd1306_draw_icon
+// comparados pixel a pixel com a referência, em posições aleatórias, alinhadas ou não, e nas bordas
+
+#include "test.h"
+#include "host_sdk.h"
+#include "ssd1306_ref.h"
+#include "font_table.h"
+#include "font.h"
+
+static uint8_t ssd_ram[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(128, 64)];
+static uint8_t reference[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t before[SSD1306_BUFFER_SIZE(128, 64)];
+
+// Referência: cada bit de cada coluna é um pixel, de cima (bit 0) para baixo
+static void ref_columns(const ssd1306_t *ssd, const uint8_t *columns, int count, int x, int y)
+{
+    for (int i = 0; i < count; ++i)
+        for (int bit = 0; bit < 8; ++bit)
+            ref_put(ssd, reference, x + i, y + bit, (columns[i] >> bit) & 1);
+}
+
+static void test_columns(ssd1306_t *ssd)
+{
+    uint8_t columns[64];
+    for (int round = 0; round < 5000; ++round)
+    {
+        ref_noise(ssd, reference);
+        memcpy(before, ssd->ram_buffer, ssd->bufsize);
+        int count = 1 + rand() % 40;
+        int x = rand() % (ssd->width + 8);
+        int y = rand() % (ssd->height + 8);
+        for (int i = 0; i < count; ++i)
+            columns[i] = (uint8_t)rand();
+
+        ssd1306_draw_columns(ssd, columns, count, x, y);
+        if (x < ssd->width && y < ssd->height)
+            ref_columns(ssd, columns, count, x, y);
+
+        if (memcmp(ssd->ram_buffer, reference, ssd->bufsize) != 0)
+        {
+            fprintf(stderr, "draw_columns(count=%d, x=%d, y=%d) difere da referência\n", count, x, y);
+            CHECK(false);
+            return;
+        }
+        CHECK(ref_dirty_covers(ssd, before));
+    }
+}
+
+// Célula monoespaçada: colunas do glifo deslocadas por left, o resto da célula em branco
+static void test_chars(ssd1306_t *ssd)
+{
+    const font_t *font = &font8x8;
+    for (int round = 0; round < 2000; ++round)
+    {
+        ref_noise(ssd, reference);
+        char c = (char)(32 + rand() % 96);
+        int x = rand() % ssd->width, y = rand() % ssd->height;
+
+        ssd1306_draw_char(ssd, c, x, y);
+        const font_glyph_t *glyph = font_glyph(font, c);
+        for (int page = 0; page < font->pages; ++page)
+        {
+            uint8_t cell[FONT_MAX_CELL] = {0};
+            if (glyph && glyph->width)
+                memcpy(&cell[glyph->left], font_glyph_columns(font, glyph, page), glyph->width);
+            if (y + page * 8 < ssd->height)
+                ref_columns(ssd, cell, font->cell, x, y + page * 8);
+        }
+
+        if (memcmp(ssd->ram_buffer, reference, ssd->bufsize) != 0)
+        {
+            fprintf(stderr, "draw_char('%c', x=%d, y=%d) difere da referência\n", c, x, y);
+            CHECK(false);
+            return;
+        }
+    }
+}
+
+static void test_icons(ssd1306_t *ssd)
+{
+    for (int id = 0; id < 3; ++id)
+    {
+        ref_noise(ssd, reference);
+        ssd1306_draw_icon(ssd, id, 100, 13);
+        ref_columns(ssd, &icon[id * 8], 8, 100, 13);
+        CHECK(memcmp(ssd->ram_buffer, reference, ssd->bufsize) == 0);
+    }
+}
+
+int main(void)
+{
+    srand(4);
+    ssd1306_t ssd;
+    host_reset();
+    ssd1306_init_with_buffers(&ssd, 128, 64, false, 0x3C, i2c1, ssd_ram, ssd_tx, NULL);
+    test_columns(&ssd);
+    test_chars(&ssd);
+    test_icons(&ssd);
+
+    // Display de 32 linhas: a borda inferior fica na página 3
+    ssd1306_init_with_buffers(&ssd, 128, 32, false, 0x3C, i2c1, ssd_ram, ssd_tx, NULL);
+    test_columns(&ssd);
+    test_chars(&ssd);
+    return TEST_RESULT("test_ssd1306_draw");
+}
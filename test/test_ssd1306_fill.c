@@ -0,0 +1,150 @@
+// Preenchimentos (user-005): ssd1306_fill_area em retângulos aleatórios, nos quatro modos, e
+// ssd1306_fill, ssd1306_rect, ssd1306_hline e ssd1306_vline comparados pixel a pixel com a referência
+
+#include "test.h"
+#include "host_sdk.h"
+#include "ssd1306_ref.h"
+
+static uint8_t ssd_ram[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(128, 64)];
+static uint8_t reference[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t before[SSD1306_BUFFER_SIZE(128, 64)];
+
+static const char *mode_names[] = {"SET", "CLEAR", "XOR", "COPY"};
+
+// Referência: a área x0..x1, y0..y1 (inclusiva), recortada no display, com a imagem toda ligada
+static void ref_area(const ssd1306_t *ssd, int x0, int y0, int x1, int y1, ssd1306_mode_t mode)
+{
+    for (int x = x0; x <= x1; ++x)
+        for (int y = y0; y <= y1; ++y)
+            ref_apply(ssd, reference, x, y, true, mode == SSD1306_COPY ? SSD1306_SET : mode);
+}
+
+static bool compare(const ssd1306_t *ssd, const char *what, int a, int b, int c, int d, int mode)
+{
+    if (memcmp(ssd->ram_buffer, reference, ssd->bufsize) == 0 && ref_dirty_covers(ssd, before))
+        return true;
+    fprintf(stderr, "%s(%d, %d, %d, %d, %s) difere da referência\n", what, a, b, c, d, mode_names[mode]);
+    CHECK(false);
+    return false;
+}
+
+// Coordenada aleatória, às vezes além da borda, às vezes numa borda de página
+static int coordinate(int limit)
+{
+    switch (rand() % 4)
+    {
+    case 0:
+        return (rand() % (limit / 8 + 1)) * 8 + (rand() & 1 ? 7 : 0);
+    case 1:
+        return rand() % (limit + 16);
+    default:
+        return rand() % limit;
+    }
+}
+
+static void test_fill_area(ssd1306_t *ssd)
+{
+    for (int round = 0; round < 20000; ++round)
+    {
+        ref_noise(ssd, reference);
+        memcpy(before, ssd->ram_buffer, ssd->bufsize);
+        int x0 = coordinate(ssd->width), x1 = coordinate(ssd->width);
+        int y0 = coordinate(ssd->height), y1 = coordinate(ssd->height);
+        if (rand() % 8)
+        {
+            // Na maioria das vezes, um retângulo bem formado
+            if (x0 > x1) { int t = x0; x0 = x1; x1 = t; }
+            if (y0 > y1) { int t = y0; y0 = y1; y1 = t; }
+        }
+        ssd1306_mode_t mode = rand() % 4;
+
+        ssd1306_fill_area(ssd, x0, y0, x1, y1, mode);
+        if (x0 <= x1 && y0 <= y1)
+            ref_area(ssd, x0, y0, x1, y1, mode);
+        if (!compare(ssd, "fill_area", x0, y0, x1, y1, mode))
+            return;
+    }
+
+    // Display inteiro (caminho das colunas contíguas)
+    for (int mode = 0; mode < 4; ++mode)
+    {
+        ref_noise(ssd, reference);
+        memcpy(before, ssd->ram_buffer, ssd->bufsize);
+        ssd1306_fill_area(ssd, 0, 0, ssd->width - 1, ssd->height - 1, mode);
+        ref_area(ssd, 0, 0, ssd->width - 1, ssd->height - 1, mode);
+        compare(ssd, "fill_area", 0, 0, ssd->width - 1, ssd->height - 1, mode);
+    }
+}
+
+static void test_shapes(ssd1306_t *ssd)
+{
+    for (int round = 0; round < 5000; ++round)
+    {
+        ref_noise(ssd, reference);
+        memcpy(before, ssd->ram_buffer, ssd->bufsize);
+        bool value = rand() & 1;
+        ssd1306_mode_t mode = value ? SSD1306_SET : SSD1306_CLEAR;
+        int a = coordinate(ssd->width), b = coordinate(ssd->width), y = coordinate(ssd->height);
+
+        switch (rand() % 4)
+        {
+        case 0:
+            ssd1306_fill(ssd, value);
+            ref_area(ssd, 0, 0, ssd->width - 1, ssd->height - 1, mode);
+            compare(ssd, "fill", 0, 0, 0, 0, mode);
+            break;
+        case 1:
+            ssd1306_hline(ssd, a, b, y, value);
+            if (a <= b)
+                ref_area(ssd, a, y, b, y, mode);
+            compare(ssd, "hline", a, b, y, 0, mode);
+            break;
+        case 2:
+            ssd1306_vline(ssd, y, a % ssd->height, b % ssd->height, value);
+            if (a % ssd->height <= b % ssd->height)
+                ref_area(ssd, y, a % ssd->height, y, b % ssd->height, mode);
+            compare(ssd, "vline", y, a % ssd->height, b % ssd->height, 0, mode);
+            break;
+        default:
+        {
+            // rect(top, left, width, height): bordas além de 255 são recortadas
+            int top = coordinate(ssd->height), left = coordinate(ssd->width);
+            int width = rand() % 140, height = rand() % 70;
+            bool fill = rand() & 1;
+            ssd1306_rect(ssd, top, left, width, height, value, fill);
+            if (width && height)
+            {
+                int right = left + width - 1 > 255 ? 255 : left + width - 1;
+                int bottom = top + height - 1 > 255 ? 255 : top + height - 1;
+                if (fill)
+                    ref_area(ssd, left, top, right, bottom, mode);
+                else
+                {
+                    ref_area(ssd, left, top, right, top, mode);
+                    ref_area(ssd, left, bottom, right, bottom, mode);
+                    ref_area(ssd, left, top, left, bottom, mode);
+                    ref_area(ssd, right, top, right, bottom, mode);
+                }
+            }
+            compare(ssd, fill ? "rect cheio" : "rect", top, left, width, height, mode);
+            break;
+        }
+        }
+    }
+}
+
+int main(void)
+{
+    srand(5);
+    ssd1306_t ssd;
+    host_reset();
+    ssd1306_init_with_buffers(&ssd, 128, 64, false, 0x3C, i2c1, ssd_ram, ssd_tx, NULL);
+    test_fill_area(&ssd);
+    test_shapes(&ssd);
+
+    ssd1306_init_with_buffers(&ssd, 128, 32, false, 0x3C, i2c1, ssd_ram, ssd_tx, NULL);
+    test_fill_area(&ssd);
+    test_shapes(&ssd);
+    return TEST_RESULT("test_ssd1306_fill");
+}
@@ -0,0 +1,123 @@
+// Envio ao display com regiões alteradas (user-001): bytes e transações exatos de um envio completo,
+// da atualização "G ON" e de um envio sem alterações, e o conteúdo que chega ao display (modelo)
+
+#include "test.h"
+#include "ssd1306_model.h"
+#include "i2c_bus.h"
+
+#define ADDRESS 0x3C
+
+static uint8_t ssd_ram[SSD1306_BUFFER_SIZE(128, 64)];
+static uint8_t ssd_tx[SSD1306_TX_BUFFER_SIZE(128, 64)];
+static uint16_t ssd_dma[SSD1306_DMA_BUFFER_WORDS(128, 64)];
+
+static void draw_noise(ssd1306_t *ssd)
+{
+    for (int i = 0; i < 2000; ++i)
+        ssd1306_pixel(ssd, rand() % 128, rand() % 64, rand() & 1);
+}
+
+// Mesma atualização do benchmark: o estado do LED verde na linha 48 e um dígito em y = 23
+static void draw_g_on(ssd1306_t *ssd)
+{
+    ssd1306_draw_string(ssd, "G ON ", 8, 48);
+    ssd1306_draw_char(ssd, '5', 64, 23);
+}
+
+// i2c_write_blocking: as janelas alteradas são agrupadas e cada uma é uma transação
+static void test_blocking(void)
+{
+    ssd1306_t ssd;
+    ssd1306_model_t model;
+    host_reset();
+    ssd1306_model_init(&model);
+    ssd1306_init_with_buffers(&ssd, 128, 64, false, ADDRESS, i2c1, ssd_ram, ssd_tx, ssd_dma);
+    ssd1306_config(&ssd);
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    CHECK_EQ(model.mode, 1); // Endereçamento vertical
+
+    // Completo: cabeçalho da janela (13 bytes) + 1024 bytes de quadro, em uma transação
+    draw_noise(&ssd);
+    host_i2c_reset();
+    ssd1306_reset_stats(&ssd);
+    ssd1306_send_data(&ssd);
+    CHECK_EQ(host_i2c.transactions, 1);
+    CHECK_EQ(host_i2c.bytes, SSD1306_WINDOW_HEADER + 1024);
+    CHECK_EQ(ssd.tx_transactions, 1);
+    CHECK_EQ(ssd.tx_bytes, SSD1306_WINDOW_HEADER + 1024 + 1); // Com o byte de endereço
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    CHECK(ssd1306_model_matches(&model, &ssd));
+
+    // "G ON " (5 x 8 colunas na página 6) e '5' em y = 23 (colunas 64..71, páginas 2 e 3, agrupadas)
+    draw_g_on(&ssd);
+    host_i2c_reset();
+    ssd1306_reset_stats(&ssd);
+    ssd1306_send_dirty(&ssd);
+    CHECK_EQ(host_i2c.transactions, 2);
+    CHECK_EQ(host_i2c.xfers[0].length, SSD1306_WINDOW_HEADER + 8 * 2);
+    CHECK_EQ(host_i2c.xfers[1].length, SSD1306_WINDOW_HEADER + 40);
+    CHECK_EQ(host_i2c.bytes, 2 * SSD1306_WINDOW_HEADER + 16 + 40);
+    CHECK_EQ(ssd.tx_bytes, 2 * SSD1306_WINDOW_HEADER + 16 + 40 + 2);
+    const uint8_t window[] = {0x80, SET_COL_ADDR, 0x80, 64, 0x80, 71, 0x80, SET_PAGE_ADDR, 0x80, 2, 0x80, 3, 0x40};
+    CHECK(memcmp(host_i2c_bytes(0), window, sizeof(window)) == 0);
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    CHECK(ssd1306_model_matches(&model, &ssd));
+
+    // Sem alterações: nada é enviado
+    host_i2c_reset();
+    ssd1306_send_dirty(&ssd);
+    CHECK_EQ(host_i2c.transactions, 0);
+
+    // Alterações aleatórias: o display sempre termina igual ao buffer
+    for (int round = 0; round < 50; ++round)
+    {
+        for (int i = rand() % 20; i > 0; --i)
+            ssd1306_pixel(&ssd, rand() % 128, rand() % 64, rand() & 1);
+        host_i2c_reset();
+        ssd1306_send_dirty(&ssd);
+        ssd1306_model_replay(&model, 0, ADDRESS);
+    }
+    CHECK(ssd1306_model_matches(&model, &ssd));
+}
+
+// Barramento compartilhado: uma transação por página alterada, para não monopolizar o I2C
+static void test_shared_bus(void)
+{
+    ssd1306_t ssd;
+    i2c_bus_t bus;
+    ssd1306_model_t model;
+    host_reset();
+    ssd1306_model_init(&model);
+    i2c_bus_init(&bus, i2c1, 14, 15, I2C_BUS_FAST_PLUS);
+    ssd1306_init_with_buffers(&ssd, 128, 64, false, ADDRESS, i2c1, ssd_ram, ssd_tx, ssd_dma);
+    ssd1306_attach_bus(&ssd, &bus, I2C_PRIO_BULK);
+    ssd1306_config(&ssd);
+
+    draw_noise(&ssd);
+    host_i2c_reset();
+    ssd1306_reset_stats(&ssd);
+    ssd1306_send_data(&ssd);
+    CHECK_EQ(host_i2c.transactions, 8);
+    CHECK_EQ(host_i2c.bytes, 8 * (SSD1306_WINDOW_HEADER + 128));
+    CHECK_EQ(ssd.tx_bytes, 8 * (SSD1306_WINDOW_HEADER + 128 + 1));
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    CHECK(ssd1306_model_matches(&model, &ssd));
+
+    draw_g_on(&ssd);
+    host_i2c_reset();
+    ssd1306_reset_stats(&ssd);
+    ssd1306_send_dirty(&ssd);
+    CHECK_EQ(host_i2c.transactions, 3);
+    CHECK_EQ(host_i2c.bytes, 3 * SSD1306_WINDOW_HEADER + 8 + 8 + 40);
+    CHECK_EQ(ssd.tx_bytes, 3 * SSD1306_WINDOW_HEADER + 8 + 8 + 40 + 3);
+    ssd1306_model_replay(&model, 0, ADDRESS);
+    CHECK(ssd1306_model_matches(&model, &ssd));
+}
+
+int main(void)
+{
+    srand(1);
+    test_blocking();
+    test_shared_bus();
+    return TEST_RESULT("test_ssd1306_flush");
+}
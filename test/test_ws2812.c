@@ -0,0 +1,163 @@
+// Saída WS2812 por DMA (user-007): trocas de quadros de ws2812_frames.c sem cópia, e o driver
+// completo com o DMA, o alarme de reset e a FIFO do PIO substitutos
+
+#include "test.h"
+#include "host_sdk.h"
+#include "ws2812.h"
+
+#define COUNT 25
+
+static void test_pack(void)
+{
+    CHECK_EQ(ws2812_grb(0x12, 0x34, 0x56), 0x34125600u);
+    CHECK_EQ(ws2812_grb(255, 0, 0), 0x00FF0000u);
+    CHECK_EQ(ws2812_grb(0, 255, 0), 0xFF000000u);
+    CHECK_EQ(ws2812_grb(0, 0, 255), 0x0000FF00u);
+}
+
+// Sequências aleatórias de solicitações, inícios e travamentos: os três quadros nunca se confundem e
+// cada transmissão lê exatamente o quadro solicitado por último, sem cópia
+static void test_transitions(void)
+{
+    static uint32_t frames[3][COUNT];
+    static const uint32_t external[COUNT] = {0xE0E0E000u};
+    ws2812_frames_t f;
+    ws2812_frames_init(&f, frames[0], frames[1], frames[2]);
+    CHECK(ws2812_frames_idle(&f));
+    CHECK(ws2812_frames_start(&f) == NULL);
+
+    const uint32_t *requested = NULL; // Último quadro solicitado ainda não transmitido
+    uint32_t requested_tag = 0, tag = 1;
+    const uint32_t *on_wire = NULL;
+
+    for (int step = 0; step < 100000; ++step)
+    {
+        CHECK(f.back != f.ready && f.back != f.front && f.ready != f.front);
+        CHECK(ws2812_frames_back(&f) != on_wire); // Nunca se edita o quadro em transmissão
+
+        switch (rand() % 4)
+        {
+        case 0:
+            ws2812_frames_back(&f)[0] = tag;
+            requested = ws2812_frames_submit(&f);
+            CHECK(requested != ws2812_frames_back(&f));
+            CHECK_EQ(requested[0], tag);
+            requested_tag = tag++;
+            break;
+        case 1:
+            ws2812_frames_submit_external(&f, external);
+            requested = external;
+            requested_tag = external[0];
+            break;
+        case 2:
+        {
+            const uint32_t *frame = ws2812_frames_start(&f);
+            if (f.busy && frame == NULL)
+                break;
+            if (requested)
+            {
+                CHECK(frame == requested);
+                CHECK_EQ(frame[0], requested_tag);
+                on_wire = frame;
+                requested = NULL;
+            }
+            else
+                CHECK(frame == NULL);
+            break;
+        }
+        default:
+            if (f.busy)
+            {
+                ws2812_frames_latched(&f);
+                on_wire = NULL;
+            }
+            break;
+        }
+        CHECK_EQ(f.pending, requested != NULL);
+    }
+}
+
+static ws2812_t strip;
+static int latched;
+
+static void latch_done(ws2812_t *s)
+{
+    latched++;
+}
+
+static bool log_matches(uint32_t first, const uint32_t *frame)
+{
+    host_pio_log_t *log = host_pio_log(pio0, strip.sm);
+    return log->count >= first + COUNT && memcmp(&log->words[first], frame, COUNT * sizeof(uint32_t)) == 0;
+}
+
+static void test_driver(void)
+{
+    uint32_t expected[COUNT];
+    host_reset();
+    host_time_set(1000);
+    host_dma_hold(true);
+    CHECK(ws2812_init(&strip, pio0, 0, COUNT));
+    ws2812_set_callback(&strip, latch_done);
+    CHECK(ws2812_idle(&strip));
+
+    // Primeiro quadro: vai direto para o DMA; com keep, a edição continua do quadro enviado
+    for (uint i = 0; i < COUNT; ++i)
+        ws2812_set(&strip, i, i, 2 * i, 3 * i);
+    uint32_t *first = ws2812_frame(&strip);
+    memcpy(expected, first, sizeof(expected));
+    ws2812_show(&strip, true);
+    CHECK(ws2812_frame(&strip) != first);
+    CHECK(memcmp(ws2812_frame(&strip), expected, sizeof(expected)) == 0);
+    CHECK_EQ(host_dma_transfers(strip.dma_channel), 1);
+    CHECK(!ws2812_idle(&strip));
+
+    // Segundo quadro durante a transmissão: fica pendente
+    ws2812_set(&strip, 0, 255, 255, 255);
+    uint32_t second[COUNT];
+    memcpy(second, ws2812_frame(&strip), sizeof(second));
+    ws2812_show(&strip, false);
+    CHECK_EQ(host_dma_transfers(strip.dma_channel), 1);
+
+    // O DMA lê o próprio quadro solicitado (sem cópia): o que chega à FIFO é o conteúdo no término
+    first[1] = 0xABCDEF00u;
+    expected[1] = 0xABCDEF00u;
+    CHECK(host_dma_complete(strip.dma_channel));
+    CHECK(log_matches(0, expected));
+
+    // Esvaziamento da FIFO (9 palavras de 24 bits) e reset antes de liberar a cadeia
+    uint32_t wait_us = (WS2812_FIFO_DEPTH + 1) * 24 * WS2812_BIT_NS / 1000 + WS2812_RESET_US;
+    host_time_advance(wait_us - 1);
+    CHECK_EQ(latched, 0);
+    host_time_advance(1);
+    CHECK_EQ(latched, 1);
+    CHECK_EQ(host_dma_transfers(strip.dma_channel), 2); // O pendente começa no travamento
+
+    CHECK(host_dma_complete(strip.dma_channel));
+    CHECK(log_matches(COUNT, second));
+    host_time_advance(wait_us);
+    CHECK_EQ(latched, 2);
+    CHECK(ws2812_idle(&strip));
+
+    // Quadro externo: lido diretamente pelo DMA, sem alterar o quadro em edição
+    static uint32_t external[COUNT];
+    for (uint i = 0; i < COUNT; ++i)
+        external[i] = ws2812_grb(9, 8, 7);
+    uint32_t *editing = ws2812_frame(&strip);
+    ws2812_show_frame(&strip, external);
+    CHECK(ws2812_frame(&strip) == editing);
+    CHECK(host_dma_complete(strip.dma_channel));
+    CHECK(log_matches(2 * COUNT, external));
+    host_time_advance(wait_us);
+    CHECK(ws2812_idle(&strip));
+    CHECK_EQ(host_pio_log(pio0, strip.sm)->count, 3 * COUNT);
+}
+
+int main(void)
+{
+    srand(7);
+    test_pack();
+    test_transitions();
+    test_driver();
+    return TEST_RESULT("test_ws2812");
+}
@@ -0,0 +1,93 @@
+// Saída WS2812 paralela (user-013): a transposição SWAR de ws2812_parallel_pack comparada, bit a
+// bit, com uma referência ingênua, e os planos que o DMA entrega à FIFO da máquina de estados
+
+#include "test.h"
+#include "host_sdk.h"
+#include "ws2812_parallel.h"
+
+#define COUNT_MAX 40
+
+// Referência: o plano k (0..23) de um LED é o bit 23 - k da cor de cada fita (G, R, B, do bit mais
+// significativo ao menos), com a fita s no bit s; quatro planos por palavra, o primeiro no byte baixo
+static uint32_t ref_plane_word(const uint32_t *const *frames, uint strips, uint led, uint word)
+{
+    uint32_t out = 0;
+    for (uint b = 0; b < 4; ++b)
+    {
+        uint k = word * 4 + b;
+        uint8_t plane = 0;
+        for (uint s = 0; s < strips; ++s)
+            if (frames[s] && (frames[s][led] >> (31 - k) & 1))
+                plane |= 1u << s;
+        out |= (uint32_t)plane << (8 * b);
+    }
+    return out;
+}
+
+static uint32_t random_grb(void)
+{
+    return ((uint32_t)rand() << 16 ^ (uint32_t)rand()) & 0xFFFFFF00u;
+}
+
+// Quadros aleatórios com 1 a 8 fitas, algumas ausentes (NULL), e comprimentos variados
+static void test_pack(void)
+{
+    static uint32_t frames[WS2812_PARALLEL_MAX_STRIPS][COUNT_MAX];
+    static uint32_t planes[COUNT_MAX * WS2812_PARALLEL_WORDS_PER_LED];
+
+    for (int round = 0; round < 2000; ++round)
+    {
+        uint strips = 1 + rand() % WS2812_PARALLEL_MAX_STRIPS;
+        uint count = 1 + rand() % COUNT_MAX;
+        const uint32_t *list[WS2812_PARALLEL_MAX_STRIPS] = {0};
+        for (uint s = 0; s < WS2812_PARALLEL_MAX_STRIPS; ++s)
+        {
+            for (uint i = 0; i < count; ++i)
+                frames[s][i] = round < 24 ? 0x80000000u >> round : random_grb(); // Um bit por vez no início
+            list[s] = rand() % 5 ? frames[s] : NULL;
+        }
+
+        ws2812_parallel_pack(planes, list, strips, count);
+        for (uint i = 0; i < count; ++i)
+            for (uint w = 0; w < WS2812_PARALLEL_WORDS_PER_LED; ++w)
+                CHECK_EQ(planes[i * WS2812_PARALLEL_WORDS_PER_LED + w], ref_plane_word(list, strips, i, w));
+    }
+}
+
+// Driver: os planos chegam à FIFO na ordem, e o próximo quadro espera o reset
+static void test_show(void)
+{
+    static uint32_t frames[3][COUNT_MAX];
+    const uint32_t *list[3] = {frames[0], frames[1], frames[2]};
+    ws2812_parallel_t out;
+
+    host_reset();
+    host_time_set(1000);
+    CHECK(ws2812_parallel_init(&out, pio0, 2, 3, COUNT_MAX));
+    for (uint s = 0; s < 3; ++s)
+        for (uint i = 0; i < COUNT_MAX; ++i)
+            frames[s][i] = random_grb();
+
+    CHECK(ws2812_parallel_show(&out, list));
+    host_pio_log_t *log = host_pio_log(pio0, out.sm);
+    CHECK_EQ(log->count, COUNT_MAX * WS2812_PARALLEL_WORDS_PER_LED);
+    for (uint i = 0; i < COUNT_MAX; ++i)
+        for (uint w = 0; w < WS2812_PARALLEL_WORDS_PER_LED; ++w)
+            CHECK_EQ(log->words[i * WS2812_PARALLEL_WORDS_PER_LED + w], ref_plane_word(list, 3, i, w));
+
+    // 40 LEDs x 30 us + reset: antes disso o quadro seguinte é recusado
+    CHECK(!ws2812_parallel_idle(&out));
+    CHECK(!ws2812_parallel_show(&out, list));
+    host_time_advance(COUNT_MAX * 30 + 300);
+    CHECK(ws2812_parallel_idle(&out));
+    CHECK(ws2812_parallel_show(&out, list));
+    CHECK_EQ(log->count, 2 * COUNT_MAX * WS2812_PARALLEL_WORDS_PER_LED);
+}
+
+int main(void)
+{
+    srand(13);
+    test_pack();
+    test_show();
+    return TEST_RESULT("test_ws2812_parallel");
+}
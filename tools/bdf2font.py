@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""Converte uma fonte BDF nas tabelas usadas por ssd1306_draw_char/ssd1306_draw_text.
+
+Cada glifo vira uma sequência de colunas no formato do buffer do SSD1306 (bit 0 no topo),
+página a página, sem as colunas vazias das bordas. A largura de cada glifo e sua posição
+na célula original (para o texto monoespaçado) ficam em uma tabela indexada diretamente
+pelo código do caractere.
+
+Uso: bdf2font.py entrada.bdf saida.c --name font8x8 [--first 32] [--last 126] [--spacing 1]
+"""
+
+import argparse
+import os
+import sys
+
+MAX_CELL = 32  # FONT_MAX_CELL em inc/font_table.h
+
+
+def parse_bdf(path):
+    """Lê a fonte e retorna (ascent, descent, largura da célula, {código: (dwidth, bbx, linhas)})."""
+    glyphs = {}
+    ascent = descent = cell = None
+    glyph = None
+    bitmap = None
+
+    with open(path, encoding="ascii", errors="replace") as f:
+        for raw in f:
+            line = raw.strip()
+            if not line:
+                continue
+            key, _, value = line.partition(" ")
+
+            if bitmap is not None:
+                if key == "ENDCHAR":
+                    glyph["rows"] = bitmap
+                    if glyph["encoding"] >= 0:
+                        glyphs[glyph["encoding"]] = glyph
+                    glyph = bitmap = None
+                else:
+                    bitmap.append(int(key, 16))
+                continue
+
+            if key == "FONTBOUNDINGBOX":
+                cell = int(value.split()[0])
+            elif key == "FONT_ASCENT":
+                ascent = int(value)
+            elif key == "FONT_DESCENT":
+                descent = int(value)
+            elif key == "STARTCHAR":
+                glyph = {"encoding": -1, "dwidth": 0, "bbx": (0, 0, 0, 0)}
+            elif key == "ENCODING" and glyph is not None:
+                glyph["encoding"] = int(value.split()[0])
+            elif key == "DWIDTH" and glyph is not None:
+                glyph["dwidth"] = int(value.split()[0])
+            elif key == "BBX" and glyph is not None:
+                glyph["bbx"] = tuple(int(v) for v in value.split())
+            elif key == "BITMAP":
+                bitmap = []
+
+    if ascent is None or descent is None or cell is None:
+        sys.exit(f"{path}: FONT_ASCENT, FONT_DESCENT e FONTBOUNDINGBOX são obrigatórios")
+    return ascent, descent, cell, glyphs
+
+
+def rasterize(glyph, ascent, height):
+    """Retorna o glifo como uma lista de colunas inteiras (bit y = linha y a partir do topo)."""
+    w, h, xoff, yoff = glyph["bbx"]
+    row_bits = (w + 7) // 8 * 8
+    columns = {}
+    for r, bits in enumerate(glyph["rows"][:h]):
+        y = ascent - (yoff + h) + r
+        if not 0 <= y < height:
+            continue
+        for c in range(w):
+            if bits >> (row_bits - 1 - c) & 1:
+                x = xoff + c
+                if x >= 0:
+                    columns[x] = columns.get(x, 0) | (1 << y)
+    return columns
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("bdf")
+    parser.add_argument("output")
+    parser.add_argument("--name", required=True, help="nome da variável font_t gerada")
+    parser.add_argument("--first", type=int, default=32, help="primeiro caractere da tabela")
+    parser.add_argument("--last", type=int, default=126, help="último caractere da tabela")
+    parser.add_argument("--spacing", type=int, default=1, help="colunas entre glifos no texto proporcional")
+    args = parser.parse_args()
+
+    ascent, descent, cell, glyphs = parse_bdf(args.bdf)
+    height = ascent + descent
+    pages = (height + 7) // 8
+    if cell > MAX_CELL:
+        sys.exit(f"{args.bdf}: célula de {cell} colunas excede FONT_MAX_CELL ({MAX_CELL})")
+
+    data = []
+    entries = []
+    for code in range(args.first, args.last + 1):
+        glyph = glyphs.get(code)
+        if glyph is None:
+            entries.append((0, 0, 0, "ausente"))
+            continue
+
+        columns = rasterize(glyph, ascent, height)
+        if columns:
+            left, right = min(columns), max(columns)
+        else:
+            # Glifo sem pixels (espaço): colunas vazias com a largura de avanço da fonte
+            left, right = 0, max(glyph["dwidth"], 1) - 1
+
+        width = right - left + 1
+        if left + width > cell:
+            sys.exit(f"{args.bdf}: glifo {code} ultrapassa a célula de {cell} colunas")
+        entries.append((len(data), width, left, repr(chr(code))))
+        for page in range(pages):
+            for x in range(left, right + 1):
+                data.append(columns.get(x, 0) >> (page * 8) & 0xFF)
+
+    if len(data) > 0xFFFF:
+        sys.exit(f"{args.bdf}: dados da fonte excedem 64 KiB")
+
+    name = args.name
+    source = os.path.basename(args.bdf)
+    out = []
+    out.append(f"// Gerado por tools/bdf2font.py a partir de {source}; não edite\n")
+    out.append('#include "font_table.h"\n')
+    out.append(f"static const uint8_t {name}_data[] = {{")
+    for i in range(0, len(data), 16):
+        out.append("    " + ", ".join(f"0x{b:02x}" for b in data[i:i + 16]) + ",")
+    out.append("};\n")
+    out.append(f"static const font_glyph_t {name}_glyphs[] = {{")
+    for offset, width, left, label in entries:
+        out.append(f"    {{{offset}, {width}, {left}}}, // {label}")
+    out.append("};\n")
+    out.append(f"const font_t {name} = {{")
+    out.append(f"    .first = {args.first},")
+    out.append(f"    .last = {args.last},")
+    out.append(f"    .height = {height},")
+    out.append(f"    .pages = {pages},")
+    out.append(f"    .cell = {cell},")
+    out.append(f"    .spacing = {args.spacing},")
+    out.append(f"    .glyphs = {name}_glyphs,")
+    out.append(f"    .data = {name}_data,")
+    out.append("};")
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+"""Envia quadros do display e da matriz de LEDs ao firmware pela USB e mede a vazão e a latência.
+
+Os quadros seguem o protocolo de inc/protocol.h: 0xA5 0x5A, tipo, sequência, comprimento (16 bits,
+little-endian), dados e CRC-16 CCITT (little-endian) do tipo ao último byte de dados. O firmware
+responde a cada quadro com uma linha "#ack <sequência> <resultado>" assim que ele é aplicado.
+
+Tipos de carga (--kind):
+  oled    quadro inteiro do display (1024 bytes), com uma barra percorrendo a tela ou uma imagem PBM
+  patch   apenas a janela alterada (a barra de 8 colunas), como faria um remetente incremental
+  leds    quadro GRB da matriz (3 bytes por LED)
+  ping    comando sem dados (ida e volta do protocolo)
+  mixed   alterna display e matriz
+
+Com --window N, até N quadros ficam sem confirmação; com 1, cada quadro espera o anterior (latência
+pura). O relatório mostra quadros por segundo, bytes por segundo e os percentis do envio até a
+confirmação. Com --output, os quadros são gravados em um arquivo em vez de enviados (sem pyserial).
+
+Uso: frame_sender.py /dev/ttyACM0 [--kind oled] [--frames 500] [--window 2] [--image tela.pbm]
+                     [--leds 25] [--output quadros.bin]
+"""
+
+import argparse
+import re
+import sys
+import threading
+import time
+
+WIDTH, HEIGHT = 128, 64
+PAGES = HEIGHT // 8
+SYNC = b"\xa5\x5a"
+
+OLED_FRAME, OLED_PATCH, LED_FRAME, CONTROL = 0x01, 0x02, 0x03, 0x10   # proto_type_t
+CTRL_PING = 0                                                       # proto_control_t
+STATUS = ("ok", "crc", "recusado", "interrompido")                  # proto_status_t
+ACK = re.compile(rb"#ack (\d+) (\d+)")
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16 CCITT (polinômio 0x1021), o mesmo de proto_crc16."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def encode(kind, seq, payload):
+    """Monta um quadro completo."""
+    body = bytes((kind, seq & 0xFF, len(payload) & 0xFF, len(payload) >> 8)) + payload
+    return SYNC + body + crc16(body).to_bytes(2, "little")
+
+
+def oled_bytes(pixel, x0=0, page0=0, x1=WIDTH - 1, page1=PAGES - 1):
+    """Converte pixel(x, y) para o layout do ram_buffer: coluna a coluna, páginas em sequência, bit 0 no topo."""
+    out = bytearray()
+    for x in range(x0, x1 + 1):
+        for page in range(page0, page1 + 1):
+            out.append(sum(1 << bit for bit in range(8) if pixel(x, page * 8 + bit)))
+    return bytes(out)
+
+
+def read_pbm(path):
+    """Lê uma imagem PBM (P1 ou P4) e retorna pixel(x, y), recortada ou completada até 128x64."""
+    with open(path, "rb") as f:
+        data = f.read()
+    tokens = re.sub(rb"#[^\n]*", b"", data[:64]).split()
+    magic, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+    if magic == b"P1":
+        body = re.sub(rb"#[^\n]*", b"", data).split(None, 3)[3]
+        bits = [c - ord("0") for c in body if c in b"01"]  # Os dígitos podem vir sem separação
+        rows = [bits[y * width:(y + 1) * width] for y in range(height)]
+    elif magic == b"P4":
+        raster = data[len(data) - ((width + 7) // 8) * height:]
+        stride = (width + 7) // 8
+        rows = [[(raster[y * stride + x // 8] >> (7 - x % 8)) & 1 for x in range(width)] for y in range(height)]
+    else:
+        sys.exit(f"{path}: apenas PBM P1 ou P4")
+    return lambda x, y: y < height and x < width and rows[y][x]
+
+
+def bar_pixel(position):
+    """Barra vertical de 8 colunas na posição dada, sobre uma moldura fixa."""
+    def pixel(x, y):
+        return position <= x < position + 8 or x in (0, WIDTH - 1) or y in (0, HEIGHT - 1)
+    return pixel
+
+
+def led_bytes(count, step):
+    """Quadro GRB com um gradiente que gira a cada passo (intensidade baixa, como em led_frames)."""
+    out = bytearray()
+    for i in range(count):
+        phase = (i + step) % count
+        r = 32 * phase // count
+        g = 32 - r
+        b = 8 if phase == 0 else 0
+        out += bytes((g, r, b))
+    return bytes(out)
+
+
+def make_frames(args):
+    """Gera os quadros pedidos (sequências de 0 a 255, repetidas)."""
+    image = read_pbm(args.image) if args.image else None
+    frames = []
+    for n in range(args.frames):
+        seq = n & 0xFF
+        kind = args.kind
+        if kind == "mixed":
+            kind = "oled" if n % 2 == 0 else "leds"
+        position = (n * 4) % (WIDTH - 8)
+        if kind == "oled":
+            frames.append(encode(OLED_FRAME, seq, oled_bytes(image or bar_pixel(position))))
+        elif kind == "patch":
+            # A barra anda 4 colunas: a janela cobre a posição anterior e a nova
+            x0, x1 = max(position - 4, 0), min(position + 7, WIDTH - 1)
+            window = bytes((x0, 0, x1, PAGES - 1))
+            frames.append(encode(OLED_PATCH, seq, window + oled_bytes(bar_pixel(position), x0, 0, x1, PAGES - 1)))
+        elif kind == "leds":
+            frames.append(encode(LED_FRAME, seq, led_bytes(args.leds, n)))
+        else:
+            frames.append(encode(CONTROL, seq, bytes((CTRL_PING, 0))))
+    return frames
+
+
+class AckReader(threading.Thread):
+    """Lê a serial e registra o instante de cada confirmação; as demais linhas são ignoradas."""
+
+    def __init__(self, port):
+        super().__init__(daemon=True)
+        self.port = port
+        self.acks = {}       # sequência -> [(instante, resultado)]
+        self.cond = threading.Condition()
+        self.running = True
+
+    def run(self):
+        pending = b""
+        while self.running:
+            pending += self.port.read(self.port.in_waiting or 1)
+            *lines, pending = pending.split(b"\n")
+            for line in lines:
+                match = ACK.search(line)
+                if match:
+                    with self.cond:
+                        self.acks.setdefault(int(match.group(1)), []).append((time.perf_counter(), int(match.group(2))))
+                        self.cond.notify_all()
+
+    def take(self, seq, timeout):
+        """Espera a confirmação da sequência; retorna (instante, resultado) ou None."""
+        deadline = time.perf_counter() + timeout
+        with self.cond:
+            while not self.acks.get(seq):
+                remaining = deadline - time.perf_counter()
+                if remaining <= 0:
+                    return None
+                self.cond.wait(remaining)
+            return self.acks[seq].pop(0)
+
+
+def percentile(values, p):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * p))]
+
+
+def benchmark(port, frames, window, timeout):
+    """Envia os quadros com até window sem confirmação; retorna (duração, latências em ms, resultados)."""
+    reader = AckReader(port)
+    reader.start()
+    sent = []          # (sequência, instante do último byte)
+    latencies, results = [], {}
+    start = time.perf_counter()
+
+    def collect():
+        seq, sent_at = sent.pop(0)
+        ack = reader.take(seq, timeout)
+        if ack is None:
+            results["perdido"] = results.get("perdido", 0) + 1
+            return
+        latencies.append((ack[0] - sent_at) * 1000)
+        name = STATUS[ack[1]] if ack[1] < len(STATUS) else str(ack[1])
+        results[name] = results.get(name, 0) + 1
+
+    for frame in frames:
+        if len(sent) >= window:
+            collect()
+        port.write(frame)
+        port.flush()
+        sent.append((frame[3], time.perf_counter()))
+    while sent:
+        collect()
+    reader.running = False
+    return time.perf_counter() - start, latencies, results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port", nargs="?", help="porta serial da placa (p.ex. /dev/ttyACM0 ou COM5)")
+    parser.add_argument("--kind", choices=("oled", "patch", "leds", "ping", "mixed"), default="oled")
+    parser.add_argument("--frames", type=int, default=500, help="quadros a enviar")
+    parser.add_argument("--window", type=int, default=2, help="quadros em trânsito sem confirmação (até 255)")
+    parser.add_argument("--image", help="imagem PBM exibida em todos os quadros do display")
+    parser.add_argument("--leds", type=int, default=25, help="LEDs por quadro da matriz")
+    parser.add_argument("--timeout", type=float, default=1.0, help="espera máxima por uma confirmação, em s")
+    parser.add_argument("--output", help="grava os quadros neste arquivo em vez de enviá-los")
+    args = parser.parse_args()
+    args.window = max(1, min(args.window, 255))
+
+    frames = make_frames(args)
+    total_bytes = sum(len(f) for f in frames)
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(b"".join(frames))
+        print(f"{len(frames)} quadros ({total_bytes} bytes) gravados em {args.output}")
+        return
+    if not args.port:
+        parser.error("informe a porta serial ou --output")
+
+    try:
+        import serial
+    except ImportError:
+        sys.exit("instale o pyserial: pip install pyserial")
+    with serial.Serial(args.port, timeout=0.05) as port:
+        port.reset_input_buffer()
+        elapsed, latencies, results = benchmark(port, frames, args.window, args.timeout)
+
+    print(f"{len(frames)} quadros '{args.kind}' ({total_bytes} bytes) em {elapsed:.2f} s, janela {args.window}")
+    print(f"  {len(frames) / elapsed:8.1f} quadros/s  {total_bytes / elapsed / 1024:8.1f} KiB/s")
+    if latencies:
+        print(f"  envio->confirmacao: p50 {percentile(latencies, 0.5):.2f} ms  p99 {percentile(latencies, 0.99):.2f} ms  "
+              f"max {max(latencies):.2f} ms")
+    print("  resultados: " + ", ".join(f"{name} {count}" for name, count in sorted(results.items())))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Simula o barramento I2C compartilhado (inc/i2c_bus.c) e mostra a latência de cada classe de prioridade.
+
+O modelo segue a política do firmware: filas por classe, uma transação por vez, sem preempção,
+e a cada transação concluída a próxima vem da classe mais urgente com pendências. A duração de
+uma transação é a mesma estimativa de ssd1306_bus_time_us: 9 ciclos de SCL por byte (incluindo o
+endereço) mais START e STOP.
+
+A carga padrão é o display a 50 quadros/s, com o quadro inteiro alterado (pior caso), dividindo o
+barramento com um sensor urgente (registrador + 6 bytes a 500 Hz) e um sensor normal (registrador +
+2 bytes a 10 Hz). Os cenários comparam o quadro em uma única transação com o quadro em transações de
+uma página, a 400 kHz e a 1 MHz. Os histogramas usam as mesmas faixas de potências de 2 do firmware.
+
+Uso: i2c_bus_sim.py [--seconds 10] [--seed 1] [--dirty-pages 8] [--sensor-hz 500]
+"""
+
+import argparse
+import heapq
+import random
+
+PRIORITIES = ("urgente", "normal", "lote")  # i2c_priority_t
+HIST_BINS = 16                               # I2C_BUS_HIST_BINS
+WIDTH, PAGES = 128, 8
+WINDOW_HEADER = 13                           # SSD1306_WINDOW_HEADER
+
+
+def transaction_us(nbytes, baudrate):
+    """Duração de uma transação de nbytes (sem o endereço) à frequência dada."""
+    return ((nbytes + 1) * 9 + 2) * 1e6 / baudrate
+
+
+def display_transactions(dirty_pages, chunked):
+    """Tamanhos das transações de um quadro com dirty_pages páginas alteradas por inteiro."""
+    if chunked:
+        return [WINDOW_HEADER + WIDTH] * dirty_pages
+    return [WINDOW_HEADER + WIDTH * dirty_pages]
+
+
+def periodic(rng, period_us, seconds):
+    """Instantes de um dispositivo periódico com fase aleatória e pequena variação de período."""
+    t = rng.uniform(0, period_us)
+    while t < seconds * 1e6:
+        yield t
+        t += period_us * rng.uniform(0.98, 1.02)
+
+
+def simulate(args, baudrate, chunked, rng):
+    """Executa um cenário e retorna as latências (submissão até o término) por classe e os quadros pulados."""
+    arrivals = []  # (instante, ordem, classe, bytes; None para um quadro do display)
+    order = 0
+    for t in periodic(rng, 1e6 / args.sensor_hz, args.seconds):
+        arrivals.append((t, order, 0, 1 + 6))
+        order += 1
+    for t in periodic(rng, 1e6 / 10, args.seconds):
+        arrivals.append((t, order, 1, 1 + 2))
+        order += 1
+    for t in periodic(rng, 1e6 / 50, args.seconds):
+        arrivals.append((t, order, 2, None))
+        order += 1
+    heapq.heapify(arrivals)
+
+    queues = [[] for _ in PRIORITIES]
+    latencies = [[] for _ in PRIORITIES]
+    skipped = 0
+    display_end = 0.0  # Término da última transação do quadro em andamento
+    now = 0.0
+    while arrivals or any(queues):
+        # Todas as transações submetidas até agora entram nas filas antes da escolha
+        while arrivals and arrivals[0][0] <= now:
+            t, _, prio, size = heapq.heappop(arrivals)
+            if size is not None:
+                queues[prio].append((t, size))
+            elif queues[prio] or t < display_end:
+                skipped += 1  # Como em render_present_oled: o quadro anterior ainda não terminou
+            else:
+                queues[prio].extend((t, n) for n in display_transactions(args.dirty_pages, chunked))
+        prio = next((p for p, q in enumerate(queues) if q), None)
+        if prio is None:
+            now = arrivals[0][0]  # Barramento ocioso até a próxima submissão
+            continue
+        queued, size = queues[prio].pop(0)
+        now += transaction_us(size, baudrate)
+        latencies[prio].append(now - queued)
+        if prio == 2 and not queues[prio]:
+            display_end = now
+    return latencies, skipped
+
+
+def histogram(values):
+    """Contagem por faixa: a faixa b contém atrasos em [2^b, 2^(b+1)) µs, como no firmware."""
+    bins = [0] * HIST_BINS
+    for v in values:
+        b = max(int(v), 1).bit_length() - 1
+        bins[min(b, HIST_BINS - 1)] += 1
+    return bins
+
+
+def percentile(values, p):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * p))]
+
+
+def report(name, latencies, skipped):
+    print(f"== {name} ({skipped} quadros do display pulados)")
+    for prio, values in enumerate(latencies):
+        if not values:
+            continue
+        print(f"  {PRIORITIES[prio]:8s} {len(values):6d} transações  "
+              f"p50 {percentile(values, 0.5):8.0f} µs  p99 {percentile(values, 0.99):8.0f} µs  "
+              f"max {max(values):8.0f} µs")
+        bins = histogram(values)
+        peak = max(bins)
+        for b, count in enumerate(bins):
+            if count:
+                bar = "#" * max(1, round(40 * count / peak))
+                print(f"    < {1 << (b + 1):6d} µs {count:7d} {bar}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--seconds", type=float, default=10, help="tempo simulado")
+    parser.add_argument("--seed", type=int, default=1, help="semente das fases e variações de período")
+    parser.add_argument("--dirty-pages", type=int, default=PAGES, help="páginas alteradas por quadro do display")
+    parser.add_argument("--sensor-hz", type=float, default=500, help="frequência das leituras urgentes")
+    args = parser.parse_args()
+
+    for baudrate in (400_000, 1_000_000):
+        for chunked in (False, True):
+            rng = random.Random(args.seed)
+            mode = "por página" if chunked else "quadro inteiro"
+            report(f"{baudrate // 1000} kHz, display {mode}", *simulate(args, baudrate, chunked, rng))
+
+
+if __name__ == "__main__":
+    main()
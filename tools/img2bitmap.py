@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""Converte uma imagem de 1 bit no bitmap_t desenhado por ssd1306_blit (veja inc/bitmap.h).
+
+Os pixels são reorganizados em colunas de 8 linhas (bit 0 no topo), página a página como nas fontes
+geradas por bdf2font.py, e comprimidos em RLE: um byte de controle abaixo de 0x80 precede controle + 1
+bytes literais, e um byte de controle a partir de 0x80 precede um byte repetido (controle - 0x80) + 2
+vezes. Fundos lisos e linhas horizontais viram poucas sequências longas. Se o RLE não reduzir o
+tamanho, o bitmap é gravado sem compressão.
+
+Imagens PBM (P1 ou P4) são lidas diretamente; PNG e outros formatos exigem o Pillow e são convertidas
+pelo limiar de luminância (pixels claros acesos, ou escuros com --invert).
+
+Uso: img2bitmap.py entrada.pbm saida.c --name bitmap_logo [--raw] [--threshold 128] [--invert]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+MAX_LITERAL = 128
+MAX_REPEAT = 129
+
+
+def read_pbm(data):
+    """Lê uma imagem PBM (P1 ou P4); retorna (largura, altura, linhas de 0/1), com 1 para pixel aceso."""
+    tokens = re.sub(rb"#[^\n]*", b"", data[:64]).split()
+    magic, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+    if magic == b"P1":
+        body = re.sub(rb"#[^\n]*", b"", data).split(None, 3)[3]
+        bits = [c - ord("0") for c in body if c in b"01"]  # Os dígitos podem vir sem separação
+        rows = [bits[y * width:(y + 1) * width] for y in range(height)]
+    else:
+        stride = (width + 7) // 8
+        raster = data[len(data) - stride * height:]
+        rows = [[(raster[y * stride + x // 8] >> (7 - x % 8)) & 1 for x in range(width)] for y in range(height)]
+    return width, height, rows
+
+
+def read_image(path, threshold, invert):
+    """Lê a imagem; retorna (largura, altura, linhas de 0/1)."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:2] in (b"P1", b"P4"):
+        width, height, rows = read_pbm(data)
+    else:
+        try:
+            from PIL import Image
+        except ImportError:
+            sys.exit(f"{path}: apenas PBM sem o Pillow (pip install pillow)")
+        image = Image.open(path).convert("L")
+        width, height = image.size
+        pixels = list(image.getdata())
+        rows = [[int(v >= threshold) for v in pixels[y * width:(y + 1) * width]] for y in range(height)]
+    if invert:
+        rows = [[1 - v for v in row] for row in rows]
+    return width, height, rows
+
+
+def to_pages(width, height, rows):
+    """Bytes página a página: em cada página, as colunas da esquerda para a direita."""
+    pages = (height + 7) // 8
+    out = bytearray()
+    for page in range(pages):
+        for x in range(width):
+            out.append(sum(1 << bit for bit in range(8) if page * 8 + bit < height and rows[page * 8 + bit][x]))
+    return bytes(out)
+
+
+def rle_encode(data):
+    """Codifica em sequências repetidas (2 a 129 bytes) e literais (1 a 128 bytes)."""
+    out = bytearray()
+    literal = bytearray()
+
+    def flush_literal():
+        if literal:
+            out.append(len(literal) - 1)
+            out.extend(literal)
+            literal.clear()
+
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < MAX_REPEAT and data[i + run] == data[i]:
+            run += 1
+        # Uma repetição de 2 bytes só compensa se não interromper uma sequência literal
+        if run >= 3 or (run == 2 and not literal):
+            flush_literal()
+            out += bytes((0x80 | (run - 2), data[i]))
+            i += run
+        else:
+            literal.append(data[i])
+            i += 1
+            if len(literal) == MAX_LITERAL:
+                flush_literal()
+    flush_literal()
+    return bytes(out)
+
+
+def rle_decode(data, size):
+    """Decodificação de referência (a mesma de bitmap_next em inc/ssd1306.c)."""
+    out = bytearray()
+    i = 0
+    while len(out) < size:
+        control = data[i]
+        if control & 0x80:
+            out += bytes((data[i + 1],)) * ((control & 0x7F) + 2)
+            i += 2
+        else:
+            out += data[i + 1:i + 2 + control]
+            i += control + 2
+    return bytes(out)
+
+
+def c_bitmap(name, width, height, pages, fmt, data):
+    """Declaração C do bitmap e dos seus dados."""
+    out = [f"static const uint8_t {name}_data[] = {{"]
+    for i in range(0, len(data), 16):
+        out.append("    " + ", ".join(f"0x{b:02x}" for b in data[i:i + 16]) + ",")
+    out.append("};\n")
+    out.append(f"const bitmap_t {name} = {{")
+    out.append(f"    .width = {width},")
+    out.append(f"    .height = {height},")
+    out.append(f"    .pages = {pages},")
+    out.append(f"    .format = {fmt},")
+    out.append(f"    .size = {len(data)},")
+    out.append(f"    .data = {name}_data,")
+    out.append("};\n")
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("image")
+    parser.add_argument("output")
+    parser.add_argument("--name", required=True, help="nome da variável bitmap_t gerada")
+    parser.add_argument("--raw", action="store_true", help="gera também <nome>_raw, sem compressão (para comparação)")
+    parser.add_argument("--threshold", type=int, default=128, help="luminância mínima de um pixel aceso (exceto PBM)")
+    parser.add_argument("--invert", action="store_true", help="inverte os pixels")
+    args = parser.parse_args()
+
+    width, height, rows = read_image(args.image, args.threshold, args.invert)
+    pages = (height + 7) // 8
+    if not 0 < width <= 255 or not 0 < height <= 255:
+        sys.exit(f"{args.image}: dimensões {width}x{height} fora do suportado (até 255x255)")
+
+    raw = to_pages(width, height, rows)
+    rle = rle_encode(raw)
+    assert rle_decode(rle, len(raw)) == raw
+    fmt, data = ("BITMAP_RLE", rle) if len(rle) < len(raw) else ("BITMAP_RAW", raw)
+    if len(data) > 0xFFFF:
+        sys.exit(f"{args.image}: dados do bitmap excedem 64 KiB")
+
+    source = os.path.basename(args.image)
+    out = [f"// Gerado por tools/img2bitmap.py a partir de {source}; não edite\n", '#include "bitmap.h"\n']
+    out += c_bitmap(args.name, width, height, pages, fmt, data)
+    if args.raw:
+        out += c_bitmap(args.name + "_raw", width, height, pages, "BITMAP_RAW", raw)
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write("\n".join(out))
+    print(f"{source}: {width}x{height}, {len(raw)} bytes -> {len(data)} bytes ({fmt}, {100 * len(data) / len(raw):.0f}%)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""Decodifica o rastreamento enviado pelo firmware (comando '#' no Serial Monitor).
+
+Lê a saída capturada da serial, extrai as linhas "#trace" geradas por trace_dump (inc/trace.c),
+associa os inícios e fins de cada intervalo por núcleo e imprime, por tipo de intervalo, a
+quantidade, o tempo total, a média, o mínimo e o máximo. Opcionalmente grava o rastreamento no
+formato Trace Event do Chrome, aberto em chrome://tracing ou no Perfetto (ui.perfetto.dev).
+
+Com --bounce, grava também as bordas dos botões (eventos button_edge) em um arquivo por GPIO, no
+formato reproduzido por test/debounce_replay.c; os tempos começam na primeira borda do botão.
+
+Os nomes dos eventos vêm da enumeração trace_id_t de inc/trace.h.
+
+Uso: trace_decode.py captura.txt [--json trace.json] [--bounce prefixo] [--header inc/trace.h]
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+DEFAULT_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "inc", "trace.h")
+EVENT_HEX = 16                     # 8 bytes por evento: tempo (8), id (2), fase (2), argumento (4)
+PHASES = ("B", "E", "i")           # trace_phase_t, com as letras do formato do Chrome
+
+
+def read_names(header):
+    """Lista os nomes de trace_id_t, na ordem da enumeração."""
+    with open(header, encoding="utf-8") as f:
+        text = f.read()
+    body = re.search(r"typedef enum\s*{([^}]*)}\s*trace_id_t;", text)
+    if not body:
+        sys.exit(f"{header}: enumeração trace_id_t não encontrada")
+    names = re.findall(r"^\s*TRACE_(\w+)\s*[,=]", body.group(1), re.M)
+    return [name.lower() for name in names]
+
+
+def parse(lines):
+    """Retorna, para cada rastreamento completo, ({núcleo: [(tempo, id, fase, arg)]}, [descartados por núcleo])."""
+    dumps = []
+    events, dropped = None, [0, 0]
+    for line in lines:
+        line = line.strip()
+        if not line.startswith("#trace "):
+            continue
+        fields = line.split()
+        if fields[1] == "begin":
+            events, dropped = {}, [0, 0]
+        elif events is None:
+            continue  # Captura iniciada no meio de um rastreamento
+        elif fields[1] == "end":
+            dumps.append((events, dropped))
+            events = None
+        elif fields[1] == "dropped":
+            dropped = [int(v) for v in fields[2:]]
+        else:
+            core, data = int(fields[1]), fields[2] if len(fields) > 2 else ""
+            for i in range(0, len(data) - EVENT_HEX + 1, EVENT_HEX):
+                chunk = data[i:i + EVENT_HEX]
+                events.setdefault(core, []).append(
+                    (int(chunk[0:8], 16), int(chunk[8:10], 16), int(chunk[10:12], 16), int(chunk[12:16], 16)))
+    return dumps
+
+
+def unwrap(events):
+    """Converte os tempos de 32 bits em tempos contínuos (o timer dá a volta a cada ~71 minutos)."""
+    offset, last, result = 0, None, []
+    for time, *rest in events:
+        if last is not None and time < last and last - time > 1 << 31:
+            offset += 1 << 32
+        last = time
+        result.append((time + offset, *rest))
+    return result
+
+
+def name_of(names, event_id):
+    return names[event_id] if event_id < len(names) else f"evento_{event_id}"
+
+
+def decode(dumps, names):
+    """Junta os rastreamentos, pareia os intervalos e retorna (eventos do Chrome, {(nome, núcleo): durações}, avisos)."""
+    chrome, spans = [], {}
+    unmatched = 0
+    for core in sorted({c for events, _ in dumps for c in events}):
+        chrome.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": core, "args": {"name": f"nucleo {core}"}})
+        stack = []
+        merged = [e for events, _ in dumps for e in events.get(core, [])]
+        for time, event_id, phase, arg in unwrap(merged):
+            name = name_of(names, event_id)
+            ph = PHASES[phase] if phase < len(PHASES) else "i"
+            record = {"name": name, "ph": ph, "ts": time, "pid": 0, "tid": core}
+            if ph == "i":
+                record["s"] = "t"
+                record["args"] = {"arg": arg}
+            chrome.append(record)
+
+            if ph == "B":
+                stack.append((event_id, time))
+            elif ph == "E":
+                # Intervalos aninhados terminam na ordem inversa; um fim sem início (fila cheia) é ignorado
+                while stack and stack[-1][0] != event_id:
+                    stack.pop()
+                    unmatched += 1
+                if not stack:
+                    unmatched += 1
+                    continue
+                _, begin = stack.pop()
+                spans.setdefault((name, core), []).append(time - begin)
+        unmatched += len(stack)
+    return chrome, spans, unmatched
+
+
+def export_bounce(dumps, names, prefix):
+    """Grava as bordas de cada botão em prefixo_gpio<N>.txt e retorna os arquivos gravados."""
+    edges = {}
+    for events, _ in dumps:
+        for time, event_id, phase, arg in unwrap(events.get(0, [])):  # Os botões são atendidos pelo núcleo 0
+            if name_of(names, event_id) == "button_edge":
+                edges.setdefault(arg >> 1, []).append((time, arg & 1))
+    paths = []
+    for gpio, gpio_edges in sorted(edges.items()):
+        path = f"{prefix}_gpio{gpio}.txt"
+        first = gpio_edges[0][0]
+        with open(path, "w", encoding="utf-8") as f:
+            f.write(f"# Bordas da GPIO {gpio} capturadas pelo rastreamento (trace_decode.py --bounce)\n")
+            f.write("# Acrescente as linhas \"expect <press|release|long> <tempo_us>\" conferidas\n")
+            for time, level in gpio_edges:
+                f.write(f"{time - first} {level}\n")
+        paths.append(path)
+    return paths
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("capture", nargs="?", help="saída capturada da serial (padrão: entrada padrão)")
+    parser.add_argument("--json", help="grava o rastreamento no formato Trace Event do Chrome")
+    parser.add_argument("--bounce", metavar="PREFIXO", help="grava as bordas dos botões em PREFIXO_gpio<N>.txt")
+    parser.add_argument("--header", default=DEFAULT_HEADER, help="inc/trace.h com a enumeração trace_id_t")
+    args = parser.parse_args()
+
+    names = read_names(args.header)
+    if args.capture:
+        with open(args.capture, encoding="utf-8", errors="replace") as f:
+            dumps = parse(f)
+    else:
+        dumps = parse(sys.stdin)
+    if not dumps:
+        sys.exit("nenhum rastreamento completo (#trace begin ... #trace end) encontrado")
+
+    chrome, spans, unmatched = decode(dumps, names)
+    total = sum(len(core_events) for events, _ in dumps for core_events in events.values())
+    dropped = dumps[-1][1] + [0, 0]  # O firmware acumula os descartes desde o último trace_reset
+    print(f"{len(dumps)} rastreamento(s), {total} eventos, descartados: nucleo 0 {dropped[0]}, nucleo 1 {dropped[1]}")
+    if unmatched:
+        print(f"{unmatched} inicio(s)/fim(ns) sem par (fila cheia ou rastreamento cortado)")
+
+    print(f"{'intervalo':18s} {'nucleo':>6s} {'qtd':>7s} {'total us':>10s} {'media us':>9s} {'min us':>7s} {'max us':>7s}")
+    for (name, core), durations in sorted(spans.items(), key=lambda item: -sum(item[1])):
+        print(f"{name:18s} {core:6d} {len(durations):7d} {sum(durations):10d} "
+              f"{sum(durations) / len(durations):9.1f} {min(durations):7d} {max(durations):7d}")
+
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump({"traceEvents": chrome, "displayTimeUnit": "ms"}, f)
+        print(f"Trace Event do Chrome gravado em {args.json}")
+
+    if args.bounce:
+        paths = export_bounce(dumps, names, args.bounce)
+        print(f"bordas dos botoes gravadas em {', '.join(paths)}" if paths else "nenhuma borda de botao no rastreamento")
+
+
+if __name__ == "__main__":
+    main()